@@ -105,11 +105,13 @@ void CSMTestCases::createCSM1BBenchmark()
     solver.setFixedIndex(1);
     cout << beam->getKMatrix()->toString() << endl;
     cout << beam->getMMatrix()->toString() << endl;
-    std::vector<double *> result = solver.getCalculatedStartSolution(&lastvector);
+    solver.getCalculatedStartSolution(&lastvector);
+    // every second degree of freedom is a deflection, the others are rotations
+    const LaConstVectorView deflections = solver.getDisplacement().sub(0, (degreeOfFreedom + 1) / 2, 2);
     std::cout << "CSM 1B - displacements:" << std::endl;
-    for (int u = 0; u < degreeOfFreedom; u += 2)
+    for (int u = 0; u < deflections.getDimension(); u++)
     {
-        cout << "u[" << u << "]:" << result[0][u] << endl;
+        cout << "u[" << 2 * u << "]:" << deflections[u] << endl;
     }
 }
 /*=====================================================*/
@@ -95,10 +95,12 @@ void CSMTestCases::createCSM2BBenchmark()
     TmcInitialValueSolver solver(knotenanzahl * 2, beam->getKMatrix(), beam->getMMatrix(), beam->getDMatrix(), dTstructure);
     solver.setFixedIndex(0);
     solver.setFixedIndex(1);
-    std::vector<double *> result = solver.getCalculatedStartSolution(&lastvector);
-    for (int u = 0; u < degreeOfFreedom; u += 2)
+    solver.getCalculatedStartSolution(&lastvector);
+    // every second degree of freedom is a deflection, the others are rotations
+    const LaConstVectorView deflections = solver.getDisplacement().sub(0, (degreeOfFreedom + 1) / 2, 2);
+    for (int u = 0; u < deflections.getDimension(); u++)
     {
-        cout << "u[" << u << "]:" << result[0][u] << endl;
+        cout << "u[" << 2 * u << "]:" << deflections[u] << endl;
     }
 }
 /*=====================================================*/
@@ -40,7 +40,9 @@
 
 #include <applications/csmBenchmark/CSMTestCases.h>
 
+#include <common/utilities/TmcAsyncResultWriter.h>
 #include <common/utilities/TmcFileOutputASCII.h>
+#include <common/utilities/TmcTrace.h>
 #include <numerics/structuralsolver/beam/TmcBeam.h>
 #include <numerics/structuralsolver/TmcInitialValueSolver.h>
 #include <numerics/algebra/LaVector.h>
@@ -53,6 +55,8 @@ void CSMTestCases::createCSM3BBenchmark(std::vector<std::tuple<double, double, d
     stringstream ss;
     ss << pathname << "DisplacementBeamCSM3B.txt";
     TmcFileOutputASCII auslenkungout(ss.str());
+    TmcResultFileSink auslenkungsink(&auslenkungout);
+    TmcAsyncResultWriter auslenkungwriter(&auslenkungsink);
     double dTstructure = 0.00125;
 
     int knotenanzahl = 26;
@@ -94,6 +98,15 @@ void CSMTestCases::createCSM3BBenchmark(std::vector<std::tuple<double, double, d
     TmcInitialValueSolver solver(knotenanzahl * 2, beam->getKMatrix(), beam->getMMatrix(), beam->getDMatrix(), dTstructure);
     solver.setFixedIndex(0);
     solver.setFixedIndex(1);
+
+    // tip of the beam
+    int tipIndex = beam->getDegreeOfFreedom() - 2;
+    TmcProbe tipDisplacement("tip displacement", tipIndex, TmcProbe::DISPLACEMENT);
+    tipDisplacement.setWriter(&auslenkungwriter, true);
+    int displacementProbe = solver.addProbe(tipDisplacement);
+    int velocityProbe = solver.addProbe(TmcProbe("tip velocity", tipIndex, TmcProbe::VELOCITY));
+    int accelerationProbe = solver.addProbe(TmcProbe("tip acceleration", tipIndex, TmcProbe::ACCELERATION));
+
     std::vector<double *> result = solver.getCalculatedStartSolution(&lastvector);
     std::cout<<"start solution calculated"<<std::endl;
     //for (int u = 0; u < degreeOfFreedom; u += 2)
@@ -101,10 +114,10 @@ void CSMTestCases::createCSM3BBenchmark(std::vector<std::tuple<double, double, d
     //    cout << "u[" << u << "]:" << result[0][u] << endl;
     //}
 
-    double actualT = 0.0;
-
     for (int timestep = 0; timestep <= 20000; timestep++)
     {
+        TMC_TRACE_SCOPE("time step", "csm3b");
+
         LaVector lastvector(beam->getDegreeOfFreedom());
         int elementanzahl = beam->getElementAnzahl();
         int knotenanzahl = beam->getKnotenAnzahl();
@@ -129,24 +142,19 @@ void CSMTestCases::createCSM3BBenchmark(std::vector<std::tuple<double, double, d
         lastvector.setValue(1, 0.0);
         // cout<<lastvector.toString()<<endl;
 
-        std::vector<double *> result = solver.getCalculatedNextTimeStepSolution(&lastvector, true);
-
-        double valueU = result[0][beam->getDegreeOfFreedom() - 2];
-        double valueV = result[1][beam->getDegreeOfFreedom() - 2];
-        double valueA = result[2][beam->getDegreeOfFreedom() - 2];
-        double valueJ = 0.0;
-        // cout<<"Displacement:"<<valueU<<endl;
-
-        // if(timestep>10000)
-        {
-            auslenkungout.writeDouble(actualT);
-            auslenkungout.writeDouble(valueU);
-            auslenkungout.writeLine();
-
-            data.push_back(std::make_tuple(actualT, valueU, valueV, valueA, valueJ));
-
-            actualT = actualT + dTstructure;
-        }
+        solver.getCalculatedNextTimeStepSolution(&lastvector, true);
+    }
+    solver.getProbes().finish();
+    auslenkungwriter.close();
+
+    TmcProbe &displacement = solver.getProbe(displacementProbe);
+    TmcProbe &velocity = solver.getProbe(velocityProbe);
+    TmcProbe &acceleration = solver.getProbe(accelerationProbe);
+    data.reserve(data.size() + displacement.getNumberOfRows());
+    for (int row = 0; row < displacement.getNumberOfRows(); row++)
+    {
+        data.push_back(std::make_tuple(displacement.getValue(row, 0), displacement.getValue(row, 1),
+                                       velocity.getValue(row, 1), acceleration.getValue(row, 1), 0.0));
     }
 }
 /*=====================================================*/
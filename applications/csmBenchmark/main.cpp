@@ -48,14 +48,38 @@
 #include <QMainWindow>
 
 #include <common/utilities/TmcException.h>
+#include <common/utilities/TmcSystem.h>
+#include <common/utilities/TmcTrace.h>
 #include <applications/csmBenchmark/CSMTestCases.h>
 
 #include <views/plot2d/TmcPlotWidget.h>
 
+// writes the trace, a failure is reported but doesn't stop the application
+static void writeTrace(const std::string &filename)
+{
+    try
+    {
+        const std::size_t events = TmcTrace::writeChromeTrace(filename);
+        std::cout << events << " trace events written to " << filename << std::endl;
+    }
+    catch (TmcException &e)
+    {
+        std::cout << "couldn't write the trace: " << e.toString() << std::endl;
+    }
+}
+
 int main(int argc, char **argv)
 {
     try
     {
+        // tracing on demand: TMC_TRACE=<file>, the trace can be opened with chrome://tracing or https://ui.perfetto.dev
+        const std::string traceFile = TmcSystem::getEnv("TMC_TRACE");
+        if (!traceFile.empty())
+        {
+            TmcTrace::setEnabled(true);
+            TmcTrace::setThreadName("main");
+        }
+
         std::cout << "**** CSM 1B *****\n";
         CSMTestCases::createCSM1BBenchmark();
         std::cout << "**** CSM 2B *****\n";
@@ -63,6 +87,8 @@ int main(int argc, char **argv)
         std::cout << "**** CSM 3B *****\n";
         std::vector<std::tuple<double, double, double, double, double>> data;
         CSMTestCases::createCSM3BBenchmark(data);
+        if (!traceFile.empty())
+            writeTrace(traceFile);
 
         QApplication app(argc, argv);
         app.setOrganizationName("TMC");
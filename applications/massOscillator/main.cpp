@@ -45,7 +45,10 @@
 #include <QApplication>
 #include <QMainWindow>
 
+#include <common/utilities/TmcException.h>
 #include <common/utilities/TmcFileOutputASCII.h>
+#include <common/utilities/TmcSystem.h>
+#include <common/utilities/TmcTrace.h>
 #include <numerics/algebra/LaVector.h>
 #include <numerics/algebra/LaScalar.h>
 #include <numerics/algebra/LaSquareMatrix.h>
@@ -54,6 +57,20 @@
 
 #include <views/plot2d/TmcPlotWidget.h>
 
+// writes the trace, a failure is reported but doesn't stop the application
+static void writeTrace(const std::string &filename)
+{
+    try
+    {
+        const std::size_t events = TmcTrace::writeChromeTrace(filename);
+        std::cout << events << " trace events written to " << filename << std::endl;
+    }
+    catch (TmcException &e)
+    {
+        std::cout << "couldn't write the trace: " << e.toString() << std::endl;
+    }
+}
+
 int main(int argc, char **argv)
 {
     try
@@ -61,6 +78,14 @@ int main(int argc, char **argv)
         std::cout << "/*===================================================*/" << std::endl;
         std::cout << "/*======           Mass Oscillator             ======*/" << std::endl;
         std::cout << "/*===================================================*/" << std::endl;
+        // tracing on demand: TMC_TRACE=<file>, the trace can be opened with chrome://tracing or https://ui.perfetto.dev
+        const std::string traceFile = TmcSystem::getEnv("TMC_TRACE");
+        if (!traceFile.empty())
+        {
+            TmcTrace::setEnabled(true);
+            TmcTrace::setThreadName("gui");
+        }
+
         QApplication app(argc, argv);
         app.setOrganizationName("TMC");
         app.setApplicationName("Plot");
@@ -75,7 +100,10 @@ int main(int argc, char **argv)
         mow->compute(true);
 
         mw.show();
-        return app.exec();
+        int exitCode = app.exec();
+        if (!traceFile.empty())
+            writeTrace(traceFile);
+        return exitCode;
     }
     catch (std::string &s)
     {
@@ -11,6 +11,11 @@ SET(COMMON_SOURCES
   ${SOURCE_ROOT}/common/utilities/TmcFileOutputASCII.cpp
   ${SOURCE_ROOT}/common/utilities/TmcStaticPathMap.cpp
   ${SOURCE_ROOT}/common/utilities/TmcLogger.cpp
+  ${SOURCE_ROOT}/common/utilities/TmcAsyncLogger.cpp
+  ${SOURCE_ROOT}/common/utilities/TmcTrace.cpp
+  ${SOURCE_ROOT}/common/utilities/TmcResultSink.cpp
+  ${SOURCE_ROOT}/common/utilities/TmcAsyncResultWriter.cpp
+  ${SOURCE_ROOT}/common/utilities/TmcColumnFile.cpp
   ${SOURCE_ROOT}/common/math/TmcMath.cpp
 )
 
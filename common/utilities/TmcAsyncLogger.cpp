@@ -0,0 +1,475 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    asynchronous logger - lock-free queue and background writer thread
+
+\*---------------------------------------------------------------------------*/
+
+#include "TmcAsyncLogger.h"
+#include <common/utilities/TmcMpscQueue.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+    struct LogRecord
+    {
+        LogLevel level;
+        bool raw; //< preformatted by TmcLogger, written as it is
+        int64_t timeStamp;
+        unsigned short length;
+        char text[TmcAsyncLog::MAX_MESSAGE_LENGTH];
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // staging buffer of a thread, further characters are discarded if it is full
+    class StagingBuffer : public std::streambuf
+    {
+    public:
+        StagingBuffer() { this->reset(); }
+        void reset() { this->setp(buffer, buffer + TmcAsyncLog::MAX_MESSAGE_LENGTH); }
+        const char *data() const { return this->pbase(); }
+        size_t length() const { return (size_t)(this->pptr() - this->pbase()); }
+
+    protected:
+        int_type overflow(int_type ch) { return traits_type::not_eof(ch); }
+
+    private:
+        char buffer[TmcAsyncLog::MAX_MESSAGE_LENGTH];
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    class Writer
+    {
+    public:
+        Writer()
+            : queue(NULL), stream(NULL), gcControl(false), capacity(8192), queueCapacity(0), running(false), stopRequested(false),
+              producers(0), policy(Output2AsyncStream::DROP), dropped(0), droppedTotal(0), requestedGeneration(0), writtenGeneration(0)
+        {
+        }
+        ~Writer()
+        {
+            this->stopThread();
+            if (this->gcControl)
+                delete this->stream.load();
+            delete this->queue.load();
+        }
+        /*==========================================================*/
+        void setStream(std::ostream *pStream, const bool &gc)
+        {
+            std::lock_guard<std::mutex> lock(this->controlMutex);
+            this->stopThread();
+            if (this->gcControl)
+                delete this->stream.load();
+            this->gcControl = gc;
+            this->stream.store(pStream);
+            if (pStream)
+                this->startThread();
+        }
+        /*==========================================================*/
+        void setCapacity(size_t entries)
+        {
+            std::lock_guard<std::mutex> lock(this->controlMutex);
+            this->capacity = entries;
+        }
+        /*==========================================================*/
+        void stop()
+        {
+            std::lock_guard<std::mutex> lock(this->controlMutex);
+            this->stopThread();
+        }
+        /*==========================================================*/
+        void flush()
+        {
+            if (!this->running.load())
+                return;
+            std::unique_lock<std::mutex> lock(this->flushMutex);
+            const uint64_t generation = ++this->requestedGeneration;
+            this->wakeup.notify_one();
+            this->flushed.wait(lock, [&] { return this->writtenGeneration >= generation || !this->running.load(); });
+        }
+        /*==========================================================*/
+        void push(const LogRecord &record)
+        {
+            // a running producer keeps the queue alive, startThread() replaces it only without producers
+            this->producers.fetch_add(1);
+            if (this->running.load())
+            {
+                TmcMpscQueue<LogRecord> *q = this->queue.load();
+                while (!q->push(record))
+                {
+                    // a stopped writer never empties the queue
+                    if (this->policy.load(std::memory_order_relaxed) == Output2AsyncStream::DROP || !this->running.load())
+                    {
+                        this->dropped.fetch_add(1, std::memory_order_relaxed);
+                        this->droppedTotal.fetch_add(1, std::memory_order_relaxed);
+                        break;
+                    }
+                    this->wakeup.notify_one();
+                    std::this_thread::yield();
+                }
+            }
+            else
+                this->droppedTotal.fetch_add(1, std::memory_order_relaxed); //< no writer
+            this->producers.fetch_sub(1);
+        }
+        /*==========================================================*/
+        bool hasStream() const { return this->running.load(std::memory_order_relaxed); }
+
+    private:
+        void startThread()
+        {
+            if (this->queueCapacity != this->capacity)
+            {
+                // the writer is stopped, producers which still hold the old queue leave push() soon
+                while (this->producers.load() > 0)
+                    std::this_thread::yield();
+                delete this->queue.exchange(new TmcMpscQueue<LogRecord>(this->capacity));
+                this->queueCapacity = this->capacity;
+            }
+            this->stopRequested.store(false);
+            this->running.store(true);
+            this->thread = std::thread(&Writer::run, this);
+        }
+        /*==========================================================*/
+        void stopThread()
+        {
+            if (!this->thread.joinable())
+                return;
+            // new entries are dropped from now on
+            this->running.store(false);
+            {
+                std::lock_guard<std::mutex> lock(this->flushMutex);
+                this->stopRequested.store(true);
+            }
+            this->wakeup.notify_one();
+            this->thread.join();
+            this->flushed.notify_all();
+
+            // entries of producers which have seen the running writer before it stopped
+            while (this->producers.load() > 0)
+                std::this_thread::yield();
+            std::string batch;
+            this->drain(*this->queue.load(), batch);
+            this->write(batch);
+        }
+        /*==========================================================*/
+        void run()
+        {
+            TmcMpscQueue<LogRecord> &q = *this->queue.load();
+            std::string batch;
+            batch.reserve(1 << 16);
+
+            for (;;)
+            {
+                uint64_t generation;
+                bool stopping;
+                {
+                    std::lock_guard<std::mutex> lock(this->flushMutex);
+                    generation = this->requestedGeneration;
+                    stopping = this->stopRequested.load();
+                }
+
+                this->drain(q, batch);
+                this->write(batch);
+
+                std::unique_lock<std::mutex> lock(this->flushMutex);
+                if (generation > this->writtenGeneration)
+                {
+                    this->writtenGeneration = generation;
+                    this->flushed.notify_all();
+                }
+                if (stopping)
+                    return;
+                if (this->requestedGeneration == generation && !this->stopRequested.load())
+                    this->wakeup.wait_for(lock, std::chrono::milliseconds(5));
+            }
+        }
+        /*==========================================================*/
+        // appends all entries of the queue and the number of dropped entries to batch
+        void drain(TmcMpscQueue<LogRecord> &q, std::string &batch)
+        {
+            LogRecord record;
+            // wait for producers which have reserved but not yet published a slot
+            while (q.size() > 0)
+            {
+                if (q.pop(record))
+                {
+                    this->append(batch, record);
+                    if (batch.size() > (1 << 16))
+                        this->write(batch);
+                }
+                else
+                    std::this_thread::yield();
+            }
+            const size_t droppedEntries = this->dropped.exchange(0);
+            if (droppedEntries > 0)
+            {
+                std::string text = "Output2AsyncStream - " + std::to_string(droppedEntries) + " log entries dropped (queue full)";
+                LogRecord warning;
+                warning.level = logWARNING;
+                warning.raw = false;
+                warning.timeStamp = Output2AsyncStream::now();
+                warning.length = (unsigned short)std::min(text.size(), (size_t)TmcAsyncLog::MAX_MESSAGE_LENGTH);
+                std::memcpy(warning.text, text.c_str(), warning.length);
+                this->append(batch, warning);
+            }
+        }
+        /*==========================================================*/
+        void write(std::string &batch)
+        {
+            if (batch.empty())
+                return;
+            std::ostream *pStream = this->stream.load();
+            if (pStream)
+            {
+                pStream->write(batch.data(), (std::streamsize)batch.size());
+                pStream->flush();
+            }
+            batch.clear();
+        }
+        /*==========================================================*/
+        void append(std::string &batch, const LogRecord &record)
+        {
+            if (!record.raw)
+            {
+                const time_t seconds = (time_t)(record.timeStamp / 1000000);
+                if (seconds != this->cachedSecond)
+                {
+                    tm r;
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(_WIN64) || defined(__WIN64__)
+                    localtime_s(&r, &seconds);
+#else
+                    localtime_r(&seconds, &r);
+#endif
+                    strftime(this->cachedTime, sizeof(this->cachedTime), "%X", &r);
+                    this->cachedSecond = seconds;
+                }
+                char header[64];
+                const int length = std::snprintf(header, sizeof(header), "%s.%03d %-8s: ", this->cachedTime, (int)((record.timeStamp % 1000000) / 1000),
+                                                 TmcLogger<Output2AsyncStream>::logLevelToString(record.level).c_str());
+                batch.append(header, (size_t)length);
+                if (record.level > logDEBUG)
+                    batch.append((size_t)(3 * (record.level - logDEBUG)), ' ');
+            }
+            batch.append(record.text, record.length);
+            if (!record.raw)
+                batch += '\n';
+        }
+
+    public:
+        std::atomic<TmcMpscQueue<LogRecord> *> queue;
+        std::atomic<std::ostream *> stream;
+        bool gcControl;
+        size_t capacity;      //< guarded by controlMutex
+        size_t queueCapacity; //< capacity of queue
+
+        std::atomic<bool> running;
+        std::atomic<bool> stopRequested;
+        std::atomic<int> producers; //< threads inside push()
+        std::atomic<int> policy;
+        std::atomic<size_t> dropped; //< not yet reported in the log
+        std::atomic<size_t> droppedTotal;
+
+    private:
+        std::mutex controlMutex;
+        std::thread thread;
+
+        std::mutex flushMutex;
+        std::condition_variable wakeup;
+        std::condition_variable flushed;
+        uint64_t requestedGeneration;
+        uint64_t writtenGeneration;
+
+        time_t cachedSecond = -1;
+        char cachedTime[16] = {0};
+    };
+
+    Writer &writer()
+    {
+        static Writer asyncWriter;
+        return asyncWriter;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// TmcAsyncLog
+//////////////////////////////////////////////////////////////////////////
+struct TmcAsyncLog::Staging
+{
+    Staging() : stream(&buffer), inUse(false) {}
+    StagingBuffer buffer;
+    std::ostream stream;
+    bool inUse; //< an entry of this thread is being formatted
+};
+
+/*==========================================================*/
+TmcAsyncLog::Staging &TmcAsyncLog::threadStaging()
+{
+    thread_local Staging staging;
+    return staging;
+}
+/*==========================================================*/
+TmcAsyncLog::TmcAsyncLog(const LogLevel &level)
+    : level(level), timeStamp(Output2AsyncStream::now()), staging(&TmcAsyncLog::threadStaging()), nested(false)
+{
+    if (this->staging->inUse)
+    {
+        // log call inside the log text of another entry, the buffer of the thread is busy
+        this->staging = new Staging;
+        this->nested = true;
+    }
+    this->staging->inUse = true;
+
+    Staging &s = *this->staging;
+    s.buffer.reset();
+    s.stream.clear();
+    s.stream.flags(std::ios_base::dec | std::ios_base::skipws);
+    s.stream.precision(6);
+    s.stream.width(0);
+    s.stream.fill(' ');
+}
+/*==========================================================*/
+TmcAsyncLog::~TmcAsyncLog()
+{
+    Staging &s = *this->staging;
+    Output2AsyncStream::push(this->level, this->timeStamp, s.buffer.data(), s.buffer.length());
+    s.inUse = false;
+    if (this->nested)
+        delete this->staging;
+}
+/*==========================================================*/
+std::ostream &TmcAsyncLog::get()
+{
+    return this->staging->stream;
+}
+/*==========================================================*/
+LogLevel &TmcAsyncLog::reportingLevel()
+{
+    static LogLevel reportLevel = logINFO;
+    return reportLevel;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Output2AsyncStream
+//////////////////////////////////////////////////////////////////////////
+void Output2AsyncStream::setStream(const std::string &filename)
+{
+    std::ofstream *file = new std::ofstream(filename.c_str());
+    if (!(*file))
+    {
+        delete file;
+        Output2AsyncStream::setStream(&std::cerr, false);
+        TmcAsyncLog(logERROR).get() << "Output2AsyncStream::setStream(const std::string& filename) could not open file "
+                                    << filename << " -> std::cerr is used instead";
+        return;
+    }
+    Output2AsyncStream::setStream(file, true);
+}
+/*==========================================================*/
+void Output2AsyncStream::setStream(std::ostream *pStream, const bool &gcControl)
+{
+    writer().setStream(pStream, gcControl);
+}
+/*==========================================================*/
+bool Output2AsyncStream::hasStream()
+{
+    return writer().hasStream();
+}
+/*==========================================================*/
+void Output2AsyncStream::setCapacity(const std::size_t &entries)
+{
+    writer().setCapacity(entries);
+}
+/*==========================================================*/
+void Output2AsyncStream::setOverflowPolicy(const OVERFLOWPOLICY &policy)
+{
+    writer().policy.store(policy);
+}
+/*==========================================================*/
+void Output2AsyncStream::stop()
+{
+    writer().stop();
+}
+/*==========================================================*/
+void Output2AsyncStream::flush()
+{
+    writer().flush();
+}
+/*==========================================================*/
+std::size_t Output2AsyncStream::getNumberOfDroppedEntries()
+{
+    return writer().droppedTotal.load();
+}
+/*==========================================================*/
+void Output2AsyncStream::output(const std::string &msg)
+{
+    LogRecord record;
+    record.level = logINFO;
+    record.raw = true;
+    record.timeStamp = 0;
+    record.length = (unsigned short)std::min(msg.size(), (size_t)TmcAsyncLog::MAX_MESSAGE_LENGTH);
+    std::memcpy(record.text, msg.c_str(), record.length);
+    // keep the line break of TmcLogger if the message was truncated
+    if (record.length < msg.size() && record.length > 0)
+        record.text[record.length - 1] = '\n';
+    writer().push(record);
+}
+/*==========================================================*/
+void Output2AsyncStream::push(const LogLevel &level, const int64_t &timeStamp, const char *text, const std::size_t &length)
+{
+    LogRecord record;
+    record.level = level;
+    record.raw = false;
+    record.timeStamp = timeStamp;
+    record.length = (unsigned short)std::min(length, (size_t)TmcAsyncLog::MAX_MESSAGE_LENGTH);
+    std::memcpy(record.text, text, record.length);
+    writer().push(record);
+}
+/*==========================================================*/
+int64_t Output2AsyncStream::now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,159 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    asynchronous logger - lock-free queue and background writer thread
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TMCASYNCLOGGER_H
+#define TMCASYNCLOGGER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include <TmcMacroFile.h>
+#include <common/utilities/TmcLogger.h>
+
+//////////////////////////////////////////////////////////////////////////
+// TmcAsyncLog
+// asynchronous counterpart of TmcLog
+// Functionality:
+// the log text is streamed into a staging buffer of the calling thread (no allocation, no lock).
+// A log entry which is created while the text of another one is formatted (e.g. by a function
+// called in the log text) gets its own buffer.
+// When the TmcAsyncLog object is destroyed, level, time stamp and text are pushed into a
+// lock-free TmcMpscQueue. A background thread (Output2AsyncStream) formats the time stamps and
+// the level strings and writes the entries in batches to the stream. The queue has a fixed
+// capacity, so the memory is bounded. If it is full, the entry is dropped (default, the number of
+// dropped entries is reported in the log) or the caller waits until the writer has made room.
+// Entries longer than TmcAsyncLog::MAX_MESSAGE_LENGTH characters are truncated.
+//
+// Help macro:  UBLOG_ASYNC
+// Example:     Output2AsyncStream::setStream("c:/temp/log.txt");
+//              UBLOG_ASYNC(logDEBUG, "time step " << step << " finished");
+//              Output2AsyncStream::stop(); //writes all pending entries
+//
+// while Output2AsyncStream has a stream, UBLOG, UBLOGML, UBLOG2 and UBLOG2ML write their entries
+// through TmcAsyncLog as well (filtered with TmcLog::reportingLevel())
+//
+// the filtering of UBLOG_ASYNC takes place before any formatting -> no costs for suppressed levels
+//////////////////////////////////////////////////////////////////////////
+class TMC_DLL_EXPORT TmcAsyncLog
+{
+public:
+    enum
+    {
+        MAX_MESSAGE_LENGTH = 232
+    };
+
+public:
+    explicit TmcAsyncLog(const LogLevel &level = logINFO);
+    ~TmcAsyncLog();
+
+    std::ostream &get();
+
+    static LogLevel &reportingLevel();
+    static void setReportingLevel(const LogLevel &level) { TmcAsyncLog::reportingLevel() = level; }
+
+private:
+    TmcAsyncLog(const TmcAsyncLog &);
+    TmcAsyncLog &operator=(const TmcAsyncLog &);
+
+    struct Staging;
+    static Staging &threadStaging();
+
+    LogLevel level;
+    int64_t timeStamp;
+    Staging *staging;
+    bool nested; //< staging is owned by this entry
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Output2AsyncStream (=implementation of OutputPolicy)
+// background writer of TmcAsyncLog, can also be used as policy of TmcLogger:
+// TmcLogger<Output2AsyncStream>().get(logINFO) << "text"; formats on the calling thread but
+// does not wait for the disk
+//////////////////////////////////////////////////////////////////////////
+class TMC_DLL_EXPORT Output2AsyncStream
+{
+public:
+    enum OVERFLOWPOLICY
+    {
+        DROP,
+        BLOCK
+    };
+
+public:
+    // creates output-file-stream (if file opening fails -> stream is set to std::cerr)
+    static void setStream(const std::string &filename);
+    // gcControl = true -> object will be deleted by Output2AsyncStream
+    static void setStream(std::ostream *pStream, const bool &gcControl = false);
+    static bool hasStream();
+
+    // capacity in log entries, takes effect with the next start of the writer
+    static void setCapacity(const std::size_t &entries);
+    static void setOverflowPolicy(const OVERFLOWPOLICY &policy);
+
+    // writes all pending entries and stops the writer thread
+    static void stop();
+    // blocks until all entries pushed so far are written
+    static void flush();
+
+    // entries dropped because the queue was full or no writer was running
+    static std::size_t getNumberOfDroppedEntries();
+
+    // OutputPolicy interface of TmcLogger
+    static void output(const std::string &msg);
+
+    // used by TmcAsyncLog
+    static void push(const LogLevel &level, const int64_t &timeStamp, const char *text, const std::size_t &length);
+    static int64_t now();
+};
+
+// Macro to limit maxLevel from compiler side
+#ifndef UBLOG_ASYNC_MAX_LEVEL
+#define UBLOG_ASYNC_MAX_LEVEL UBLOG_MAX_LEVEL
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// main macro for asynchronous logging
+//  example UBLOG_ASYNC(logINFO, "this is a log entry " << value);
+//////////////////////////////////////////////////////////////////////////
+#define UBLOG_ASYNC(level, logtext)                                                                                    \
+    if (level > UBLOG_ASYNC_MAX_LEVEL || level > TmcAsyncLog::reportingLevel() || !Output2AsyncStream::hasStream()) \
+        ;                                                                                                              \
+    else                                                                                                               \
+        TmcAsyncLog(level).get() << logtext;
+
+#endif // TMCASYNCLOGGER_H
@@ -0,0 +1,219 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    background writer for time histories
+
+\*---------------------------------------------------------------------------*/
+
+#include "TmcAsyncResultWriter.h"
+#include <common/utilities/TmcException.h>
+#include <common/utilities/TmcSystem.h>
+#include <common/utilities/TmcTrace.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+TmcAsyncResultWriter::TmcAsyncResultWriter(TmcResultSink *sink, const std::size_t &capacity, const OVERFLOWPOLICY &policy)
+    : sink(sink), buffer(capacity), policy(policy), written(0), dropped(0), stalls(0), failed(false),
+      stopRequested(false), requestedGeneration(0), writtenGeneration(0)
+{
+    if (!sink)
+        throw TmcException(UB_EXARGS, "no result sink");
+    this->thread = std::thread(&TmcAsyncResultWriter::run, this);
+}
+/*==========================================================*/
+TmcAsyncResultWriter::~TmcAsyncResultWriter()
+{
+    this->stopThread();
+}
+/*==========================================================*/
+bool TmcAsyncResultWriter::push(const TmcResultRecord &record)
+{
+    if (this->failed.load(std::memory_order_relaxed) || !this->thread.joinable())
+    {
+        this->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (!this->buffer.push(record))
+    {
+        if (this->policy == DROP)
+        {
+            this->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        this->stalls.fetch_add(1, std::memory_order_relaxed);
+        TMC_TRACE_SCOPE("wait for result writer", "io");
+        do
+        {
+            this->wakeup.notify_one();
+            std::this_thread::yield();
+            if (this->failed.load(std::memory_order_relaxed))
+            {
+                this->dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        } while (!this->buffer.push(record));
+    }
+    // the writer polls, it is only woken up early if the buffer fills up
+    if (this->buffer.size() > this->buffer.capacity() / 2)
+        this->wakeup.notify_one();
+    return true;
+}
+/*==========================================================*/
+bool TmcAsyncResultWriter::push(const double *values, const int &size)
+{
+    if (size < 0 || size > (int)TmcResultRecord::MAX_VALUES)
+        throw TmcException(UB_EXARGS, "a record holds 0 to " + TmcSystem::toString((int)TmcResultRecord::MAX_VALUES) + " values, not " + TmcSystem::toString(size));
+    TmcResultRecord record;
+    record.size = size;
+    std::memcpy(record.values, values, record.size * sizeof(double));
+    return this->push(record);
+}
+/*==========================================================*/
+bool TmcAsyncResultWriter::push(const double &value1, const double &value2)
+{
+    TmcResultRecord record;
+    record.values[0] = value1;
+    record.values[1] = value2;
+    record.size = 2;
+    return this->push(record);
+}
+/*==========================================================*/
+bool TmcAsyncResultWriter::push(const double &value1, const double &value2, const double &value3)
+{
+    TmcResultRecord record;
+    record.values[0] = value1;
+    record.values[1] = value2;
+    record.values[2] = value3;
+    record.size = 3;
+    return this->push(record);
+}
+/*==========================================================*/
+void TmcAsyncResultWriter::checkpoint()
+{
+    TMC_TRACE_SCOPE("result checkpoint", "io");
+    if (this->thread.joinable())
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        const uint64_t generation = ++this->requestedGeneration;
+        this->wakeup.notify_one();
+        this->flushed.wait(lock, [&] { return this->writtenGeneration >= generation; });
+    }
+    this->throwIfFailed();
+}
+/*==========================================================*/
+void TmcAsyncResultWriter::close()
+{
+    this->stopThread();
+    this->throwIfFailed();
+}
+/*==========================================================*/
+void TmcAsyncResultWriter::stopThread()
+{
+    if (!this->thread.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopRequested = true;
+    }
+    this->wakeup.notify_one();
+    this->thread.join();
+}
+/*==========================================================*/
+void TmcAsyncResultWriter::throwIfFailed()
+{
+    if (this->failed.load())
+        throw TmcException(UB_EXARGS, "result writer failed: " + this->error);
+}
+/*==========================================================*/
+void TmcAsyncResultWriter::run()
+{
+    TmcTrace::setThreadName("result writer");
+
+    std::vector<TmcResultRecord> batch(256);
+    for (;;)
+    {
+        uint64_t generation;
+        bool stopping;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            generation = this->requestedGeneration;
+            stopping = this->stopRequested;
+        }
+
+        std::size_t count;
+        while ((count = this->buffer.pop(&batch[0], batch.size())) > 0)
+        {
+            if (this->failed.load(std::memory_order_relaxed))
+                continue; //< discard, the producer must not wait for a broken sink
+            try
+            {
+                TMC_TRACE_SCOPE("write results", "io");
+                this->sink->writeRecords(&batch[0], count);
+                this->written.fetch_add(count, std::memory_order_relaxed);
+            }
+            catch (std::exception &e)
+            {
+                this->error = e.what();
+                this->failed.store(true);
+            }
+        }
+        if ((generation > this->writtenGeneration || stopping) && !this->failed.load())
+        {
+            try
+            {
+                this->sink->flush();
+            }
+            catch (std::exception &e)
+            {
+                this->error = e.what();
+                this->failed.store(true);
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+        if (generation > this->writtenGeneration)
+        {
+            this->writtenGeneration = generation;
+            this->flushed.notify_all();
+        }
+        if (stopping)
+            return;
+        if (this->requestedGeneration == generation && !this->stopRequested)
+            this->wakeup.wait_for(lock, std::chrono::milliseconds(10));
+    }
+}
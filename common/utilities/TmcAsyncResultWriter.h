@@ -0,0 +1,130 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    background writer for time histories
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TMCASYNCRESULTWRITER_H
+#define TMCASYNCRESULTWRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <common/utilities/TmcResultSink.h>
+#include <common/utilities/TmcRingBuffer.h>
+
+#include <TmcMacroFile.h>
+
+//////////////////////////////////////////////////////////////////////////
+// TmcAsyncResultWriter
+// writes time histories in the background, the solver loop does not wait for the disk
+// Functionality:
+// the producer (one thread, usually the time loop) pushes fixed size TmcResultRecords into a
+// TmcRingBuffer. A background thread takes them in batches and hands them to a TmcResultSink,
+// which formats and writes them. The ring buffer has a fixed capacity, so the memory stays
+// bounded for arbitrarily long runs. If the writer can not keep up and the buffer is full,
+// push() waits until there is room (BLOCK, default, no result is lost) or drops the record (DROP).
+// checkpoint() waits until all records pushed so far are written and the sink is flushed,
+// e.g. before a restart file is written. Errors of the sink are rethrown by checkpoint() and close().
+//
+// Example:     TmcFileOutputASCII out("c:/temp/displacement.txt");
+//              TmcResultFileSink sink(&out);
+//              TmcAsyncResultWriter writer(&sink);
+//              for (...) writer.push(time, u);
+//              writer.close();
+//////////////////////////////////////////////////////////////////////////
+class TMC_DLL_EXPORT TmcAsyncResultWriter
+{
+public:
+    enum OVERFLOWPOLICY
+    {
+        BLOCK,
+        DROP
+    };
+
+public:
+    // the sink is not deleted by the writer and has to live until close()
+    TmcAsyncResultWriter(TmcResultSink *sink, const std::size_t &capacity = 16384, const OVERFLOWPOLICY &policy = BLOCK);
+    // closes the writer, errors are ignored -> call close() to get them
+    ~TmcAsyncResultWriter();
+
+    // return false if the record was dropped
+    bool push(const TmcResultRecord &record);
+    // throws TmcException if size is not in [0, TmcResultRecord::MAX_VALUES]
+    bool push(const double *values, const int &size);
+    bool push(const double &value1, const double &value2);
+    bool push(const double &value1, const double &value2, const double &value3);
+
+    // blocks until all records pushed so far are written and flushed
+    void checkpoint();
+    // writes all pending records and stops the background thread
+    void close();
+
+    std::size_t getNumberOfWrittenRecords() const { return this->written.load(); }
+    std::size_t getNumberOfDroppedRecords() const { return this->dropped.load(); }
+    // number of pushes which had to wait for the writer (BLOCK), a hint to increase the capacity
+    std::size_t getNumberOfStalls() const { return this->stalls.load(); }
+
+private:
+    TmcAsyncResultWriter(const TmcAsyncResultWriter &);
+    TmcAsyncResultWriter &operator=(const TmcAsyncResultWriter &);
+
+    void run();
+    void stopThread();
+    void throwIfFailed();
+
+    TmcResultSink *sink;
+    TmcRingBuffer<TmcResultRecord> buffer;
+    OVERFLOWPOLICY policy;
+
+    std::atomic<std::size_t> written;
+    std::atomic<std::size_t> dropped;
+    std::atomic<std::size_t> stalls;
+    std::atomic<bool> failed;
+    std::string error;
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable flushed;
+    bool stopRequested;
+    uint64_t requestedGeneration;
+    uint64_t writtenGeneration;
+};
+
+#endif // TMCASYNCRESULTWRITER_H
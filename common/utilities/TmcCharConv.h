@@ -0,0 +1,191 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    locale independent number parsing and formatting
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TMCCHARCONV_H
+#define TMCCHARCONV_H
+
+#include <clocale>
+#include <cstdint>
+#include <cstdio>
+#include <locale>
+#include <sstream>
+#include <string>
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <charconv>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// TmcCharConv
+// locale independent conversion between doubles and text
+// Functionality:
+// parseDouble/formatDouble work on plain character buffers, without streams and without
+// allocation. With a C++17 library std::from_chars/std::to_chars are used. Otherwise
+// parseDouble takes the exact fast path of Clinger (at most 19 digits and a power of ten up to
+// 10^22, which covers nearly all values in our input files) and falls back to a classic locale
+// stream for the rest, formatDouble uses snprintf and corrects the decimal point of the C locale
+// (Qt sets the locale of the environment).
+//
+// formatDouble writes the same text as std::ostream << value with the given precision and the
+// default float field ("%.*g").
+//////////////////////////////////////////////////////////////////////////
+namespace TmcCharConv
+{
+    // parses a double at the beginning of [first, last), end is set behind the last used character
+    // returns false (and value unchanged) if no number was found
+    inline bool parseDouble(const char *first, const char *last, double &value, const char *&end)
+    {
+#if defined(__cpp_lib_to_chars)
+        const char *begin = (first != last && *first == '+') ? first + 1 : first;
+        std::from_chars_result result = std::from_chars(begin, last, value);
+        end = result.ptr;
+        return result.ec == std::errc();
+#else
+        static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+        const char *p = first;
+        bool negative = false;
+        if (p != last && (*p == '+' || *p == '-'))
+            negative = (*p++ == '-');
+
+        uint64_t mantissa = 0;
+        int digits = 0;       //< significant digits
+        int exponent = 0;     //< decimal exponent of the mantissa
+        bool anyDigit = false;
+        bool exact = true;
+        for (; p != last && *p >= '0' && *p <= '9'; p++)
+        {
+            anyDigit = true;
+            if (mantissa == 0 && *p == '0')
+                continue;
+            if (digits < 19)
+            {
+                mantissa = 10 * mantissa + (uint64_t)(*p - '0');
+                digits++;
+            }
+            else
+            {
+                exponent++;
+                exact = exact && *p == '0';
+            }
+        }
+        if (p != last && *p == '.')
+        {
+            for (p++; p != last && *p >= '0' && *p <= '9'; p++)
+            {
+                anyDigit = true;
+                if (digits < 19)
+                {
+                    if (mantissa != 0 || *p != '0')
+                    {
+                        mantissa = 10 * mantissa + (uint64_t)(*p - '0');
+                        digits++;
+                    }
+                    exponent--;
+                }
+                else
+                    exact = exact && *p == '0';
+            }
+        }
+        if (!anyDigit)
+            return false;
+
+        if (p != last && (*p == 'e' || *p == 'E'))
+        {
+            const char *q = p + 1;
+            bool negativeExponent = false;
+            if (q != last && (*q == '+' || *q == '-'))
+                negativeExponent = (*q++ == '-');
+            if (q != last && *q >= '0' && *q <= '9')
+            {
+                int e = 0;
+                for (; q != last && *q >= '0' && *q <= '9'; q++)
+                    if (e < 100000)
+                        e = 10 * e + (*q - '0');
+                exponent += negativeExponent ? -e : e;
+                p = q;
+            }
+        }
+        end = p;
+
+        if (mantissa == 0)
+        {
+            value = negative ? -0.0 : 0.0;
+            return true;
+        }
+        if (exact && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+        {
+            double result = (double)mantissa;
+            result = exponent < 0 ? result / powers[-exponent] : result * powers[exponent];
+            value = negative ? -result : result;
+            return true;
+        }
+
+        std::istringstream stream(std::string(first, end));
+        stream.imbue(std::locale::classic());
+        double result;
+        stream >> result;
+        if (stream.fail())
+            return false;
+        value = result;
+        return true;
+#endif
+    }
+    /*==========================================================*/
+    // writes value with precision significant digits into buffer (not null terminated)
+    // returns the number of characters
+    inline int formatDouble(char *buffer, const int &size, const double &value, const int &precision)
+    {
+#if defined(__cpp_lib_to_chars)
+        std::to_chars_result result = std::to_chars(buffer, buffer + size, value, std::chars_format::general, precision > 0 ? precision : 1);
+        return result.ec == std::errc() ? (int)(result.ptr - buffer) : 0;
+#else
+        int length = std::snprintf(buffer, (size_t)size, "%.*g", precision, value);
+        if (length < 0 || length >= size)
+            return 0;
+        const char point = *std::localeconv()->decimal_point;
+        if (point != '.')
+            for (int i = 0; i < length; i++)
+                if (buffer[i] == point)
+                    buffer[i] = '.';
+        return length;
+#endif
+    }
+}
+
+#endif // TMCCHARCONV_H
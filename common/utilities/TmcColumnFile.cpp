@@ -0,0 +1,782 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    compressed column oriented file for time histories
+
+\*---------------------------------------------------------------------------*/
+
+#include "TmcColumnFile.h"
+#include <common/utilities/TmcException.h>
+#include <common/utilities/TmcSystem.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+namespace
+{
+    const char COLUMNFILE_MAGIC[8] = {'T', 'M', 'C', 'C', 'O', 'L', 'S', '\0'};
+    const char COLUMNFILE_ENDMAGIC[8] = {'T', 'M', 'C', 'C', 'O', 'L', 'E', '\0'};
+    const uint32_t COLUMNFILE_VERSION = 2; //< 2: codec SMOOTH
+
+    inline uint64_t toBits(const double &value)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    inline double toDouble(const uint64_t &bits)
+    {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    inline int leadingZeros(uint64_t value)
+    {
+        int n = 0;
+        for (uint64_t mask = uint64_t(1) << 63; mask && !(value & mask); mask >>= 1)
+            n++;
+        return n;
+    }
+    inline int trailingZeros(uint64_t value)
+    {
+        int n = 0;
+        for (; n < 64 && !(value & 1); value >>= 1)
+            n++;
+        return n;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // little endian integers, independent of the byte order of the machine
+    void putInteger(std::vector<unsigned char> &bytes, uint64_t value, const int &size)
+    {
+        for (int i = 0; i < size; i++, value >>= 8)
+            bytes.push_back((unsigned char)(value & 0xff));
+    }
+    uint64_t getInteger(const unsigned char *bytes, const int &size)
+    {
+        uint64_t value = 0;
+        for (int i = size - 1; i >= 0; i--)
+            value = (value << 8) | bytes[i];
+        return value;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    class BitWriter
+    {
+    public:
+        BitWriter(std::vector<unsigned char> &bytes) : bytes(bytes), used(8) {}
+        // writes the lowest bits of value, most significant first
+        void write(const uint64_t &value, int bits)
+        {
+            while (bits > 0)
+            {
+                if (this->used == 8)
+                {
+                    this->bytes.push_back(0);
+                    this->used = 0;
+                }
+                const int take = std::min(8 - this->used, bits);
+                const unsigned char part = (unsigned char)((value >> (bits - take)) & ((1u << take) - 1));
+                this->bytes.back() |= (unsigned char)(part << (8 - this->used - take));
+                this->used += take;
+                bits -= take;
+            }
+        }
+
+    private:
+        std::vector<unsigned char> &bytes;
+        int used; //< bits used in the last byte
+    };
+
+    class BitReader
+    {
+    public:
+        BitReader(const unsigned char *bytes, const std::size_t &size) : bytes(bytes), size(size), position(0) {}
+        uint64_t read(int bits)
+        {
+            uint64_t value = 0;
+            while (bits > 0)
+            {
+                const std::size_t byte = this->position >> 3;
+                if (byte >= this->size)
+                    throw TmcException(UB_EXARGS, "corrupt column block");
+                const int offset = (int)(this->position & 7);
+                const int take = std::min(8 - offset, bits);
+                const unsigned part = (this->bytes[byte] >> (8 - offset - take)) & ((1u << take) - 1);
+                value = (value << take) | part;
+                this->position += take;
+                bits -= take;
+            }
+            return value;
+        }
+
+    private:
+        const unsigned char *bytes;
+        std::size_t size;
+        std::size_t position; //< in bits
+    };
+
+    inline int bitWidth(uint64_t value)
+    {
+        int n = 0;
+        for (int shift = 32; shift > 0; shift >>= 1)
+            if (value >> shift)
+            {
+                value >>= shift;
+                n += shift;
+            }
+        return n + (int)value;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // SMOOTH: the bit pattern without the dropped mantissa bits is mapped to an integer which
+    // grows with the value (negative values -> complement of the magnitude, -0 -> -1)
+    const uint64_t SIGN_BIT = uint64_t(1) << 63;
+    const int MAX_SMOOTH_ORDER = 4;
+
+    inline uint64_t toOrdered(const uint64_t &bits, const int &dropped)
+    {
+        const uint64_t magnitude = (bits & ~SIGN_BIT) >> dropped;
+        return (bits & SIGN_BIT) ? ~magnitude : magnitude;
+    }
+    inline uint64_t fromOrdered(const uint64_t &ordered, const int &dropped)
+    {
+        if (ordered & SIGN_BIT)
+            return SIGN_BIT | (~ordered << dropped);
+        return ordered << dropped;
+    }
+    // the last values of a column and their extrapolation of order 1..4, unsigned arithmetic
+    // (wraps, the decoder wraps back)
+    class Extrapolation
+    {
+    public:
+        Extrapolation() : count(0) { std::fill(this->history, this->history + MAX_SMOOTH_ORDER, uint64_t(0)); }
+        uint64_t predict(int order) const
+        {
+            const uint64_t *h = this->history;
+            switch (std::min(order, this->count))
+            {
+                case 0:
+                    return 0;
+                case 1:
+                    return h[0];
+                case 2:
+                    return 2 * h[0] - h[1];
+                case 3:
+                    return 3 * h[0] - 3 * h[1] + h[2];
+                default:
+                    return 4 * h[0] - 6 * h[1] + 4 * h[2] - h[3];
+            }
+        }
+        void push(const uint64_t &value)
+        {
+            for (int k = MAX_SMOOTH_ORDER - 1; k > 0; k--)
+                this->history[k] = this->history[k - 1];
+            this->history[0] = value;
+            this->count = std::min(this->count + 1, MAX_SMOOTH_ORDER);
+        }
+
+    private:
+        uint64_t history[MAX_SMOOTH_ORDER]; //< newest first
+        int count;
+    };
+    inline uint64_t zigzag(const uint64_t &residual) { return (residual << 1) ^ (0 - (residual >> 63)); }
+    inline uint64_t unzigzag(const uint64_t &value) { return (value >> 1) ^ (0 - (value & 1)); }
+
+    // rounds the mantissa to 52 - dropped bits, infinity is kept, NaN becomes a quiet NaN
+    // (subnormal numbers keep fewer significant bits)
+    inline uint64_t roundMantissa(const uint64_t &bits, const int &dropped)
+    {
+        if (dropped == 0)
+            return bits;
+        const uint64_t exponentMask = uint64_t(0x7ff) << 52;
+        if ((bits & exponentMask) == exponentMask)
+            return (bits & ~exponentMask & ~SIGN_BIT) == 0 ? bits : (bits | exponentMask | (uint64_t(1) << 51)) >> dropped << dropped;
+        // a carry increments the exponent, the largest doubles are truncated (no infinity)
+        uint64_t rounded = (bits & ~SIGN_BIT) + (uint64_t(1) << (dropped - 1));
+        if (rounded >= exponentMask)
+            rounded = bits & ~SIGN_BIT;
+        return (bits & SIGN_BIT) | (rounded >> dropped << dropped);
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // block: order - 1 (2 bits) and dropped mantissa bits (6 bits) in the first byte, the first
+    // value, then the zigzag coded residuals of the extrapolation in the window scheme of XOR
+    void encodeSmooth(const double *values, const std::size_t &count, const int &dropped, std::vector<unsigned char> &block)
+    {
+        // the order with the smallest residuals of this block
+        uint64_t widths[MAX_SMOOTH_ORDER] = {0};
+        Extrapolation extrapolation;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const uint64_t ordered = toOrdered(roundMantissa(toBits(values[i]), dropped), dropped);
+            for (int order = 1; order <= MAX_SMOOTH_ORDER; order++)
+                widths[order - 1] += (uint64_t)bitWidth(zigzag(ordered - extrapolation.predict(order)));
+            extrapolation.push(ordered);
+        }
+        const int order = (int)(std::min_element(widths, widths + MAX_SMOOTH_ORDER) - widths) + 1;
+
+        block.push_back((unsigned char)((order - 1) | (dropped << 2)));
+        BitWriter writer(block);
+        extrapolation = Extrapolation();
+        int window = 0;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const uint64_t ordered = toOrdered(roundMantissa(toBits(values[i]), dropped), dropped);
+            if (i == 0)
+                writer.write(ordered, 64);
+            else
+            {
+                const uint64_t residual = zigzag(ordered - extrapolation.predict(order));
+                const int width = bitWidth(residual);
+                if (residual == 0)
+                    writer.write(0, 1);
+                else if (width <= window && window - width <= 6)
+                {
+                    // fits into the width of the previous stored residual
+                    writer.write(2, 2);
+                    writer.write(residual, window);
+                }
+                else
+                {
+                    writer.write(3, 2);
+                    writer.write((uint64_t)(width & 63), 6); //< 64 is stored as 0
+                    writer.write(residual, width);
+                    window = width;
+                }
+            }
+            extrapolation.push(ordered);
+        }
+    }
+    /*==========================================================*/
+    void decodeSmooth(const unsigned char *block, const std::size_t &bytes, double *values, const std::size_t &count)
+    {
+        if (count == 0)
+            return;
+        if (bytes < 1 || (block[0] >> 2) > 51)
+            throw TmcException(UB_EXARGS, "corrupt column block");
+        const int order = (block[0] & 3) + 1;
+        const int dropped = block[0] >> 2;
+
+        BitReader reader(block + 1, bytes - 1);
+        Extrapolation extrapolation;
+        int window = 0;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            uint64_t ordered;
+            if (i == 0)
+                ordered = reader.read(64);
+            else
+            {
+                uint64_t residual = 0;
+                if (reader.read(1) == 1)
+                {
+                    if (reader.read(1) == 1)
+                    {
+                        window = (int)reader.read(6);
+                        if (window == 0)
+                            window = 64;
+                    }
+                    else if (window == 0)
+                        throw TmcException(UB_EXARGS, "corrupt column block");
+                    residual = reader.read(window);
+                }
+                ordered = unzigzag(residual) + extrapolation.predict(order);
+            }
+            values[i] = toDouble(fromOrdered(ordered, dropped));
+            extrapolation.push(ordered);
+        }
+    }
+
+    // prediction of the bit pattern of value i, integer arithmetic -> identical on every machine
+    inline uint64_t predict(const TmcColumnFile::CODEC &codec, const uint64_t &previous, const uint64_t &beforePrevious, const std::size_t &i)
+    {
+        if (codec == TmcColumnFile::DELTA && i >= 2)
+            return 2 * previous - beforePrevious;
+        return previous;
+    }
+}
+
+/*==========================================================*/
+void TmcColumnFile::encode(CODEC codec, const double *values, const std::size_t &count, std::vector<unsigned char> &block, const int &mantissaBits)
+{
+    if (mantissaBits < 1 || mantissaBits > 52)
+        throw TmcException(UB_EXARGS, "a double has 1 to 52 mantissa bits, not " + TmcSystem::toString(mantissaBits));
+    const int dropped = 52 - mantissaBits;
+
+    block.clear();
+    if (codec == SMOOTH)
+    {
+        encodeSmooth(values, count, dropped, block);
+        return;
+    }
+    BitWriter writer(block);
+    if (codec == RAW)
+    {
+        for (std::size_t i = 0; i < count; i++)
+            putInteger(block, roundMantissa(toBits(values[i]), dropped), 8);
+        return;
+    }
+
+    uint64_t previous = 0, beforePrevious = 0;
+    int windowLeading = -1, windowTrailing = 0;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const uint64_t bits = roundMantissa(toBits(values[i]), dropped);
+        if (i == 0)
+            writer.write(bits, 64);
+        else
+        {
+            const uint64_t residual = bits ^ predict(codec, previous, beforePrevious, i);
+            if (residual == 0)
+                writer.write(0, 1);
+            else
+            {
+                const int leading = std::min(leadingZeros(residual), 31);
+                const int trailing = trailingZeros(residual);
+                if (windowLeading >= 0 && leading >= windowLeading && trailing >= windowTrailing)
+                {
+                    // fits into the previous window of meaningful bits
+                    writer.write(2, 2);
+                    writer.write(residual >> windowTrailing, 64 - windowLeading - windowTrailing);
+                }
+                else
+                {
+                    const int meaningful = 64 - leading - trailing;
+                    writer.write(3, 2);
+                    writer.write((uint64_t)leading, 5);
+                    writer.write((uint64_t)(meaningful & 63), 6); //< 64 is stored as 0
+                    writer.write(residual >> trailing, meaningful);
+                    windowLeading = leading;
+                    windowTrailing = trailing;
+                }
+            }
+        }
+        beforePrevious = previous;
+        previous = bits;
+    }
+}
+/*==========================================================*/
+void TmcColumnFile::decode(CODEC codec, const unsigned char *block, const std::size_t &bytes, double *values, const std::size_t &count)
+{
+    if (codec == SMOOTH)
+    {
+        decodeSmooth(block, bytes, values, count);
+        return;
+    }
+    if (codec == RAW)
+    {
+        if (bytes < count * 8)
+            throw TmcException(UB_EXARGS, "corrupt column block");
+        for (std::size_t i = 0; i < count; i++)
+            values[i] = toDouble(getInteger(block + 8 * i, 8));
+        return;
+    }
+
+    BitReader reader(block, bytes);
+    uint64_t previous = 0, beforePrevious = 0;
+    int windowLeading = 0, windowTrailing = 0;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        uint64_t bits;
+        if (i == 0)
+            bits = reader.read(64);
+        else
+        {
+            uint64_t residual = 0;
+            if (reader.read(1) == 1)
+            {
+                if (reader.read(1) == 1)
+                {
+                    windowLeading = (int)reader.read(5);
+                    int meaningful = (int)reader.read(6);
+                    if (meaningful == 0)
+                        meaningful = 64;
+                    windowTrailing = 64 - windowLeading - meaningful;
+                    if (windowTrailing < 0)
+                        throw TmcException(UB_EXARGS, "corrupt column block");
+                }
+                residual = reader.read(64 - windowLeading - windowTrailing) << windowTrailing;
+            }
+            bits = residual ^ predict(codec, previous, beforePrevious, i);
+        }
+        values[i] = toDouble(bits);
+        beforePrevious = previous;
+        previous = bits;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// TmcColumnFileWriter
+//////////////////////////////////////////////////////////////////////////
+TmcColumnFileWriter::TmcColumnFileWriter(const std::string &filename, const std::vector<std::string> &columnNames, const int &chunkRows)
+    : filename(filename), columnNames(columnNames), chunkRows((std::size_t)std::max(chunkRows, 1)), headerWritten(false), rows(0), position(0)
+{
+    if (columnNames.empty())
+        throw TmcException(UB_EXARGS, "no columns");
+
+    this->codecs.resize(columnNames.size(), TmcColumnFile::SMOOTH);
+    this->mantissaBits.resize(columnNames.size(), 52);
+    this->columns.resize(columnNames.size());
+    for (size_t c = 0; c < this->columns.size(); c++)
+        this->columns[c].reserve(this->chunkRows);
+
+    this->file.open(filename.c_str(), ios::out | ios::binary);
+    if (!this->file)
+    {
+        this->file.clear();
+        string path = TmcSystem::getPathFromString(filename);
+        if (path.size() > 0)
+        {
+            TmcSystem::makeDirectory(path);
+            this->file.open(filename.c_str(), ios::out | ios::binary);
+        }
+    }
+    if (!this->file)
+        throw TmcException(UB_EXARGS, "couldn't open file:\n " + filename);
+}
+/*==========================================================*/
+TmcColumnFileWriter::~TmcColumnFileWriter()
+{
+    try
+    {
+        this->close();
+    }
+    catch (...)
+    {
+    }
+}
+/*==========================================================*/
+void TmcColumnFileWriter::setCodec(const int &column, const TmcColumnFile::CODEC &codec)
+{
+    if (this->headerWritten)
+        throw TmcException(UB_EXARGS, "codecs have to be set before the first row");
+    this->codecs.at(column) = codec;
+}
+/*==========================================================*/
+void TmcColumnFileWriter::setPrecision(const int &column, const int &digits)
+{
+    if (digits < 1)
+        throw TmcException(UB_EXARGS, "precision of " + TmcSystem::toString(digits) + " digits");
+    // 16 digits need more bits than a double has -> lossless
+    this->mantissaBits.at(column) = std::min((int)std::ceil(digits * std::log2(10.0)), 52);
+}
+/*==========================================================*/
+void TmcColumnFileWriter::writeRow(const double *values)
+{
+    if (!this->file.is_open())
+        throw TmcException(UB_EXARGS, this->filename + " is closed");
+    if (!this->headerWritten)
+        this->writeHeader();
+
+    for (size_t c = 0; c < this->columns.size(); c++)
+        this->columns[c].push_back(values[c]);
+    this->rows++;
+    if (this->columns[0].size() >= this->chunkRows)
+        this->writeChunk();
+}
+/*==========================================================*/
+void TmcColumnFileWriter::writeRecords(const TmcResultRecord *records, const std::size_t &count)
+{
+    std::vector<double> row(this->columns.size());
+    for (size_t r = 0; r < count; r++)
+    {
+        for (size_t c = 0; c < row.size(); c++)
+            row[c] = (int)c < records[r].size ? records[r].values[c] : std::numeric_limits<double>::quiet_NaN();
+        this->writeRow(&row[0]);
+    }
+}
+/*==========================================================*/
+void TmcColumnFileWriter::flush()
+{
+    if (!this->file.is_open())
+        return;
+    if (!this->headerWritten)
+        this->writeHeader();
+    this->writeChunk();
+
+    // provisional footer, the next chunk (or the final footer) overwrites it
+    const uint64_t footerPosition = this->position;
+    this->writeFooter();
+    this->file.flush();
+    this->file.seekp((std::streamoff)footerPosition, ios::beg);
+    if (!this->file)
+        throw TmcException(UB_EXARGS, "error while writing " + this->filename);
+    this->position = footerPosition;
+}
+/*==========================================================*/
+void TmcColumnFileWriter::close()
+{
+    if (!this->file.is_open())
+        return;
+    if (!this->headerWritten)
+        this->writeHeader();
+    this->writeChunk();
+
+    this->writeFooter();
+
+    this->file.close();
+    if (!this->file)
+        throw TmcException(UB_EXARGS, "error while writing " + this->filename);
+}
+/*==========================================================*/
+void TmcColumnFileWriter::writeHeader()
+{
+    std::vector<unsigned char> header(COLUMNFILE_MAGIC, COLUMNFILE_MAGIC + 8);
+    putInteger(header, COLUMNFILE_VERSION, 4);
+    putInteger(header, this->columnNames.size(), 4);
+    putInteger(header, this->chunkRows, 4);
+    for (size_t c = 0; c < this->columnNames.size(); c++)
+    {
+        putInteger(header, (uint64_t)this->codecs[c], 1);
+        putInteger(header, this->columnNames[c].size(), 2);
+        header.insert(header.end(), this->columnNames[c].begin(), this->columnNames[c].end());
+    }
+    this->write(&header[0], header.size());
+    this->headerWritten = true;
+}
+/*==========================================================*/
+void TmcColumnFileWriter::writeFooter()
+{
+    const uint64_t footerPosition = this->position;
+    std::vector<unsigned char> &footer = this->block;
+    footer.clear();
+    putInteger(footer, this->chunks.size(), 8);
+    for (size_t i = 0; i < this->chunks.size(); i++)
+    {
+        const ChunkInfo &chunk = this->chunks[i];
+        putInteger(footer, chunk.rows, 4);
+        putInteger(footer, toBits(chunk.minTime), 8);
+        putInteger(footer, toBits(chunk.maxTime), 8);
+        for (size_t c = 0; c < chunk.offsets.size(); c++)
+        {
+            putInteger(footer, chunk.offsets[c], 8);
+            putInteger(footer, chunk.sizes[c], 4);
+        }
+    }
+    putInteger(footer, footerPosition, 8);
+    footer.insert(footer.end(), COLUMNFILE_ENDMAGIC, COLUMNFILE_ENDMAGIC + 8);
+    this->write(&footer[0], footer.size());
+}
+/*==========================================================*/
+void TmcColumnFileWriter::writeChunk()
+{
+    const size_t count = this->columns[0].size();
+    if (count == 0)
+        return;
+
+    ChunkInfo chunk;
+    chunk.rows = (uint32_t)count;
+    chunk.minTime = *std::min_element(this->columns[0].begin(), this->columns[0].end());
+    chunk.maxTime = *std::max_element(this->columns[0].begin(), this->columns[0].end());
+    for (size_t c = 0; c < this->columns.size(); c++)
+    {
+        TmcColumnFile::encode(this->codecs[c], &this->columns[c][0], count, this->block, this->mantissaBits[c]);
+        chunk.offsets.push_back(this->position);
+        chunk.sizes.push_back((uint32_t)this->block.size());
+        if (!this->block.empty())
+            this->write(&this->block[0], this->block.size());
+        this->columns[c].clear();
+    }
+    this->chunks.push_back(chunk);
+}
+/*==========================================================*/
+void TmcColumnFileWriter::write(const unsigned char *data, const std::size_t &bytes)
+{
+    this->file.write((const char *)data, (std::streamsize)bytes);
+    if (!this->file)
+        throw TmcException(UB_EXARGS, "error while writing " + this->filename);
+    this->position += bytes;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// TmcColumnFileReader
+//////////////////////////////////////////////////////////////////////////
+TmcColumnFileReader::TmcColumnFileReader(const std::string &filename)
+    : filename(filename)
+{
+    this->file.open(filename.c_str(), ios::in | ios::binary);
+    if (!this->file)
+        throw TmcException(UB_EXARGS, "couldn't open file:\n " + filename);
+
+    // header
+    unsigned char header[20];
+    this->file.read((char *)header, sizeof(header));
+    if (!this->file || std::memcmp(header, COLUMNFILE_MAGIC, 8) != 0)
+        throw TmcException(UB_EXARGS, filename + " is no tmc column file");
+    if (getInteger(header + 8, 4) > COLUMNFILE_VERSION)
+        throw TmcException(UB_EXARGS, "unsupported version of " + filename);
+    const size_t columnCount = (size_t)getInteger(header + 12, 4);
+    for (size_t c = 0; c < columnCount; c++)
+    {
+        unsigned char description[3];
+        this->file.read((char *)description, sizeof(description));
+        std::string name((size_t)getInteger(description + 1, 2), ' ');
+        if (!name.empty())
+            this->file.read(&name[0], (std::streamsize)name.size());
+        if (!this->file || description[0] > TmcColumnFile::SMOOTH)
+            throw TmcException(UB_EXARGS, "corrupt header of " + filename);
+        this->codecs.push_back((TmcColumnFile::CODEC)description[0]);
+        this->columnNames.push_back(name);
+    }
+
+    // footer
+    unsigned char trailer[16];
+    this->file.seekg(-16, ios::end);
+    const uint64_t trailerPosition = (uint64_t)this->file.tellg();
+    this->file.read((char *)trailer, sizeof(trailer));
+    if (!this->file || std::memcmp(trailer + 8, COLUMNFILE_ENDMAGIC, 8) != 0)
+        throw TmcException(UB_EXARGS, filename + " is incomplete (the writer was not closed)");
+    const uint64_t footerPosition = getInteger(trailer, 8);
+    if (footerPosition >= trailerPosition)
+        throw TmcException(UB_EXARGS, "corrupt footer of " + filename);
+
+    std::vector<unsigned char> footer((size_t)(trailerPosition - footerPosition));
+    this->file.seekg((std::streamoff)footerPosition, ios::beg);
+    this->file.read((char *)&footer[0], (std::streamsize)footer.size());
+    const size_t chunkBytes = 20 + 12 * columnCount;
+    const size_t chunkCount = footer.size() >= 8 ? (size_t)getInteger(&footer[0], 8) : 0;
+    if (!this->file || footer.size() != 8 + chunkCount * chunkBytes)
+        throw TmcException(UB_EXARGS, "corrupt footer of " + filename);
+
+    this->chunks.resize(chunkCount);
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        const unsigned char *p = &footer[8 + i * chunkBytes];
+        ChunkInfo &chunk = this->chunks[i];
+        chunk.rows = (uint32_t)getInteger(p, 4);
+        chunk.minTime = toDouble(getInteger(p + 4, 8));
+        chunk.maxTime = toDouble(getInteger(p + 12, 8));
+        for (size_t c = 0; c < columnCount; c++)
+        {
+            chunk.offsets.push_back(getInteger(p + 20 + 12 * c, 8));
+            chunk.sizes.push_back((uint32_t)getInteger(p + 28 + 12 * c, 4));
+        }
+    }
+}
+/*==========================================================*/
+int TmcColumnFileReader::getColumnIndex(const std::string &name)
+{
+    for (size_t c = 0; c < this->columnNames.size(); c++)
+        if (this->columnNames[c] == name)
+            return (int)c;
+    return -1;
+}
+/*==========================================================*/
+uint64_t TmcColumnFileReader::getNumberOfRows()
+{
+    uint64_t rows = 0;
+    for (size_t i = 0; i < this->chunks.size(); i++)
+        rows += this->chunks[i].rows;
+    return rows;
+}
+/*==========================================================*/
+double TmcColumnFileReader::getStartTime()
+{
+    double time = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < this->chunks.size(); i++)
+        time = std::min(time, this->chunks[i].minTime);
+    return time;
+}
+/*==========================================================*/
+double TmcColumnFileReader::getEndTime()
+{
+    double time = -std::numeric_limits<double>::max();
+    for (size_t i = 0; i < this->chunks.size(); i++)
+        time = std::max(time, this->chunks[i].maxTime);
+    return time;
+}
+/*==========================================================*/
+void TmcColumnFileReader::read(const std::vector<int> &columns, std::vector<std::vector<double>> &values)
+{
+    this->read(columns, -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), values);
+}
+/*==========================================================*/
+void TmcColumnFileReader::read(const std::vector<int> &columns, const double &startTime, const double &endTime, std::vector<std::vector<double>> &values)
+{
+    for (size_t i = 0; i < columns.size(); i++)
+        if (columns[i] < 0 || columns[i] >= this->getNumberOfColumns())
+            throw TmcException(UB_EXARGS, "invalid column " + TmcSystem::toString(columns[i]) + " for " + this->filename);
+
+    values.assign(columns.size(), std::vector<double>());
+    std::vector<double> time, chunkValues;
+    for (size_t k = 0; k < this->chunks.size(); k++)
+    {
+        const ChunkInfo &chunk = this->chunks[k];
+        if (chunk.maxTime < startTime || chunk.minTime > endTime)
+            continue;
+
+        // rows of this chunk inside the window
+        const bool complete = chunk.minTime >= startTime && chunk.maxTime <= endTime;
+        if (!complete)
+            this->readBlock(k, 0, time);
+
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            this->readBlock(k, columns[i], chunkValues);
+            if (complete)
+                values[i].insert(values[i].end(), chunkValues.begin(), chunkValues.end());
+            else
+            {
+                for (size_t r = 0; r < chunkValues.size(); r++)
+                    if (time[r] >= startTime && time[r] <= endTime)
+                        values[i].push_back(chunkValues[r]);
+            }
+        }
+    }
+}
+/*==========================================================*/
+std::vector<double> TmcColumnFileReader::readColumn(const int &column)
+{
+    std::vector<std::vector<double>> values;
+    this->read(std::vector<int>(1, column), values);
+    return values[0];
+}
+/*==========================================================*/
+void TmcColumnFileReader::readBlock(const std::size_t &chunk, const int &column, std::vector<double> &values)
+{
+    const ChunkInfo &info = this->chunks[chunk];
+    this->block.resize(info.sizes[column]);
+    this->file.clear();
+    this->file.seekg((std::streamoff)info.offsets[column], ios::beg);
+    if (!this->block.empty())
+        this->file.read((char *)&this->block[0], (std::streamsize)this->block.size());
+    if (!this->file)
+        throw TmcException(UB_EXARGS, "error while reading " + this->filename);
+
+    values.resize(info.rows);
+    TmcColumnFile::decode(this->codecs[column], this->block.empty() ? NULL : &this->block[0], this->block.size(), &values[0], info.rows);
+}
@@ -41,24 +41,43 @@
 \*---------------------------------------------------------------------------*/
 
 #include "TmcFileInputASCII.h"
+#include <common/utilities/TmcCharConv.h>
+#include <algorithm>
 #include <cstring>
 
 using namespace std;
 
-TmcFileInputASCII::TmcFileInputASCII(string filename)
+// must be set before the file is opened
+static const std::size_t TMCFILEINPUTASCII_BUFFERSIZE = 1 << 18;
+
+TmcFileInputASCII::TmcFileInputASCII() : TmcFileInput(), keyIndexBuilt(false), streamBuffer(TMCFILEINPUTASCII_BUFFERSIZE)
+{
+    infile.rdbuf()->pubsetbuf(&streamBuffer[0], (std::streamsize)streamBuffer.size());
+}
+/*==========================================================*/
+TmcFileInputASCII::TmcFileInputASCII(string filename) : keyIndexBuilt(false), streamBuffer(TMCFILEINPUTASCII_BUFFERSIZE)
 {
     this->filename = filename;
     this->commentindicator = 'C';
 
+    infile.rdbuf()->pubsetbuf(&streamBuffer[0], (std::streamsize)streamBuffer.size());
     infile.open(filename.c_str());
 }
 /*==========================================================*/
+TmcFileInputASCII::~TmcFileInputASCII()
+{
+    // the stream buffer is released before the base class closes the file
+    infile.close();
+}
+/*==========================================================*/
 bool TmcFileInputASCII::open(string filename)
 {
     infile.close();
     infile.clear(); // setzt flags zurueck
 
     this->filename = filename;
+    this->keyIndex.clear();
+    this->keyIndexBuilt = false;
     infile.open(this->filename.c_str());
 
     return infile.is_open();
@@ -135,8 +154,7 @@ string TmcFileInputASCII::parseString()
 double TmcFileInputASCII::readDouble()
 {
     double dummy;
-    infile >> dummy;
-    if (infile.fail())
+    if (!this->scanDouble(dummy))
         std::cout << "double failed" << std::endl;
 
     // if(infile.get() != '\n') std::cout<<"double failed - \n"<<std::endl;
@@ -146,8 +164,7 @@ double TmcFileInputASCII::readDouble()
 bool TmcFileInputASCII::parseDouble(double &value)
 {
     double dummy;
-    infile >> dummy;
-    if (infile.fail())
+    if (!this->scanDouble(dummy))
     {
         value = -999.9;
         return false;
@@ -159,9 +176,54 @@ bool TmcFileInputASCII::parseDouble(double &value)
 /*==========================================================*/
 float TmcFileInputASCII::readFloat()
 {
-    float dummy;
-    infile >> dummy;
-    return dummy;
+    double dummy;
+    this->scanDouble(dummy);
+    return (float)dummy;
+}
+/*==========================================================*/
+bool TmcFileInputASCII::scanDouble(double &value)
+{
+    value = 0.0;
+    std::istream::sentry sentry(infile); // skips whitespaces
+    if (!sentry)
+        return false;
+
+    // collect the characters a number can consist of, a sign only at the beginning or behind
+    // the exponent character (like operator>>, "1.5-2.0" gives 1.5 and leaves "-2.0")
+    std::streambuf *buffer = infile.rdbuf();
+    char token[64];
+    int length = 0;
+    int c = buffer->sgetc();
+    while (c != std::char_traits<char>::eof())
+    {
+        const bool sign = (c == '-' || c == '+') && (length == 0 || token[length - 1] == 'e' || token[length - 1] == 'E');
+        if (!sign && !((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E'))
+            break;
+        if (length == (int)sizeof(token)) //< no valid number is that long
+        {
+            length = 0;
+            break;
+        }
+        token[length++] = (char)c;
+        c = buffer->snextc();
+    }
+    if (c == std::char_traits<char>::eof())
+        infile.setstate(ios::eofbit);
+
+    const char *end = token;
+    if (length == 0 || !TmcCharConv::parseDouble(token, token + length, value, end) || end != token + length)
+    {
+        // the characters of the token are given back, the next read starts at the same position
+        int restored = 0;
+        while (restored < length && buffer->sungetc() != std::char_traits<char>::eof())
+            restored++;
+        if (restored < length)
+            buffer->pubseekoff(-(std::streamoff)(length - restored), ios::cur, ios::in);
+        value = 0.0;
+        infile.setstate(ios::failbit);
+        return false;
+    }
+    return true;
 }
 /*==========================================================*/
 string TmcFileInputASCII::readString()
@@ -185,38 +247,81 @@ std::size_t TmcFileInputASCII::readSize_t()
     return dummy;
 }
 /*==========================================================*/
-void TmcFileInputASCII::setPosAfterLineWithString(const string &var)
+void TmcFileInputASCII::buildKeyIndex()
 {
-    infile.seekg(0L, ios::beg); // set position pointer to beginning of file
-    char line[512];
-    do
+    this->keyIndex.clear();
+    this->keyIndexBuilt = true;
+
+    // one pass over the open stream, its positions are valid for seekg also in text mode
+    infile.clear();
+    const std::streampos position = infile.tellg();
+    infile.seekg(0L, ios::beg);
+
+    string line;
+    int lineNumber = 0;
+    while (getline(infile, line))
     {
-        infile.getline(line, 512);
-        if (infile.eof())
-            throw TmcException(UB_EXARGS, "error at reading in file \"" + filename + "\" -> string " + var + " wasn't found in " + this->filename);
-    } while (strstr(line, var.c_str()) != line); // Ende Schleife, wenn varname ganz in zeile vorkommt
+        if (!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+        const std::size_t keyEnd = std::min(line.find_first_of(" \t"), line.size());
+        if (keyEnd > 0)
+        {
+            const string key = line.substr(0, keyEnd);
+            if (this->keyIndex.find(key) == this->keyIndex.end())
+            {
+                KeyLine &entry = this->keyIndex[key];
+                entry.line = line;
+                entry.lineNumber = lineNumber;
+                entry.nextLine = infile.eof() ? std::streamoff(-1) : (std::streamoff)infile.tellg();
+            }
+        }
+        lineNumber++;
+    }
+
+    infile.clear();
+    if (position != std::streampos(-1))
+        infile.seekg(position);
 }
 /*==========================================================*/
-bool TmcFileInputASCII::containsString(const string &var)
+bool TmcFileInputASCII::findKey(const string &var, string &rest)
 {
-    infile.clear(); // set the EOF-Status (not done via infile.seekg() !!!)
+    // a key is one word, everything else is found by the scan of the callers
+    if (var.empty() || var.find_first_of(" \t") != string::npos)
+        return false;
+    if (!this->keyIndexBuilt)
+        this->buildKeyIndex();
+
+    // like the scan: the first line starting with var, its first word may be longer (prefix)
+    std::map<string, KeyLine>::const_iterator found = this->keyIndex.end();
+    for (std::map<string, KeyLine>::const_iterator it = this->keyIndex.lower_bound(var);
+         it != this->keyIndex.end() && it->first.compare(0, var.size(), var) == 0; ++it)
+        if (found == this->keyIndex.end() || it->second.lineNumber < found->second.lineNumber)
+            found = it;
+    if (found == this->keyIndex.end())
+        return false;
 
-    infile.seekg(0L, ios::beg); // set position pointer to beginning of file
-    char line[512];
-    do
-    {
-        infile.getline(line, 512);
-        if (infile.eof())
-            return false;
-    } while (strstr(line, var.c_str()) != line); // end of loop, if varname is in line
+    infile.clear();
+    if (found->second.nextLine < 0)
+        infile.seekg(0L, ios::end);
+    else
+        infile.seekg(found->second.nextLine, ios::beg);
 
+    const string &line = found->second.line;
+    std::size_t restBegin = var.size();
+    while (restBegin < line.size() && (line[restBegin] == ' ' || line[restBegin] == '\t'))
+        restBegin++;
+    rest = line.substr(restBegin);
     return true;
 }
 /*==========================================================*/
-int TmcFileInputASCII::readIntegerAfterString(const string &var)
-// search in file for varname and gets the int-value behind
-// e.g. timesteps 9
+// returns the rest of the first line starting with var, without leading whitespaces
+// var is looked up in the key index, if it is no complete word (e.g. "time step") the file is scanned
+string TmcFileInputASCII::readRestOfLineAfterString(const string &var)
 {
+    string rest;
+    if (this->findKey(var, rest))
+        return rest;
+
     infile.clear(); // set the EOF-Status (not done via infile.seekg() !!!)
 
     infile.seekg(0L, ios::beg); // set position pointer to beginning of file
@@ -228,63 +333,78 @@ int TmcFileInputASCII::readIntegerAfterString(const string &var)
         infile.getline(line, 512);
         if (infile.eof())
             throw TmcException(UB_EXARGS, "error at reading in file \"" + filename + "\" -> " + var + " wasn't found in " + this->filename);
-    } while (strstr(line, var.c_str()) != line);
+    } while (strstr(line, var.c_str()) != line); // end of loop, if varname is at the beginning of the line
 
-    strcpy(line, (line + strlen(var.c_str()))); // shorten line for "varname"
-    while ((line[0] == ' ') || (line[0] == '\t'))
-        strcpy(line, (line + 1)); // remove Whitespaces
+    const char *p = line + var.size(); // shorten line for "varname"
+    while ((*p == ' ') || (*p == '\t'))
+        p++; // remove Whitespaces
 
-    return atoi(line); // convert to int
+    rest = p;
+    if (!rest.empty() && rest[rest.size() - 1] == '\r')
+        rest.erase(rest.size() - 1);
+    return rest;
 }
 /*==========================================================*/
-// search in file for varname and gets the double-value behind
-// e.g. nue 9.5
-double TmcFileInputASCII::readDoubleAfterString(const string &var)
+void TmcFileInputASCII::setPosAfterLineWithString(const string &var)
 {
-    infile.clear();
-
-    infile.seekg(0L, ios::beg);
+    string rest;
+    if (this->findKey(var, rest))
+        return;
 
+    infile.seekg(0L, ios::beg); // set position pointer to beginning of file
     char line[512];
-
     do
     {
         infile.getline(line, 512);
         if (infile.eof())
-            throw TmcException(UB_EXARGS, "error at reading in file \"" + filename + "\" -> " + var + " wasn't found in " + this->filename);
-    } while (/*!strncmp(varname,line,sizeof(varname))==0*/ strstr(line, var.c_str()) != line);
-
-    strcpy(line, (line + strlen(var.c_str())));
-    while ((line[0] == ' ') || (line[0] == '\t'))
-        strcpy(line, (line + 1));
-
-    return (atof(line)); // convert to double
+            throw TmcException(UB_EXARGS, "error at reading in file \"" + filename + "\" -> string " + var + " wasn't found in " + this->filename);
+    } while (strstr(line, var.c_str()) != line); // Ende Schleife, wenn varname ganz in zeile vorkommt
 }
 /*==========================================================*/
-string TmcFileInputASCII::readStringAfterString(const string &var)
+bool TmcFileInputASCII::containsString(const string &var)
 {
-    infile.clear();
+    string rest;
+    if (this->findKey(var, rest))
+        return true;
 
-    infile.seekg(0L, ios::beg);
+    infile.clear(); // set the EOF-Status (not done via infile.seekg() !!!)
 
+    infile.seekg(0L, ios::beg); // set position pointer to beginning of file
     char line[512];
-
     do
     {
         infile.getline(line, 512);
         if (infile.eof())
-            throw TmcException(UB_EXARGS, "error at reading in file \"" + filename + "\" -> " + var + " wasn't found in " + this->filename);
-    } while (strstr(line, var.c_str()) != line);
+            return false;
+    } while (strstr(line, var.c_str()) != line); // end of loop, if varname is in line
 
-    strcpy(line, (line + strlen(var.c_str())));
-    while ((line[0] == ' ') || (line[0] == '\t'))
-        strcpy(line, (line + 1));
+    return true;
+}
+/*==========================================================*/
+int TmcFileInputASCII::readIntegerAfterString(const string &var)
+// search in file for varname and gets the int-value behind
+// e.g. timesteps 9
+{
+    return atoi(this->readRestOfLineAfterString(var).c_str()); // convert to int
+}
+/*==========================================================*/
+// search in file for varname and gets the double-value behind
+// e.g. nue 9.5
+double TmcFileInputASCII::readDoubleAfterString(const string &var)
+{
+    const string rest = this->readRestOfLineAfterString(var);
 
-    char *p;
-    p = strtok(line, " ");
-    p = strtok(line, "\t");
+    double value = 0.0;
+    const char *end;
+    TmcCharConv::parseDouble(rest.c_str(), rest.c_str() + rest.size(), value, end);
+    return value;
+}
+/*==========================================================*/
+string TmcFileInputASCII::readStringAfterString(const string &var)
+{
+    const string rest = this->readRestOfLineAfterString(var);
 
-    return static_cast<string>(p); // convert to string
+    return rest.substr(0, rest.find_first_of(" \t")); // first word
 }
 /*==========================================================*/
 bool TmcFileInputASCII::readBoolAfterString(const string &var)
@@ -45,7 +45,9 @@
 
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "TmcException.h"
 #include "TmcFileInput.h"
@@ -55,8 +57,9 @@
 class TMC_DLL_EXPORT TmcFileInputASCII : public TmcFileInput
 {
 public:
-    TmcFileInputASCII() : TmcFileInput() {}
+    TmcFileInputASCII();
     TmcFileInputASCII(std::string filename);
+    ~TmcFileInputASCII();
 
     bool open(std::string filename);
 
@@ -96,6 +99,29 @@ public:
         file.infile >> data;
         return file;
     }
+
+private:
+    // reads a number directly from the stream buffer, sets failbit on error like operator>>
+    bool scanDouble(double &value);
+
+    // the *AfterString methods look up keys in an index of the first words of the lines, which is
+    // built with the first lookup. As before, the first line which starts with the key is found,
+    // also if its first word is longer ("time" finds "timesteps 9"). The stream is positioned
+    // behind the found line afterwards.
+    bool findKey(const std::string &var, std::string &rest);
+    std::string readRestOfLineAfterString(const std::string &var);
+    void buildKeyIndex();
+
+    struct KeyLine
+    {
+        std::string line;        //< the first line with this first word
+        int lineNumber;
+        std::streamoff nextLine; //< position of the following line, -1: end of the file
+    };
+    std::map<std::string, KeyLine> keyIndex; //< sorted, the keys with a prefix are neighbours
+    bool keyIndexBuilt;
+
+    std::vector<char> streamBuffer;
 };
 
 #endif // TMCFILEINPUTASCII_H
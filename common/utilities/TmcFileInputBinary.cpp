@@ -70,6 +70,11 @@ int TmcFileInputBinary::readInteger()
     return dummy;
 }
 /*==========================================================*/
+void TmcFileInputBinary::readBlock(char *data, const std::size_t &bytes)
+{
+    infile.read(data, (std::streamsize)bytes);
+}
+/*==========================================================*/
 uint16_t TmcFileInputBinary::readUnsignedInteger16()
 {
     uint16_t dummy;
@@ -76,6 +76,8 @@ public:
     std::string readString();
     std::string readLineTill(char stop);
     std::string parseString();
+    // raw bytes in one read call
+    void readBlock(char *data, const std::size_t &bytes);
 
     bool containsString(const std::string &var);
     void setPosAfterLineWithString(const std::string &var);
@@ -45,15 +45,26 @@
 #include <common/math/TmcMath.h>
 #include <common/math/TmcEqual.h>
 #include <common/math/TmcInfinity.h>
+#include <common/utilities/TmcCharConv.h>
 #include <cstring>
 
 using namespace std;
 
+// must be set before the file is opened
+static const std::size_t TMCFILEOUTPUTASCII_BUFFERSIZE = 1 << 18;
+
+TmcFileOutputASCII::TmcFileOutputASCII()
+    : TmcFileOutput(), streamBuffer(TMCFILEOUTPUTASCII_BUFFERSIZE)
+{
+    outfile.rdbuf()->pubsetbuf(&streamBuffer[0], (std::streamsize)streamBuffer.size());
+}
+/*==========================================================*/
 TmcFileOutputASCII::TmcFileOutputASCII(const string &filename, const bool &createPath, const int &precision)
-    : TmcFileOutput(filename)
+    : TmcFileOutput(filename), streamBuffer(TMCFILEOUTPUTASCII_BUFFERSIZE)
 {
     this->commentindicator = 'C';
     this->setPrecision(20);
+    outfile.rdbuf()->pubsetbuf(&streamBuffer[0], (std::streamsize)streamBuffer.size());
 
     outfile.open(filename.c_str(), ios::out);
 
@@ -73,10 +84,11 @@ TmcFileOutputASCII::TmcFileOutputASCII(const string &filename, const bool &creat
 }
 /*==========================================================*/
 TmcFileOutputASCII::TmcFileOutputASCII(const std::string &filename, CREATEOPTION opt, const bool &createPath, const int &precision)
-    : TmcFileOutput(filename)
+    : TmcFileOutput(filename), streamBuffer(TMCFILEOUTPUTASCII_BUFFERSIZE)
 {
     this->commentindicator = 'C';
     this->setPrecision(precision);
+    outfile.rdbuf()->pubsetbuf(&streamBuffer[0], (std::streamsize)streamBuffer.size());
 
     if (!this->open(filename, opt) && createPath)
     {
@@ -92,6 +104,13 @@ TmcFileOutputASCII::TmcFileOutputASCII(const std::string &filename, CREATEOPTION
         throw TmcException(UB_EXARGS, "couldn't open file:\n " + filename);
 }
 /*==========================================================*/
+TmcFileOutputASCII::~TmcFileOutputASCII()
+{
+    // the stream buffer is released before the base class flushes the file
+    outfile.flush();
+    outfile.close();
+}
+/*==========================================================*/
 bool TmcFileOutputASCII::open(const std::string &filename, CREATEOPTION opt)
 {
     outfile.close();
@@ -121,10 +140,19 @@ void TmcFileOutputASCII::writeBool(const bool &value, const int &width)
 /*==========================================================*/
 void TmcFileOutputASCII::writeDouble(const double &value, const int &width)
 {
-    outfile.width(width);
     // Problem: Tmc::inf rounded
     //          -> by reading the value might to big and it creates wrong output
     //          -> display max length
+    if (this->hasDefaultNumberFormat())
+    {
+        if (TmcMath::equal(value, (double)Tmc::inf))
+            this->writeNumber(value, std::numeric_limits<double>::digits10 + 2, width);
+        else
+            this->writeNumber(value, (int)outfile.precision(), width);
+        return;
+    }
+
+    outfile.width(width);
     if (TmcMath::equal(value, (double)Tmc::inf))
     {
         ios_base::fmtflags flags = outfile.flags();
@@ -138,10 +166,19 @@ void TmcFileOutputASCII::writeDouble(const double &value, const int &width)
 /*==========================================================*/
 void TmcFileOutputASCII::writeFloat(const float &value, const int &width)
 {
-    outfile.width(width);
     // Problem: Tmc::inf rounded
     //          -> by reading the value might to big and it creates wrong output
     //          -> display max length
+    if (this->hasDefaultNumberFormat())
+    {
+        if (TmcMath::equal(value, (float)Tmc::inf))
+            this->writeNumber(value, std::numeric_limits<float>::digits10 + 2, width);
+        else
+            this->writeNumber(value, (int)outfile.precision(), width);
+        return;
+    }
+
+    outfile.width(width);
     if (TmcMath::equal(value, (float)Tmc::inf))
     {
         ios_base::fmtflags flags = outfile.flags();
@@ -153,6 +190,38 @@ void TmcFileOutputASCII::writeFloat(const float &value, const int &width)
     outfile << value << " ";
 }
 /*==========================================================*/
+// true if the stream would write value like "%.*g" (no std::fixed, std::scientific, std::left ...)
+bool TmcFileOutputASCII::hasDefaultNumberFormat()
+{
+    const ios_base::fmtflags special = ios::floatfield | ios::adjustfield | ios::showpoint | ios::showpos | ios::uppercase;
+    return (outfile.flags() & special & ~ios::right) == 0;
+}
+/*==========================================================*/
+void TmcFileOutputASCII::writeNumber(const double &value, const int &precision, const int &width)
+{
+    if (!outfile)
+        return;
+
+    char text[64];
+    const int length = TmcCharConv::formatDouble(text, (int)sizeof(text), value, precision);
+    if (length == 0)
+    {
+        // the text doesn't fit into the buffer (huge precision) -> the stream formats it
+        const std::streamsize previous = outfile.precision(precision);
+        outfile.width(width);
+        outfile << value << " ";
+        outfile.precision(previous);
+        return;
+    }
+
+    std::streambuf *buffer = outfile.rdbuf();
+    const char fill = outfile.fill();
+    for (int i = length; i < width; i++)
+        buffer->sputc(fill);
+    if (buffer->sputn(text, length) != length || buffer->sputc(' ') == std::char_traits<char>::eof())
+        outfile.setstate(ios::badbit);
+}
+/*==========================================================*/
 void TmcFileOutputASCII::setPrecision(const int &precision)
 {
     outfile << setprecision(precision);
@@ -197,12 +266,12 @@ void TmcFileOutputASCII::writeStringOnly(const string &value)
 void TmcFileOutputASCII::writeLine(const string &value, const int &width)
 {
     outfile.width(width);
-    outfile << value.c_str() << endl;
+    outfile << value.c_str() << "\n";
 }
 /*==========================================================*/
 void TmcFileOutputASCII::writeLine()
 {
-    outfile << endl;
+    outfile << "\n";
 }
 /*==========================================================*/
 void TmcFileOutputASCII::writeCommentLine(const string &line)
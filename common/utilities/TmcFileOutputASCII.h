@@ -46,6 +46,7 @@
 #include <iomanip>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 #include "TmcException.h"
 #include "TmcFileOutput.h"
@@ -55,9 +56,10 @@
 class TMC_DLL_EXPORT TmcFileOutputASCII : public TmcFileOutput
 {
 public:
-    TmcFileOutputASCII() : TmcFileOutput() {}
+    TmcFileOutputASCII();
     TmcFileOutputASCII(const std::string &filename, const bool &createPath = true, const int &precision = 15);
     TmcFileOutputASCII(const std::string &filename, CREATEOPTION opt, const bool &createPath = true, const int &precision = 15);
+    ~TmcFileOutputASCII();
 
     bool open(const std::string &filename, CREATEOPTION opt = OUTFILE);
 
@@ -90,6 +92,13 @@ public:
         file.outfile << data;
         return file;
     }
+
+private:
+    // formats value with TmcCharConv and writes it directly into the stream buffer
+    void writeNumber(const double &value, const int &precision, const int &width);
+    bool hasDefaultNumberFormat();
+
+    std::vector<char> streamBuffer;
 };
 
 #endif
@@ -136,6 +136,11 @@ int TmcFileOutputBinary::getPrecision()
     throw TmcException(UB_EXARGS, "no way");
 }
 /*==========================================================*/
+void TmcFileOutputBinary::writeBlock(const char *data, const std::size_t &bytes)
+{
+    outfile.write(data, (std::streamsize)bytes);
+}
+/*==========================================================*/
 void TmcFileOutputBinary::writeInteger(const int &value, const int &width)
 {
     outfile.write((char *)&value, sizeof(value));
@@ -75,6 +75,8 @@ public:
     void writeCommentLine(const std::string &line);
     void writeCommentLine(char indicator, const std::string &line);
     void writeCopyOfFile(const std::string &filename);
+    // raw bytes in one write call
+    void writeBlock(const char *data, const std::size_t &bytes);
 
     void setPrecision(const int &precision);
     int getPrecision();
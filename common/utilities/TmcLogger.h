@@ -75,6 +75,9 @@
 //
 // Bsp2: siehe Dateiende!
 //
+// while Output2AsyncStream (TmcAsyncLogger.h) has a stream, the UBLOG macros write through the
+// asynchronous logger instead of Output2Stream
+//
 
 enum LogLevel
 {
@@ -327,6 +330,16 @@ public:
 #define UBLOG_MAX_LEVEL logDEBUG5
 #endif
 
+//////////////////////////////////////////////////////////////////////////
+// writes one entry (without level filtering), through TmcAsyncLog if Output2AsyncStream has a
+// stream (see TmcAsyncLogger.h), otherwise through TmcLog
+//////////////////////////////////////////////////////////////////////////
+#define UBLOG_ENTRY(level, logtext)                                                                 \
+    if (Output2AsyncStream::hasStream())                                                            \
+        TmcAsyncLog(level).get() << logtext;                                                        \
+    else                                                                                            \
+        TmcLog().get(level) << logtext;
+
 //////////////////////////////////////////////////////////////////////////
 // main macro for logging
 //  example UBLOG(logINFO) << "this is a log entry";
@@ -335,7 +348,7 @@ public:
     if (level > UBLOG_MAX_LEVEL || level > TmcLog::reportingLevel() || !Output2Stream::getStream()) \
         ;                                                                                           \
     else                                                                                            \
-        TmcLog().get(level) << logtext;
+        UBLOG_ENTRY(level, logtext)
 
 // why this macro
 // e.g. UBLOG(logDEBUG2) << "I am sooo great " << username;
@@ -364,7 +377,7 @@ public:
         {                                                                                           \
             std::string dummy;                                                                      \
             getline(input, dummy, '\n');                                                            \
-            TmcLog().get(level) << dummy;                                                           \
+            UBLOG_ENTRY(level, dummy)                                                               \
         }                                                                                           \
     }
 //////////////////////////////////////////////////////////////////////////
@@ -380,7 +393,7 @@ public:
     else                                                                                            \
     {                                                                                               \
         stream << text << std::endl;                                                                \
-        TmcLog().get(level) << text;                                                                \
+        UBLOG_ENTRY(level, text)                                                                    \
     }
 
 //////////////////////////////////////////////////////////////////////////
@@ -400,7 +413,7 @@ public:
         {                                                                                           \
             std::string dummy;                                                                      \
             getline(input, dummy, '\n');                                                            \
-            TmcLog().get(level) << dummy;                                                           \
+            UBLOG_ENTRY(level, dummy)                                                               \
         }                                                                                           \
     }
 
@@ -433,4 +446,7 @@ public:
 //    UBLOG(logERROR) << e.what();
 // }
 
+// the UBLOG macros need TmcAsyncLog and Output2AsyncStream
+#include <common/utilities/TmcAsyncLogger.h>
+
 #endif // UBLOGGER_H
@@ -0,0 +1,149 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    lock-free bounded queue (multiple producers, single consumer)
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TMCMPSCQUEUE_H
+#define TMCMPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+// TmcMpscQueue
+// bounded lock-free queue for many producer threads and one consumer thread
+// Functionality:
+// array based queue after D. Vyukov, every slot carries a sequence number which tells
+// producers and the consumer whether the slot is free or filled. A producer reserves a slot
+// by a compare-and-swap on the tail and publishes it by the sequence number, so items become
+// visible in the order of their reservation. The capacity is rounded up to the next power of two.
+// push() returns false if the queue is full, the caller decides how to handle the overflow.
+//
+// Example:     TmcMpscQueue<Record> queue(4096);
+//              producers: if (!queue.push(record)) ... //full
+//              consumer:  Record record; while (queue.pop(record)) ...
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+class TmcMpscQueue
+{
+public:
+    explicit TmcMpscQueue(const std::size_t &capacity = 1024)
+        : head(0), tail(0)
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        this->mask = size - 1;
+        this->slots = std::vector<Slot>(size);
+        for (std::size_t i = 0; i < size; i++)
+            this->slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    /*==========================================================*/
+    // producer side, thread safe
+    bool push(const T &item)
+    {
+        std::size_t position = this->tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Slot &slot = this->slots[position & this->mask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = (std::ptrdiff_t)sequence - (std::ptrdiff_t)position;
+            if (difference == 0)
+            {
+                if (this->tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.item = item;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+                return false; //< full
+            else
+                position = this->tail.load(std::memory_order_relaxed);
+        }
+    }
+    /*==========================================================*/
+    // consumer side, only one thread
+    bool pop(T &item)
+    {
+        const std::size_t position = this->head.load(std::memory_order_relaxed);
+        Slot &slot = this->slots[position & this->mask];
+        const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != position + 1)
+            return false; //< empty or the next producer has not finished yet
+        item = slot.item;
+        slot.sequence.store(position + this->mask + 1, std::memory_order_release);
+        this->head.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+    /*==========================================================*/
+    // only a snapshot
+    std::size_t size() const
+    {
+        const std::size_t t = this->tail.load(std::memory_order_relaxed);
+        const std::size_t h = this->head.load(std::memory_order_relaxed);
+        return t > h ? t - h : 0;
+    }
+    /*==========================================================*/
+    bool empty() const { return this->size() == 0; }
+    /*==========================================================*/
+    std::size_t capacity() const { return this->mask + 1; }
+
+private:
+    TmcMpscQueue(const TmcMpscQueue &);
+    TmcMpscQueue &operator=(const TmcMpscQueue &);
+
+    struct Slot
+    {
+        Slot() : sequence(0) {}
+        Slot(const Slot &) : sequence(0) {}
+        Slot &operator=(const Slot &) { return *this; }
+
+        std::atomic<std::size_t> sequence;
+        T item;
+    };
+
+    std::vector<Slot> slots;
+    std::size_t mask;
+
+    std::atomic<std::size_t> head;
+    char headPadding[64];
+    std::atomic<std::size_t> tail;
+    char tailPadding[64];
+};
+
+#endif // TMCMPSCQUEUE_H
@@ -0,0 +1,93 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    result records and their destinations
+
+\*---------------------------------------------------------------------------*/
+
+#include "TmcResultSink.h"
+#include <common/utilities/TmcException.h>
+#include <common/utilities/TmcFileOutput.h>
+
+using namespace std;
+
+TmcResultFileSink::TmcResultFileSink(TmcFileOutput *out, const bool &gcControl)
+    : out(out), gcControl(gcControl), headerWritten(false)
+{
+    if (!out)
+        throw TmcException(UB_EXARGS, "null output-stream");
+}
+/*==========================================================*/
+TmcResultFileSink::~TmcResultFileSink()
+{
+    if (this->gcControl)
+        delete this->out;
+}
+/*==========================================================*/
+void TmcResultFileSink::setColumnNames(const std::vector<std::string> &names)
+{
+    this->columnNames = names;
+}
+/*==========================================================*/
+void TmcResultFileSink::writeRecords(const TmcResultRecord *records, const std::size_t &count)
+{
+    const bool ascii = this->out->getFileType() == TmcFileOutput::ASCII;
+    if (!this->headerWritten)
+    {
+        if (ascii && !this->columnNames.empty())
+        {
+            string line;
+            for (size_t i = 0; i < this->columnNames.size(); i++)
+                line += " " + this->columnNames[i];
+            this->out->writeCommentLine(line);
+        }
+        this->headerWritten = true;
+    }
+
+    for (size_t r = 0; r < count; r++)
+    {
+        for (int i = 0; i < records[r].size; i++)
+            this->out->writeDouble(records[r].values[i]);
+        if (ascii)
+            this->out->writeLine();
+    }
+    if (!(*this->out))
+        throw TmcException(UB_EXARGS, "error while writing " + this->out->getFileName());
+}
+/*==========================================================*/
+void TmcResultFileSink::flush()
+{
+    this->out->flush();
+    if (!(*this->out))
+        throw TmcException(UB_EXARGS, "error while writing " + this->out->getFileName());
+}
@@ -0,0 +1,112 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    result records and their destinations
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TMCRESULTSINK_H
+#define TMCRESULTSINK_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <TmcMacroFile.h>
+
+class TmcFileOutput;
+
+//////////////////////////////////////////////////////////////////////////
+// TmcResultRecord
+// one row of a time history (e.g. time, displacement, velocity), fixed size so that
+// records can be passed through a ring buffer without allocation
+//////////////////////////////////////////////////////////////////////////
+struct TmcResultRecord
+{
+    enum
+    {
+        MAX_VALUES = 15
+    };
+
+    TmcResultRecord() : size(0) {}
+
+    double values[MAX_VALUES];
+    int size;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// TmcResultSink
+// destination of result records, e.g. a file (TmcResultFileSink)
+// the methods are called by one thread only (see TmcAsyncResultWriter), errors are reported
+// by exceptions
+//////////////////////////////////////////////////////////////////////////
+class TMC_DLL_EXPORT TmcResultSink
+{
+public:
+    virtual ~TmcResultSink() {}
+
+    virtual void writeRecords(const TmcResultRecord *records, const std::size_t &count) = 0;
+    // makes the written records durable (checkpoint, close)
+    virtual void flush() = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// TmcResultFileSink
+// writes records into a TmcFileOutput
+// ASCII:  one line per record, the values separated by blanks
+// BINARY: the values as raw doubles, one record after the other
+//////////////////////////////////////////////////////////////////////////
+class TMC_DLL_EXPORT TmcResultFileSink : public TmcResultSink
+{
+public:
+    // gcControl = true -> out will be deleted by the sink
+    TmcResultFileSink(TmcFileOutput *out, const bool &gcControl = false);
+    ~TmcResultFileSink();
+
+    // written as comment line (ASCII only) before the first record
+    void setColumnNames(const std::vector<std::string> &names);
+
+    void writeRecords(const TmcResultRecord *records, const std::size_t &count);
+    void flush();
+
+private:
+    TmcResultFileSink(const TmcResultFileSink &);
+    TmcResultFileSink &operator=(const TmcResultFileSink &);
+
+    TmcFileOutput *out;
+    bool gcControl;
+    std::vector<std::string> columnNames;
+    bool headerWritten;
+};
+
+#endif // TMCRESULTSINK_H
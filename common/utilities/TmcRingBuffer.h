@@ -0,0 +1,147 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    lock-free ring buffer (single producer, single consumer)
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TMCRINGBUFFER_H
+#define TMCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+// TmcRingBuffer
+// bounded lock-free queue for exactly one producer and one consumer thread
+// Functionality:
+// the capacity is rounded up to the next power of two. push() never blocks and returns
+// false if the buffer is full, pop() returns false if the buffer is empty. head and tail
+// are placed on different cache lines, so producer and consumer do not share a line
+// in the common case.
+//
+// Example:     TmcRingBuffer<double> buffer(1024);
+//              producer:  if (!buffer.push(value)) ... //full
+//              consumer:  double value; while (buffer.pop(value)) ...
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+class TmcRingBuffer
+{
+public:
+    explicit TmcRingBuffer(const std::size_t &capacity = 1024)
+        : head(0), tail(0)
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        this->buffer.resize(size);
+        this->mask = size - 1;
+        this->cachedHead = 0;
+        this->cachedTail = 0;
+    }
+    /*==========================================================*/
+    // producer side
+    bool push(const T &item)
+    {
+        const std::size_t currentTail = this->tail.load(std::memory_order_relaxed);
+        if (currentTail - this->cachedHead > this->mask)
+        {
+            this->cachedHead = this->head.load(std::memory_order_acquire);
+            if (currentTail - this->cachedHead > this->mask)
+                return false;
+        }
+        this->buffer[currentTail & this->mask] = item;
+        this->tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+    /*==========================================================*/
+    // consumer side
+    bool pop(T &item)
+    {
+        const std::size_t currentHead = this->head.load(std::memory_order_relaxed);
+        if (currentHead == this->cachedTail)
+        {
+            this->cachedTail = this->tail.load(std::memory_order_acquire);
+            if (currentHead == this->cachedTail)
+                return false;
+        }
+        item = this->buffer[currentHead & this->mask];
+        this->head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+    /*==========================================================*/
+    // consumer side, removes up to maxCount items in one go
+    std::size_t pop(T *items, const std::size_t &maxCount)
+    {
+        const std::size_t currentHead = this->head.load(std::memory_order_relaxed);
+        this->cachedTail = this->tail.load(std::memory_order_acquire);
+        std::size_t count = this->cachedTail - currentHead;
+        if (count > maxCount)
+            count = maxCount;
+        for (std::size_t i = 0; i < count; i++)
+            items[i] = this->buffer[(currentHead + i) & this->mask];
+        if (count > 0)
+            this->head.store(currentHead + count, std::memory_order_release);
+        return count;
+    }
+    /*==========================================================*/
+    // only a snapshot if called while the other side is working
+    std::size_t size() const
+    {
+        return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire);
+    }
+    /*==========================================================*/
+    bool empty() const { return this->size() == 0; }
+    /*==========================================================*/
+    std::size_t capacity() const { return this->mask + 1; }
+
+private:
+    TmcRingBuffer(const TmcRingBuffer &);
+    TmcRingBuffer &operator=(const TmcRingBuffer &);
+
+    std::vector<T> buffer;
+    std::size_t mask;
+
+    // consumer cache line
+    std::atomic<std::size_t> head;
+    std::size_t cachedTail;
+    char headPadding[64];
+
+    // producer cache line
+    std::atomic<std::size_t> tail;
+    std::size_t cachedHead;
+    char tailPadding[64];
+};
+
+#endif // TMCRINGBUFFER_H
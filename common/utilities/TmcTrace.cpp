@@ -0,0 +1,321 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    tracing - records begin/end events and writes them in the Chrome trace event format
+
+\*---------------------------------------------------------------------------*/
+
+#include "TmcTrace.h"
+#include <common/utilities/TmcRingBuffer.h>
+#include <common/utilities/TmcSystem.h>
+#include <common/utilities/TmcException.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+std::atomic<bool> TmcTrace::enabled(false);
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char *name;
+        const char *category;
+        int64_t begin;
+        int64_t duration; //< -1 -> instant event
+    };
+
+    typedef TmcRingBuffer<TraceEvent> EventBuffer;
+
+    struct ThreadBuffer
+    {
+        ThreadBuffer(unique_ptr<EventBuffer> events, const unsigned long &threadId)
+            : events(std::move(events)), threadId(threadId), dropped(0)
+        {
+        }
+        unique_ptr<EventBuffer> events; //< NULL after the thread has finished
+        vector<TraceEvent> finished;    //< events left by the finished thread
+        unsigned long threadId;
+        string threadName; //< guarded by registryMutex()
+        std::atomic<size_t> dropped;
+    };
+
+    std::mutex &registryMutex()
+    {
+        static std::mutex mtx;
+        return mtx;
+    }
+
+    // the buffers outlive their threads, so events of finished threads can still be written
+    vector<shared_ptr<ThreadBuffer>> &registry()
+    {
+        static vector<shared_ptr<ThreadBuffer>> buffers;
+        return buffers;
+    }
+
+    // ring buffers of finished threads, reused by new threads
+    vector<unique_ptr<EventBuffer>> &freeEventBuffers()
+    {
+        static vector<unique_ptr<EventBuffer>> buffers;
+        return buffers;
+    }
+
+    std::atomic<size_t> &bufferCapacity()
+    {
+        static std::atomic<size_t> capacity(1 << 16);
+        return capacity;
+    }
+
+    // per thread: the name is cheap, the buffer is created with the first recorded event
+    struct ThreadState
+    {
+        // keeps the remaining events only and hands the ring buffer on
+        ~ThreadState()
+        {
+            if (!this->buffer)
+                return;
+            std::lock_guard<std::mutex> lock(registryMutex());
+            TraceEvent event;
+            this->buffer->finished.reserve(this->buffer->events->size());
+            while (this->buffer->events->pop(event))
+                this->buffer->finished.push_back(event);
+            freeEventBuffers().push_back(std::move(this->buffer->events));
+        }
+        shared_ptr<ThreadBuffer> buffer;
+        string threadName;
+    };
+
+    ThreadState &threadState()
+    {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    ThreadBuffer &threadBuffer()
+    {
+        ThreadState &state = threadState();
+        if (!state.buffer)
+        {
+            const size_t capacity = bufferCapacity().load();
+            std::lock_guard<std::mutex> lock(registryMutex());
+            unique_ptr<EventBuffer> events;
+            vector<unique_ptr<EventBuffer>> &free = freeEventBuffers();
+            for (size_t i = 0; i < free.size() && !events; i++)
+                if (free[i]->capacity() >= capacity)
+                {
+                    events = std::move(free[i]);
+                    free.erase(free.begin() + i);
+                }
+            if (!events)
+                events.reset(new EventBuffer(capacity));
+            state.buffer = make_shared<ThreadBuffer>(std::move(events), TmcSystem::getCurrentThreadID());
+            state.buffer->threadName = state.threadName;
+            registry().push_back(state.buffer);
+        }
+        return *state.buffer;
+    }
+
+    void writeJsonString(ostream &out, const char *str)
+    {
+        out << '"';
+        for (const char *c = str; *c; c++)
+        {
+            if (*c == '"' || *c == '\\')
+                out << '\\';
+            out << *c;
+        }
+        out << '"';
+    }
+
+    // drops the records of finished threads whose events are written, registryMutex() has to be locked
+    void releaseFinishedThreads()
+    {
+        vector<shared_ptr<ThreadBuffer>> &buffers = registry();
+        for (size_t t = buffers.size(); t-- > 0;)
+            if (!buffers[t]->events && buffers[t]->finished.empty() && buffers[t]->dropped.load() == 0)
+                buffers.erase(buffers.begin() + t);
+    }
+
+    // chrome trace time stamps are in microseconds
+    void writeMicroseconds(ostream &out, const int64_t &nanoseconds)
+    {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%lld.%03d", (long long)(nanoseconds / 1000), (int)(nanoseconds % 1000));
+        out << buffer;
+    }
+}
+/*==========================================================*/
+void TmcTrace::setEnabled(const bool &enabled)
+{
+    if (enabled)
+        TmcTrace::now(); //< fixes the epoch
+    TmcTrace::enabled.store(enabled, std::memory_order_relaxed);
+}
+/*==========================================================*/
+void TmcTrace::setBufferCapacity(const std::size_t &eventsPerThread)
+{
+    bufferCapacity().store(eventsPerThread);
+}
+/*==========================================================*/
+void TmcTrace::setThreadName(const std::string &name)
+{
+    ThreadState &state = threadState();
+    state.threadName = name;
+    if (state.buffer)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        state.buffer->threadName = name;
+    }
+}
+/*==========================================================*/
+int64_t TmcTrace::now()
+{
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+/*==========================================================*/
+void TmcTrace::record(const char *name, const char *category, const int64_t &begin, const int64_t &end)
+{
+    ThreadBuffer &buffer = threadBuffer();
+    TraceEvent event = {name, category, begin, end - begin};
+    if (!buffer.events->push(event))
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+}
+/*==========================================================*/
+void TmcTrace::instant(const char *name, const char *category)
+{
+    ThreadBuffer &buffer = threadBuffer();
+    TraceEvent event = {name, category, TmcTrace::now(), -1};
+    if (!buffer.events->push(event))
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+}
+/*==========================================================*/
+std::size_t TmcTrace::writeChromeTrace(const std::string &filename)
+{
+    ofstream out(filename.c_str(), ios::out);
+    if (!out)
+    {
+        out.clear();
+        string path = TmcSystem::getPathFromString(filename);
+        if (path.size() > 0)
+        {
+            TmcSystem::makeDirectory(path);
+            out.open(filename.c_str(), ios::out);
+        }
+    }
+    if (!out)
+        throw TmcException(UB_EXARGS, "couldn't open file:\n " + filename);
+
+    const int pid = TmcSystem::getProcessID();
+    size_t written = 0;
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (size_t t = 0; t < registry().size(); t++)
+    {
+        ThreadBuffer &buffer = *registry()[t];
+
+        if (t > 0)
+            out << ",";
+        out << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer.threadId << ",\"args\":{\"name\":";
+        writeJsonString(out, buffer.threadName.empty() ? ("thread " + TmcSystem::toString(buffer.threadId)).c_str() : buffer.threadName.c_str());
+        out << "}}";
+
+        TraceEvent event;
+        for (size_t e = 0; buffer.events ? buffer.events->pop(event) : e < buffer.finished.size(); e++)
+        {
+            if (!buffer.events)
+                event = buffer.finished[e];
+            out << ",\n{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"cat\":";
+            writeJsonString(out, event.category);
+            if (event.duration < 0)
+                out << ",\"ph\":\"i\",\"s\":\"t\",\"ts\":";
+            else
+                out << ",\"ph\":\"X\",\"ts\":";
+            writeMicroseconds(out, event.begin);
+            if (event.duration >= 0)
+            {
+                out << ",\"dur\":";
+                writeMicroseconds(out, event.duration);
+            }
+            out << ",\"pid\":" << pid << ",\"tid\":" << buffer.threadId << "}";
+            written++;
+        }
+        buffer.finished.clear();
+
+        const size_t dropped = buffer.dropped.exchange(0);
+        if (dropped > 0)
+        {
+            out << ",\n{\"name\":\"dropped events\",\"ph\":\"C\",\"ts\":";
+            writeMicroseconds(out, TmcTrace::now());
+            out << ",\"pid\":" << pid << ",\"tid\":" << buffer.threadId << ",\"args\":{\"dropped\":" << dropped << "}}";
+        }
+    }
+    out << "\n]}\n";
+    releaseFinishedThreads();
+
+    return written;
+}
+/*==========================================================*/
+void TmcTrace::clear()
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (size_t t = 0; t < registry().size(); t++)
+    {
+        ThreadBuffer &buffer = *registry()[t];
+        TraceEvent event;
+        while (buffer.events && buffer.events->pop(event))
+            ;
+        buffer.finished.clear();
+        buffer.dropped.store(0);
+    }
+    releaseFinishedThreads();
+}
+/*==========================================================*/
+std::size_t TmcTrace::getNumberOfDroppedEvents()
+{
+    size_t dropped = 0;
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (size_t t = 0; t < registry().size(); t++)
+        dropped += registry()[t]->dropped.load();
+    return dropped;
+}
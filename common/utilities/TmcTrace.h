@@ -0,0 +1,140 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    tracing - records begin/end events and writes them in the Chrome trace event format
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TMCTRACE_H
+#define TMCTRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <TmcMacroFile.h>
+
+//////////////////////////////////////////////////////////////////////////
+// TmcTrace
+// low overhead tracing of the program execution in the Chrome trace event format
+// Functionality:
+// every thread records its events into an own lock-free TmcRingBuffer (producer: the thread itself,
+// consumer: writeChromeTrace). A scope is stored as one complete event (begin + duration), so a dropped
+// event never leaves an unmatched begin in the trace. If the buffer of a thread is full, new events are
+// dropped and counted. writeChromeTrace() drains all buffers into a json file which can be opened with
+// chrome://tracing or https://ui.perfetto.dev
+// The names and categories are stored as pointers only -> use string literals.
+//
+// A thread gets its buffer with its first recorded event. When the thread finishes, its remaining
+// events are kept until they are written (or cleared) and the buffer is reused by a later thread.
+//
+// tracing is switched off by default -> TmcTrace::setEnabled(true)
+// compiling with TMC_NO_TRACE removes the macros completely
+//
+// Help macro:  TMC_TRACE_SCOPE
+// Example:     {
+//                 TMC_TRACE_SCOPE("decomposeLU", "algebra");
+//                 ...
+//              } //<- end event
+//              TmcTrace::writeChromeTrace("c:/temp/trace.json");
+//////////////////////////////////////////////////////////////////////////
+class TMC_DLL_EXPORT TmcTrace
+{
+public:
+    static void setEnabled(const bool &enabled);
+    static bool isEnabled() { return TmcTrace::enabled.load(std::memory_order_relaxed); }
+
+    // size of the ring buffers of threads that record their first event afterwards
+    static void setBufferCapacity(const std::size_t &eventsPerThread);
+    // name of the calling thread in the trace viewer, allocates no event buffer
+    static void setThreadName(const std::string &name);
+
+    // nanoseconds since the first call
+    static int64_t now();
+
+    static void record(const char *name, const char *category, const int64_t &begin, const int64_t &end);
+    static void instant(const char *name, const char *category);
+
+    // moves all recorded events of all threads into the file, returns the number of written events
+    // (without the thread name records)
+    static std::size_t writeChromeTrace(const std::string &filename);
+    // drops all recorded events
+    static void clear();
+    static std::size_t getNumberOfDroppedEvents();
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// TmcTraceScope
+// records the lifetime of the object as complete event
+//////////////////////////////////////////////////////////////////////////
+class TmcTraceScope
+{
+public:
+    TmcTraceScope(const char *name, const char *category)
+        : name(name), category(category), begin(TmcTrace::isEnabled() ? TmcTrace::now() : -1)
+    {
+    }
+    ~TmcTraceScope()
+    {
+        if (begin >= 0)
+            TmcTrace::record(name, category, begin, TmcTrace::now());
+    }
+
+private:
+    TmcTraceScope(const TmcTraceScope &);
+    TmcTraceScope &operator=(const TmcTraceScope &);
+
+    const char *name;
+    const char *category;
+    const int64_t begin;
+};
+
+#define TMC_TRACE_CONCAT_IMPL(a, b) a##b
+#define TMC_TRACE_CONCAT(a, b) TMC_TRACE_CONCAT_IMPL(a, b)
+
+#ifndef TMC_NO_TRACE
+#define TMC_TRACE_SCOPE(name, category) TmcTraceScope TMC_TRACE_CONCAT(tmcTraceScope, __LINE__)(name, category)
+#define TMC_TRACE_INSTANT(name, category) \
+    if (!TmcTrace::isEnabled())           \
+        ;                                 \
+    else                                  \
+        TmcTrace::instant(name, category)
+#else
+#define TMC_TRACE_SCOPE(name, category)
+#define TMC_TRACE_INSTANT(name, category)
+#endif
+
+#endif // TMCTRACE_H
@@ -0,0 +1,216 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    aligned allocation, huge pages and arenas for algebra storage
+
+\*---------------------------------------------------------------------------*/
+
+#include "./LaAllocator.h"
+
+#include <common/utilities/TmcException.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    std::atomic<bool> hugePages(true);
+    std::atomic<std::size_t> hugePageThreshold(4 * 1024 * 1024);
+
+    inline std::size_t alignUp(std::size_t value, std::size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+/*============================================================*/
+void *LaAllocator::allocate(std::size_t bytes)
+{
+    if (bytes == 0)
+        bytes = ALIGNMENT;
+
+    const bool large = bytes >= hugePageThreshold.load(std::memory_order_relaxed);
+    const std::size_t alignment = large ? (std::size_t)HUGE_PAGE_SIZE : (std::size_t)ALIGNMENT;
+    const std::size_t size = alignUp(bytes, alignment);
+
+    void *pointer = NULL;
+#if defined(_WIN32) || defined(_WIN64)
+    pointer = _aligned_malloc(size, alignment);
+#else
+    if (posix_memalign(&pointer, alignment, size) != 0)
+        pointer = NULL;
+#endif
+    if (!pointer)
+        throw std::bad_alloc();
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // only an advice, the kernel may ignore it (THP disabled)
+    if (large && hugePages.load(std::memory_order_relaxed))
+        madvise(pointer, size, MADV_HUGEPAGE);
+#endif
+    return pointer;
+}
+/*============================================================*/
+void LaAllocator::deallocate(void *pointer)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    _aligned_free(pointer);
+#else
+    free(pointer);
+#endif
+}
+/*============================================================*/
+void LaAllocator::setHugePages(bool enabled)
+{
+    hugePages.store(enabled);
+}
+/*============================================================*/
+bool LaAllocator::getHugePages()
+{
+    return hugePages.load();
+}
+/*============================================================*/
+void LaAllocator::setHugePageThreshold(std::size_t bytes)
+{
+    hugePageThreshold.store(bytes);
+}
+/*============================================================*/
+std::size_t LaAllocator::getHugePageThreshold()
+{
+    return hugePageThreshold.load();
+}
+
+/*============================================================*/
+/*  LaArena                                                   */
+/*                                                            */
+LaArena::LaArena(std::size_t blockSize)
+    : current(0), offset(0), blockSize(alignUp(blockSize > 0 ? blockSize : 1, LaAllocator::ALIGNMENT))
+{
+}
+/*============================================================*/
+LaArena::~LaArena()
+{
+    for (size_t i = 0; i < this->blocks.size(); i++)
+        LaAllocator::deallocate(this->blocks[i].data);
+}
+/*============================================================*/
+void *LaArena::allocate(std::size_t bytes)
+{
+    bytes = alignUp(bytes > 0 ? bytes : 1, LaAllocator::ALIGNMENT);
+
+    while (this->current < this->blocks.size())
+    {
+        Block &block = this->blocks[this->current];
+        if (this->offset + bytes <= block.size)
+        {
+            char *pointer = block.data + this->offset;
+            this->offset += bytes;
+            return pointer;
+        }
+        if (this->current + 1 == this->blocks.size())
+            break;
+        this->current++;
+        this->offset = 0;
+    }
+
+    // no block left which is large enough
+    Block block;
+    block.size = bytes > this->blockSize ? bytes : this->blockSize;
+    block.data = LaAllocator::allocate<char>(block.size);
+    if (this->current < this->blocks.size() && this->offset == 0 && this->blocks[this->current].size < bytes)
+    {
+        // the current block is unused but too small, replace it
+        LaAllocator::deallocate(this->blocks[this->current].data);
+        this->blocks[this->current] = block;
+    }
+    else
+    {
+        this->blocks.push_back(block);
+        this->current = this->blocks.size() - 1;
+    }
+    this->offset = bytes;
+    return block.data;
+}
+/*============================================================*/
+LaArena::Mark LaArena::mark() const
+{
+    Mark m;
+    m.block = this->current;
+    m.offset = this->offset;
+    return m;
+}
+/*============================================================*/
+void LaArena::release(const Mark &mark)
+{
+    if (mark.block > this->current || (mark.block == this->current && mark.offset > this->offset))
+        throw TmcException(UB_EXARGS, "LaArena::release() - mark is newer than the current state");
+    this->current = mark.block;
+    this->offset = mark.offset;
+}
+/*============================================================*/
+void LaArena::reset()
+{
+    this->current = 0;
+    this->offset = 0;
+}
+/*============================================================*/
+std::size_t LaArena::getUsedBytes() const
+{
+    std::size_t used = this->offset;
+    for (size_t i = 0; i < this->current && i < this->blocks.size(); i++)
+        used += this->blocks[i].size;
+    return used;
+}
+/*============================================================*/
+std::size_t LaArena::getCapacity() const
+{
+    std::size_t capacity = 0;
+    for (size_t i = 0; i < this->blocks.size(); i++)
+        capacity += this->blocks[i].size;
+    return capacity;
+}
+/*============================================================*/
+LaArena &LaArena::local()
+{
+    thread_local LaArena arena;
+    return arena;
+}
@@ -0,0 +1,179 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    aligned allocation, huge pages and arenas for algebra storage
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LAALLOCATOR_H
+#define LAALLOCATOR_H
+
+#include <cstddef>
+#include <vector>
+
+#include <TmcMacroFile.h>
+
+/**
+  Storage policy of tmcAlgebra.
+  <BR><BR>
+  All buffers are aligned to 64 bytes (cache line, AVX-512). Buffers of at least
+  getHugePageThreshold() bytes are aligned to 2 MB and, if huge pages are enabled, marked for
+  transparent huge pages (madvise on Linux), which reduces the TLB misses when large dense
+  matrices are traversed. Memory from allocate() is not initialized.
+*/
+class TMC_DLL_EXPORT LaAllocator
+{
+public:
+    enum
+    {
+        ALIGNMENT = 64,
+        HUGE_PAGE_SIZE = 2 * 1024 * 1024
+    };
+
+    static void *allocate(std::size_t bytes);
+    static void deallocate(void *pointer);
+
+    template <typename T>
+    static T *allocate(std::size_t count)
+    {
+        return static_cast<T *>(LaAllocator::allocate(count * sizeof(T)));
+    }
+
+    /**
+      Enables or disables the huge page advice for large buffers (default: enabled).
+    */
+    static void setHugePages(bool enabled);
+    static bool getHugePages();
+    /**
+      Minimal buffer size in bytes for huge page treatment (default: 4 MB).
+    */
+    static void setHugePageThreshold(std::size_t bytes);
+    static std::size_t getHugePageThreshold();
+};
+
+/**
+  Bump allocator for temporaries.
+  <BR><BR>
+  Memory is taken from large blocks and handed out by advancing an offset, so an allocation
+  costs a few instructions and no lock. Nothing is freed individually: release() rewinds to a
+  mark, reset() rewinds everything, the blocks are kept and reused. Every thread has its own
+  arena (local()), parallel sweeps do not contend for the heap.
+  <BR><BR>
+  Example:
+  <PRE>
+    LaArenaScope scope;                                  //rewinds at the end of the block
+    double *scratch = scope.allocate<double>(dimension); //64 byte aligned
+  </PRE>
+*/
+class TMC_DLL_EXPORT LaArena
+{
+public:
+    struct Mark
+    {
+        std::size_t block;
+        std::size_t offset;
+    };
+
+public:
+    explicit LaArena(std::size_t blockSize = 1 << 20);
+    ~LaArena();
+
+    void *allocate(std::size_t bytes);
+    template <typename T>
+    T *allocate(std::size_t count)
+    {
+        return static_cast<T *>(this->allocate(count * sizeof(T)));
+    }
+
+    Mark mark() const;
+    void release(const Mark &mark);
+    void reset();
+
+    std::size_t getUsedBytes() const;
+    std::size_t getCapacity() const;
+
+    /**
+      Arena of the calling thread.
+    */
+    static LaArena &local();
+
+private:
+    LaArena(const LaArena &);
+    LaArena &operator=(const LaArena &);
+
+    struct Block
+    {
+        char *data;
+        std::size_t size;
+    };
+    std::vector<Block> blocks;
+    std::size_t current;
+    std::size_t offset;
+    std::size_t blockSize;
+};
+
+/**
+  Rewinds an arena to the state at construction when it goes out of scope.
+*/
+class LaArenaScope
+{
+public:
+    explicit LaArenaScope(LaArena &arena = LaArena::local()) : arena(arena), start(arena.mark()) {}
+    // a mark newer than the arena (reset() inside the scope) is ignored, the arena is rewound already
+    ~LaArenaScope()
+    {
+        try
+        {
+            this->arena.release(this->start);
+        }
+        catch (...)
+        {
+        }
+    }
+
+    template <typename T>
+    T *allocate(std::size_t count)
+    {
+        return this->arena.allocate<T>(count);
+    }
+    LaArena &getArena() { return this->arena; }
+
+private:
+    LaArenaScope(const LaArenaScope &);
+    LaArenaScope &operator=(const LaArenaScope &);
+
+    LaArena &arena;
+    LaArena::Mark start;
+};
+
+#endif
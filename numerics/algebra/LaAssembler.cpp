@@ -0,0 +1,244 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    parallel assembly of element matrices
+
+\*---------------------------------------------------------------------------*/
+
+#include "./LaAssembler.h"
+
+#include "./LaSparseMatrix.h"
+#include "./LaSquareMatrix.h"
+
+#include <common/utilities/TmcException.h>
+#include <common/utilities/TmcTrace.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+// below this number of element matrix entries the threads cost more than they save
+static const long LAASSEMBLER_PARALLEL_ENTRIES = 100000;
+
+/*======================================================================*/
+LaAssembler::LaAssembler(int dimension) : dimension(dimension), threadNumber(0), maxCount(0), elementstart(1, 0), colored(false) {}
+/*======================================================================*/
+int LaAssembler::addElement(const int *indices, int count)
+{
+    for (int i = 0; i < count; i++)
+        if (indices[i] < 0 || indices[i] >= this->dimension)
+            throw TmcException(UB_EXARGS, "LaAssembler - index out of range");
+    this->elementindex.insert(this->elementindex.end(), indices, indices + count);
+    this->elementstart.push_back((int)this->elementindex.size());
+    this->maxCount = std::max(this->maxCount, count);
+    this->colored = false;
+    return this->getElementNumber() - 1;
+}
+/*======================================================================*/
+int LaAssembler::getColorNumber()
+{
+    this->color();
+    return (int)this->colorstart.size() - 1;
+}
+/*======================================================================*/
+// greedy: every element gets the smallest color which no element with a common degree of freedom has
+void LaAssembler::color()
+{
+    if (this->colored)
+        return;
+    const int elements = this->getElementNumber();
+    vector<vector<int> > used(this->dimension);
+    vector<int> elementcolor(elements);
+    vector<int> mark;
+    int colors = 0;
+    for (int e = 0; e < elements; e++)
+    {
+        for (int k = this->elementstart[e]; k < this->elementstart[e + 1]; k++)
+            for (size_t c = 0; c < used[this->elementindex[k]].size(); c++)
+                mark[used[this->elementindex[k]][c]] = e + 1;
+        int c = 0;
+        while (c < colors && mark[c] == e + 1)
+            c++;
+        if (c == colors)
+        {
+            colors++;
+            mark.push_back(0);
+        }
+        elementcolor[e] = c;
+        for (int k = this->elementstart[e]; k < this->elementstart[e + 1]; k++)
+            used[this->elementindex[k]].push_back(c);
+    }
+
+    this->colorstart.assign(colors + 1, 0);
+    for (int e = 0; e < elements; e++)
+        this->colorstart[elementcolor[e] + 1]++;
+    for (int c = 0; c < colors; c++)
+        this->colorstart[c + 1] += this->colorstart[c];
+    this->colorelement.resize(elements);
+    vector<int> next(this->colorstart.begin(), this->colorstart.end() - 1);
+    for (int e = 0; e < elements; e++)
+        this->colorelement[next[elementcolor[e]]++] = e;
+    this->colored = true;
+}
+/*======================================================================*/
+int LaAssembler::getThreads() const
+{
+    long entries = 0;
+    for (int e = 0; e < this->getElementNumber(); e++)
+    {
+        const long count = this->elementstart[e + 1] - this->elementstart[e];
+        entries += count * count;
+    }
+    if (entries < LAASSEMBLER_PARALLEL_ENTRIES)
+        return 1;
+    const int threads = this->threadNumber > 0 ? this->threadNumber : (int)std::thread::hardware_concurrency();
+    return std::max(1, threads);
+}
+/*======================================================================*/
+void LaAssembler::run(const ElementMatrix &elementMatrix, const std::function<bool(int, const double *)> &add)
+{
+    this->color();
+    std::atomic<bool> inPattern(true);
+    // the first exception of a thread, it is thrown again after all threads are joined
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    std::atomic<bool> failed(false);
+    const int threads = this->getThreads();
+    for (int c = 0; c + 1 < (int)this->colorstart.size(); c++)
+    {
+        const int begin = this->colorstart[c];
+        const int end = this->colorstart[c + 1];
+        const int used = std::min(threads, end - begin);
+        // contiguous blocks of the color, no element is assembled by two threads
+        auto fail = [&](std::exception_ptr exception) {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure)
+                failure = exception;
+            failed = true;
+        };
+        auto worker = [&](int thread) {
+            try
+            {
+                vector<double> matrix((size_t)this->maxCount * this->maxCount);
+                const int first = begin + (int)((long)(end - begin) * thread / used);
+                const int last = begin + (int)((long)(end - begin) * (thread + 1) / used);
+                for (int k = first; k < last && !failed; k++)
+                {
+                    const int e = this->colorelement[k];
+                    elementMatrix(e, matrix.data());
+                    if (!add(e, matrix.data()))
+                        inPattern = false;
+                }
+            }
+            catch (...)
+            {
+                fail(std::current_exception());
+            }
+        };
+        vector<std::thread> pool;
+        try
+        {
+            for (int t = 1; t < used; t++)
+                pool.push_back(std::thread(worker, t));
+        }
+        catch (...)
+        {
+            fail(std::current_exception());
+        }
+        if (!failed)
+            worker(0);
+        for (size_t t = 0; t < pool.size(); t++)
+            pool[t].join();
+        if (failure)
+            std::rethrow_exception(failure);
+    }
+    if (!inPattern)
+        throw TmcException(UB_EXARGS, "LaAssembler - an entry of an element is not in the pattern of the sparse matrix");
+}
+/*======================================================================*/
+void LaAssembler::assemble(LaSquareMatrix &matrix, const ElementMatrix &elementMatrix)
+{
+    TMC_TRACE_SCOPE("dense assembly", "algebra");
+    if (matrix.getRowNumber() != this->dimension)
+        throw TmcException(UB_EXARGS, "LaAssembler - the dimension of the matrix does not fit");
+    // written through the view, the cached properties are discarded once
+    const LaMatrixView a = matrix.view();
+    this->run(elementMatrix, [&](int e, const double *element) {
+        const int *index = this->elementindex.data() + this->elementstart[e];
+        const int count = this->elementstart[e + 1] - this->elementstart[e];
+        for (int i = 0; i < count; i++)
+            for (int j = 0; j < count; j++)
+                a(index[i], index[j]) += element[i * count + j];
+        return true;
+    });
+    matrix.setValuesChanged();
+}
+/*======================================================================*/
+void LaAssembler::assemble(LaSparseMatrix &matrix, const ElementMatrix &elementMatrix)
+{
+    TMC_TRACE_SCOPE("sparse assembly", "algebra");
+    if (matrix.getRowNumber() != this->dimension)
+        throw TmcException(UB_EXARGS, "LaAssembler - the dimension of the matrix does not fit");
+    if (matrix.getNonZeros() == 0 && matrix.isCompressed())
+        matrix = this->createSparseMatrix(matrix.getName());
+    matrix.compress();
+    double *values = matrix.values();
+    this->run(elementMatrix, [&](int e, const double *element) {
+        const int *index = this->elementindex.data() + this->elementstart[e];
+        const int count = this->elementstart[e + 1] - this->elementstart[e];
+        for (int i = 0; i < count; i++)
+            for (int j = 0; j < count; j++)
+            {
+                const int position = matrix.getPosition(index[i], index[j]);
+                if (position < 0)
+                    return false;
+                values[position] += element[i * count + j];
+            }
+        return true;
+    });
+}
+/*======================================================================*/
+LaSparseMatrix LaAssembler::createSparseMatrix(std::string name) const
+{
+    LaSparseMatrix matrix(this->dimension, name);
+    for (int e = 0; e < this->getElementNumber(); e++)
+        for (int i = this->elementstart[e]; i < this->elementstart[e + 1]; i++)
+            for (int j = this->elementstart[e]; j < this->elementstart[e + 1]; j++)
+                matrix.addValue(this->elementindex[i], this->elementindex[j], 0.0);
+    matrix.compress();
+    return matrix;
+}
@@ -0,0 +1,120 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    parallel assembly of element matrices
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LAASSEMBLER_H
+#define LAASSEMBLER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <TmcMacroFile.h>
+
+class LaSparseMatrix;
+class LaSquareMatrix;
+
+/**
+  Assembly of element matrices into a global matrix with several threads.
+  <BR><BR>
+  The elements are colored greedily in the order they were added: elements of one color share
+  no degree of freedom, so the threads assemble the elements of a color without locks and
+  without private buffers. Every global entry receives its contributions in the order of the
+  colors, the result does not depend on the number of threads.
+  The element matrices are computed by the threads as well, the function must be thread safe.
+  An exception of the function stops the assembly, assemble() throws it again once all threads
+  have finished (the matrix is left partly assembled).
+  Dense and sparse storage are supported, a banded system is a dense matrix whose band is
+  detected by LaMatrixStructure.
+  <BR><BR>
+  Example:
+  <PRE>
+    LaAssembler assembler(n);
+    for (int e = 0; e < elements; e++)
+        assembler.addElement(indices[e], 4);
+    LaSparseMatrix k = assembler.createSparseMatrix("K");
+    assembler.assemble(k, [&](int e, double *ke) { computeElementMatrix(e, ke); }); //row-major 4 x 4
+  </PRE>
+*/
+class TMC_DLL_EXPORT LaAssembler
+{
+public:
+    /** computes the row-major matrix of the element, count x count values */
+    typedef std::function<void(int element, double *matrix)> ElementMatrix;
+
+public:
+    explicit LaAssembler(int dimension);
+
+    /**
+      @param indices the global degrees of freedom of the element
+      @return the index of the element
+    */
+    int addElement(const int *indices, int count);
+
+    int getDimension() const { return this->dimension; }
+    int getElementNumber() const { return (int)this->elementstart.size() - 1; }
+    int getColorNumber();
+    /** number of threads, 0 (default): one per hardware thread */
+    void setThreadNumber(int threads) { this->threadNumber = threads; }
+
+    /** the element matrices are added to the matrix */
+    void assemble(LaSquareMatrix &matrix, const ElementMatrix &elementMatrix);
+    /**
+      The element matrices are added to the matrix. An empty matrix gets the pattern of the
+      elements, otherwise the pattern has to contain all entries of the elements.
+    */
+    void assemble(LaSparseMatrix &matrix, const ElementMatrix &elementMatrix);
+
+    /** a compressed matrix with the pattern of the elements and zero values */
+    LaSparseMatrix createSparseMatrix(std::string name = "") const;
+
+private:
+    void color();
+    int getThreads() const;
+    /** calls add(element, matrix) for all elements, color by color */
+    void run(const ElementMatrix &elementMatrix, const std::function<bool(int, const double *)> &add);
+
+    int dimension;
+    int threadNumber;
+    int maxCount;
+    std::vector<int> elementstart;
+    std::vector<int> elementindex;
+    bool colored;
+    std::vector<int> colorstart;
+    std::vector<int> colorelement;
+};
+
+#endif
@@ -0,0 +1,252 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    binary, memory mappable file format for vectors and matrices
+
+\*---------------------------------------------------------------------------*/
+
+#include "./LaBinaryFormat.h"
+
+#include <common/utilities/TmcException.h>
+#include <common/utilities/TmcFileInputBinary.h>
+#include <common/utilities/TmcFileOutputBinary.h>
+#include <common/utilities/TmcSystem.h>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+static const char LABINARYFORMAT_MAGIC[8] = {'T', 'M', 'C', 'L', 'A', 'B', 'I', 'N'};
+static const uint32_t LABINARYFORMAT_ENDIANNESS = 0x01020304;
+static const uint32_t LABINARYFORMAT_ENDIANNESS_SWAPPED = 0x04030201;
+
+/*============================================================*/
+void LaBinaryFormat::writeHeader(TmcFileOutputBinary *out, const std::string &name, STORAGE storage, uint64_t rows, uint64_t columns, uint64_t checksum)
+{
+    if (out == NULL)
+        throw TmcException(UB_EXARGS, "null output-stream");
+
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, LABINARYFORMAT_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.endianness = LABINARYFORMAT_ENDIANNESS;
+    header.storage = storage;
+    header.rows = rows;
+    header.columns = columns;
+    header.payloadOffset = PAGE_SIZE;
+    header.payloadBytes = rows * columns * sizeof(double);
+    header.checksum = checksum;
+    std::strncpy(header.name, name.c_str(), NAME_LENGTH - 1);
+
+    vector<char> page(PAGE_SIZE, 0);
+    std::memcpy(&page[0], &header, sizeof(Header));
+    out->writeBlock(&page[0], page.size());
+}
+/*============================================================*/
+void LaBinaryFormat::writePayload(TmcFileOutputBinary *out, const double *values, uint64_t count)
+{
+    out->writeBlock((const char *)values, count * sizeof(double));
+}
+/*============================================================*/
+bool LaBinaryFormat::readHeader(TmcFileInputBinary *in, Header &header)
+{
+    if (in == NULL)
+        throw TmcException(UB_EXARGS, "null input-stream");
+
+    in->readBlock((char *)&header, sizeof(Header));
+    if (!(*in))
+        throw TmcException(UB_EXARGS, "error while reading header of " + in->getFileName());
+    if (std::memcmp(header.magic, LABINARYFORMAT_MAGIC, sizeof(header.magic)) != 0)
+        throw TmcException(UB_EXARGS, in->getFileName() + " is no tmc algebra binary file");
+
+    bool swap = false;
+    if (header.endianness == LABINARYFORMAT_ENDIANNESS_SWAPPED)
+    {
+        swap = true;
+        LaBinaryFormat::swapHeader(header);
+    }
+    else if (header.endianness != LABINARYFORMAT_ENDIANNESS)
+        throw TmcException(UB_EXARGS, "invalid byte order tag in " + in->getFileName());
+
+    if (header.version > VERSION)
+        throw TmcException(UB_EXARGS, "unsupported version " + TmcSystem::toString(header.version) + " of " + in->getFileName());
+    if (header.payloadBytes != header.rows * header.columns * sizeof(double))
+        throw TmcException(UB_EXARGS, "inconsistent payload size in " + in->getFileName());
+    header.name[NAME_LENGTH - 1] = '\0';
+
+    in->seekg((std::fstream::off_type)header.payloadOffset);
+    return swap;
+}
+/*============================================================*/
+uint64_t LaBinaryFormat::readPayload(TmcFileInputBinary *in, double *values, uint64_t count, bool swap, uint64_t seed)
+{
+    in->readBlock((char *)values, count * sizeof(double));
+    if (!(*in))
+        throw TmcException(UB_EXARGS, "unexpected end of file " + in->getFileName());
+
+    // the checksum belongs to the bytes in the file
+    const uint64_t hash = LaBinaryFormat::checksum(values, count, seed);
+    if (swap)
+        for (uint64_t i = 0; i < count; i++)
+            TmcSystem::swapByteOrder((unsigned char *)&values[i], sizeof(double));
+    return hash;
+}
+/*============================================================*/
+uint64_t LaBinaryFormat::checksum(const double *values, uint64_t count, uint64_t seed)
+{
+    const unsigned char *bytes = (const unsigned char *)values;
+    uint64_t hash = seed;
+    for (uint64_t i = 0; i < count; i++)
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes + i * sizeof(double), sizeof(uint64_t));
+        hash ^= word;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+/*============================================================*/
+void LaBinaryFormat::swapHeader(Header &header)
+{
+    TmcSystem::swapByteOrder((unsigned char *)&header.version, sizeof(header.version));
+    TmcSystem::swapByteOrder((unsigned char *)&header.endianness, sizeof(header.endianness));
+    TmcSystem::swapByteOrder((unsigned char *)&header.storage, sizeof(header.storage));
+    TmcSystem::swapByteOrder((unsigned char *)&header.reserved, sizeof(header.reserved));
+    TmcSystem::swapByteOrder((unsigned char *)&header.rows, sizeof(header.rows));
+    TmcSystem::swapByteOrder((unsigned char *)&header.columns, sizeof(header.columns));
+    TmcSystem::swapByteOrder((unsigned char *)&header.payloadOffset, sizeof(header.payloadOffset));
+    TmcSystem::swapByteOrder((unsigned char *)&header.payloadBytes, sizeof(header.payloadBytes));
+    TmcSystem::swapByteOrder((unsigned char *)&header.checksum, sizeof(header.checksum));
+}
+
+/*============================================================*/
+/*  LaMappedArray                                             */
+/*                                                            */
+struct LaMappedArray::Mapping
+{
+    boost::iostreams::mapped_file_source file;
+};
+/*============================================================*/
+LaMappedArray::LaMappedArray() : mapping(NULL), values(NULL)
+{
+    std::memset(&this->header, 0, sizeof(LaBinaryFormat::Header));
+}
+/*============================================================*/
+LaMappedArray::LaMappedArray(const std::string &filename) : mapping(NULL), values(NULL)
+{
+    std::memset(&this->header, 0, sizeof(LaBinaryFormat::Header));
+    this->open(filename);
+}
+/*============================================================*/
+LaMappedArray::~LaMappedArray()
+{
+    this->close();
+}
+/*============================================================*/
+void LaMappedArray::open(const std::string &filename)
+{
+    this->close();
+    this->mapping = new Mapping;
+    try
+    {
+        this->mapping->file.open(filename);
+    }
+    catch (std::exception &e)
+    {
+        this->close();
+        throw TmcException(UB_EXARGS, "couldn't map file " + filename + ": " + e.what());
+    }
+
+    const char *base = this->mapping->file.data();
+    if (this->mapping->file.size() < sizeof(LaBinaryFormat::Header) || std::memcmp(base, LABINARYFORMAT_MAGIC, sizeof(LABINARYFORMAT_MAGIC)) != 0)
+    {
+        this->close();
+        throw TmcException(UB_EXARGS, filename + " is no tmc algebra binary file");
+    }
+    std::memcpy(&this->header, base, sizeof(LaBinaryFormat::Header));
+    this->header.name[LaBinaryFormat::NAME_LENGTH - 1] = '\0';
+    if (this->header.endianness != LABINARYFORMAT_ENDIANNESS)
+    {
+        this->close();
+        throw TmcException(UB_EXARGS, filename + " has a different byte order, use LaSquareMatrix::read or LaVector::read instead");
+    }
+    if (this->header.payloadOffset + this->header.payloadBytes > this->mapping->file.size())
+    {
+        this->close();
+        throw TmcException(UB_EXARGS, filename + " is truncated");
+    }
+    this->values = (const double *)(base + this->header.payloadOffset);
+}
+/*============================================================*/
+void LaMappedArray::close()
+{
+    delete this->mapping;
+    this->mapping = NULL;
+    this->values = NULL;
+}
+/*============================================================*/
+bool LaMappedArray::isOpen() const
+{
+    return this->values != NULL;
+}
+/*============================================================*/
+std::string LaMappedArray::getName() const
+{
+    return std::string(this->header.name);
+}
+/*============================================================*/
+LaBinaryFormat::STORAGE LaMappedArray::getStorage() const
+{
+    return (LaBinaryFormat::STORAGE)this->header.storage;
+}
+/*============================================================*/
+int LaMappedArray::getRowNumber() const
+{
+    return (int)this->header.rows;
+}
+/*============================================================*/
+int LaMappedArray::getColumnNumber() const
+{
+    return (int)this->header.columns;
+}
+/*============================================================*/
+bool LaMappedArray::verifyChecksum() const
+{
+    if (!this->values)
+        return false;
+    return LaBinaryFormat::checksum(this->values, this->header.rows * this->header.columns) == this->header.checksum;
+}
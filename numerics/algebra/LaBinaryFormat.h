@@ -0,0 +1,161 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    binary, memory mappable file format for vectors and matrices
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LABINARYFORMAT_H
+#define LABINARYFORMAT_H
+
+#include <cstdint>
+#include <string>
+
+#include <TmcMacroFile.h>
+
+class TmcFileInputBinary;
+class TmcFileOutputBinary;
+
+/**
+  Binary container for vectors and dense matrices.
+  <BR><BR>
+  Layout: a header of 128 bytes (magic, version, endianness tag, storage kind, rows, columns,
+  offset and size of the payload, checksum and name), zero padding up to the next page boundary
+  and the values as raw doubles in row-major order. The payload is page aligned, so a file can
+  be memory mapped and the values are used in place (LaMappedArray).
+  Files written on a machine with different byte order are swapped while reading.
+*/
+class TMC_DLL_EXPORT LaBinaryFormat
+{
+public:
+    enum STORAGE
+    {
+        VECTOR = 1,
+        DENSE_MATRIX = 2
+    };
+
+    enum
+    {
+        NAME_LENGTH = 64,
+        PAGE_SIZE = 4096,
+        VERSION = 1
+    };
+    static const uint64_t CHECKSUM_SEED = 14695981039346656037ULL;
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t endianness;
+        uint32_t storage;
+        uint32_t reserved;
+        uint64_t rows;
+        uint64_t columns;
+        uint64_t payloadOffset;
+        uint64_t payloadBytes;
+        uint64_t checksum;
+        char name[NAME_LENGTH];
+    };
+
+public:
+    /**
+      Writes the header and the padding, the payload has to follow with writePayload.
+      @param checksum the checksum of the payload, see checksum()
+    */
+    static void writeHeader(TmcFileOutputBinary *out, const std::string &name, STORAGE storage, uint64_t rows, uint64_t columns, uint64_t checksum);
+    static void writePayload(TmcFileOutputBinary *out, const double *values, uint64_t count);
+
+    /**
+      Reads and checks the header, afterwards the file is positioned at the payload.
+      @return true if the byte order of the file differs from the byte order of this machine
+      @exception TmcException if the file is no tmc algebra binary file
+    */
+    static bool readHeader(TmcFileInputBinary *in, Header &header);
+    /**
+      Reads count values and swaps them if necessary.
+      @return the checksum of the read bytes, continued from seed
+    */
+    static uint64_t readPayload(TmcFileInputBinary *in, double *values, uint64_t count, bool swap, uint64_t seed = CHECKSUM_SEED);
+
+    /**
+      FNV-1a like hash over 64 bit words, can be continued with the result of a previous call.
+    */
+    static uint64_t checksum(const double *values, uint64_t count, uint64_t seed = CHECKSUM_SEED);
+
+    static void swapHeader(Header &header);
+};
+
+/**
+  Read-only, zero copy access to a vector or matrix file written with LaBinaryFormat.
+  The file is mapped into memory, the values are not copied.
+  The mapping is only possible for files with the byte order of this machine.
+*/
+class TMC_DLL_EXPORT LaMappedArray
+{
+public:
+    LaMappedArray();
+    LaMappedArray(const std::string &filename);
+    ~LaMappedArray();
+
+    void open(const std::string &filename);
+    void close();
+    bool isOpen() const;
+
+    std::string getName() const;
+    LaBinaryFormat::STORAGE getStorage() const;
+    int getRowNumber() const;
+    int getColumnNumber() const;
+
+    /**
+      Returns the values in row-major order, valid until close().
+    */
+    const double *data() const { return this->values; }
+    double getValue(int row, int column) const { return this->values[(uint64_t)row * this->header.columns + column]; }
+    double getValue(int index) const { return this->values[index]; }
+
+    /**
+      Recomputes the checksum of the mapped values.
+    */
+    bool verifyChecksum() const;
+
+private:
+    LaMappedArray(const LaMappedArray &);
+    LaMappedArray &operator=(const LaMappedArray &);
+
+    struct Mapping;
+    Mapping *mapping;
+    LaBinaryFormat::Header header;
+    const double *values;
+};
+
+#endif
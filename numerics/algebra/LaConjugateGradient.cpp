@@ -0,0 +1,117 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    preconditioned conjugate gradient method
+
+\*---------------------------------------------------------------------------*/
+
+#include "./LaConjugateGradient.h"
+
+#include "./LaLinearOperator.h"
+
+#include <common/utilities/TmcTrace.h>
+
+#include <cmath>
+
+using namespace std;
+
+/*======================================================================*/
+LaConjugateGradient::LaConjugateGradient() : tolerance(1e-12), maxIterations(0), iterations(0), residual(0.0) {}
+/*======================================================================*/
+bool LaConjugateGradient::solve(const LaLinearOperator &matrix, const double *b, double *x)
+{
+    TMC_TRACE_SCOPE("conjugate gradient", "algebra");
+    const int n = matrix.getDimension();
+    this->r.resize(n);
+    this->z.resize(n);
+    this->p.resize(n);
+    this->q.resize(n);
+    this->inverseDiagonal.resize(n);
+    this->iterations = 0;
+
+    matrix.getDiagonal(this->inverseDiagonal.data());
+    for (int i = 0; i < n; i++)
+        this->inverseDiagonal[i] = this->inverseDiagonal[i] > 0.0 ? 1.0 / this->inverseDiagonal[i] : 1.0;
+
+    double normB = 0.0;
+    for (int i = 0; i < n; i++)
+        normB += b[i] * b[i];
+    normB = std::sqrt(normB);
+    if (normB == 0.0)
+    {
+        for (int i = 0; i < n; i++)
+            x[i] = 0.0;
+        this->residual = 0.0;
+        return true;
+    }
+
+    matrix.apply(x, this->q.data());
+    double rz = 0.0, rr = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        this->r[i] = b[i] - this->q[i];
+        this->z[i] = this->inverseDiagonal[i] * this->r[i];
+        this->p[i] = this->z[i];
+        rz += this->r[i] * this->z[i];
+        rr += this->r[i] * this->r[i];
+    }
+    const int limit = this->maxIterations > 0 ? this->maxIterations : n;
+    this->residual = std::sqrt(rr) / normB;
+    while (this->residual > this->tolerance && this->iterations < limit)
+    {
+        matrix.apply(this->p.data(), this->q.data());
+        double pq = 0.0;
+        for (int i = 0; i < n; i++)
+            pq += this->p[i] * this->q[i];
+        if (pq <= 0.0)
+            break; //< not positive definite
+        const double step = rz / pq;
+        double rzNew = 0.0;
+        rr = 0.0;
+        for (int i = 0; i < n; i++)
+        {
+            x[i] += step * this->p[i];
+            this->r[i] -= step * this->q[i];
+            this->z[i] = this->inverseDiagonal[i] * this->r[i];
+            rzNew += this->r[i] * this->z[i];
+            rr += this->r[i] * this->r[i];
+        }
+        const double factor = rzNew / rz;
+        rz = rzNew;
+        for (int i = 0; i < n; i++)
+            this->p[i] = this->z[i] + factor * this->p[i];
+        this->iterations++;
+        this->residual = std::sqrt(rr) / normB;
+    }
+    return this->residual <= this->tolerance;
+}
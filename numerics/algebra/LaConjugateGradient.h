@@ -0,0 +1,88 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    preconditioned conjugate gradient method
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LACONJUGATEGRADIENT_H
+#define LACONJUGATEGRADIENT_H
+
+#include <vector>
+
+#include <TmcMacroFile.h>
+
+class LaLinearOperator;
+
+/**
+  Conjugate gradient method with Jacobi preconditioner for symmetric positive definite
+  operators. The matrix is only applied, never stored, so it works with matrix-free operators.
+  <BR><BR>
+  Example:
+  <PRE>
+    LaConjugateGradient cg;
+    cg.setTolerance(1e-10);
+    if (!cg.solve(op, b, x)) //x holds the start vector
+        UBLOG(logWARNING, "no convergence after " << cg.getIterations() << " iterations");
+  </PRE>
+*/
+class TMC_DLL_EXPORT LaConjugateGradient
+{
+public:
+    LaConjugateGradient();
+
+    /** relative tolerance of the residual, |b - A x| <= tolerance |b| */
+    void setTolerance(double tolerance) { this->tolerance = tolerance; }
+    /** 0 (default): the dimension of the system */
+    void setMaxIterations(int iterations) { this->maxIterations = iterations; }
+
+    /**
+      Solves A x = b.
+      @param x the start vector on input, the solution on output
+      @return true if the tolerance is reached
+    */
+    bool solve(const LaLinearOperator &matrix, const double *b, double *x);
+
+    int getIterations() const { return this->iterations; }
+    /** relative residual of the last solve */
+    double getResidual() const { return this->residual; }
+
+private:
+    double tolerance;
+    int maxIterations;
+    int iterations;
+    double residual;
+    std::vector<double> r, z, p, q, inverseDiagonal;
+};
+
+#endif
@@ -0,0 +1,326 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    square matrix with compile-time size
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LAFIXEDMATRIX_H
+#define LAFIXEDMATRIX_H
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include <common/utilities/TmcException.h>
+
+#include "./LaFixedVector.h"
+#include "./LaSquareMatrix.h"
+
+/**
+  Square N x N matrix on the stack, stored row by row.
+  <BR><BR>
+  Counterpart of LaSquareMatrix for small systems (element matrices, single degrees of freedom):
+  no heap allocation, no property flags, no virtual functions. The products are unrolled at
+  compile time, linear systems are solved with LaFixedLU.
+  Element matrices are assembled into a dynamic matrix with addTo().
+*/
+template <int N>
+class LaFixedMatrix
+{
+public:
+    double value[N * N];
+
+    /*======================================================================*/
+    LaFixedMatrix() { this->setValues(0.0); }
+    explicit LaFixedMatrix(const double *array)
+    {
+        for (int i = 0; i < N * N; i++)
+            this->value[i] = array[i];
+    }
+    /**
+      Copies the upper left N x N block of a dynamic matrix.
+    */
+    explicit LaFixedMatrix(LaSquareMatrix *matrix)
+    {
+        if (matrix->getDimension() < N)
+            throw TmcException(UB_EXARGS, "LaFixedMatrix(): matrix too small");
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++)
+                this->value[i * N + j] = matrix->getValue(i, j);
+    }
+    static LaFixedMatrix identity()
+    {
+        LaFixedMatrix matrix;
+        for (int i = 0; i < N; i++)
+            matrix.value[i * N + i] = 1.0;
+        return matrix;
+    }
+
+    /*======================================================================*/
+    int getDimension() const { return N; }
+    double getValue(int row, int column) const { return this->value[row * N + column]; }
+    void setValue(int row, int column, double a) { this->value[row * N + column] = a; }
+    void addValue(int row, int column, double a) { this->value[row * N + column] += a; }
+    double &operator()(int row, int column) { return this->value[row * N + column]; }
+    const double &operator()(int row, int column) const { return this->value[row * N + column]; }
+
+    void setValues(double a)
+    {
+        auto f = [this, a](int i) { this->value[i] = a; };
+        LaFixedUnroll<0, N * N>::apply(f);
+    }
+    void multiplyValue(double a)
+    {
+        auto f = [this, a](int i) { this->value[i] *= a; };
+        LaFixedUnroll<0, N * N>::apply(f);
+    }
+    /**
+      this += factor * matrix
+    */
+    void add(const LaFixedMatrix &matrix, double factor = 1.0)
+    {
+        auto f = [this, &matrix, factor](int i) { this->value[i] += factor * matrix.value[i]; };
+        LaFixedUnroll<0, N * N>::apply(f);
+    }
+
+    /*======================================================================*/
+    LaFixedVector<N> multiply(const LaFixedVector<N> &vector) const
+    {
+        LaFixedVector<N> result;
+        auto row = [this, &vector, &result](int i) {
+            double sum = 0.0;
+            auto column = [this, &vector, &sum, i](int j) { sum += this->value[i * N + j] * vector.value[j]; };
+            LaFixedUnroll<0, N>::apply(column);
+            result.value[i] = sum;
+        };
+        LaFixedUnroll<0, N>::apply(row);
+        return result;
+    }
+    LaFixedMatrix multiply(const LaFixedMatrix &matrix) const
+    {
+        LaFixedMatrix result;
+        auto row = [this, &matrix, &result](int i) {
+            auto column = [this, &matrix, &result, i](int j) {
+                double sum = 0.0;
+                auto k = [this, &matrix, &sum, i, j](int l) { sum += this->value[i * N + l] * matrix.value[l * N + j]; };
+                LaFixedUnroll<0, N>::apply(k);
+                result.value[i * N + j] = sum;
+            };
+            LaFixedUnroll<0, N>::apply(column);
+        };
+        LaFixedUnroll<0, N>::apply(row);
+        return result;
+    }
+    LaFixedMatrix transpose() const
+    {
+        LaFixedMatrix result;
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++)
+                result.value[j * N + i] = this->value[i * N + j];
+        return result;
+    }
+
+    double determinant() const;
+    LaFixedVector<N> solveLinearEquation(const LaFixedVector<N> &vector) const;
+    LaFixedMatrix inverse() const;
+
+    /*======================================================================*/
+    /**
+      Adds the matrix to the rows and columns indices[0..N-1] of a dynamic matrix (assembly).
+    */
+    void addTo(LaSquareMatrix *matrix, const int *indices) const
+    {
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++)
+                matrix->addValue(indices[i], indices[j], this->value[i * N + j]);
+    }
+    /**
+      Adds the matrix to the block starting at row and column offset of a dynamic matrix.
+    */
+    void addTo(LaSquareMatrix *matrix, int offset) const
+    {
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++)
+                matrix->addValue(offset + i, offset + j, this->value[i * N + j]);
+    }
+    LaSquareMatrix *toSquareMatrix(std::string name = "LaFixedMatrix") const
+    {
+        LaSquareMatrix *matrix = new LaSquareMatrix(N, name);
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++)
+                matrix->setValue(i, j, this->value[i * N + j]);
+        return matrix;
+    }
+
+    std::string toString() const
+    {
+        std::stringstream ss;
+        ss << "LaFixedMatrix<" << N << ">[";
+        for (int i = 0; i < N; i++)
+        {
+            ss << (i > 0 ? "; " : "");
+            for (int j = 0; j < N; j++)
+                ss << (j > 0 ? ", " : "") << this->value[i * N + j];
+        }
+        ss << "]";
+        return ss.str();
+    }
+};
+
+/**
+  LU decomposition with partial pivoting of a LaFixedMatrix, the factorization can be reused
+  for several right hand sides.
+*/
+template <int N>
+class LaFixedLU
+{
+public:
+    explicit LaFixedLU(const LaFixedMatrix<N> &matrix) : lu(matrix), rowinterchanges(1), singular(false)
+    {
+        for (int j = 0; j < N; j++)
+        {
+            int pivot = j;
+            double big = std::fabs(this->lu.value[j * N + j]);
+            for (int i = j + 1; i < N; i++)
+            {
+                if (std::fabs(this->lu.value[i * N + j]) > big)
+                {
+                    big = std::fabs(this->lu.value[i * N + j]);
+                    pivot = i;
+                }
+            }
+            if (big == 0.0)
+            {
+                this->singular = true;
+                return;
+            }
+            this->permutations[j] = pivot;
+            if (pivot != j)
+            {
+                for (int k = 0; k < N; k++)
+                {
+                    const double dum = this->lu.value[pivot * N + k];
+                    this->lu.value[pivot * N + k] = this->lu.value[j * N + k];
+                    this->lu.value[j * N + k] = dum;
+                }
+                this->rowinterchanges = -this->rowinterchanges;
+            }
+            const double dum = 1.0 / this->lu.value[j * N + j];
+            for (int i = j + 1; i < N; i++)
+            {
+                const double factor = (this->lu.value[i * N + j] *= dum);
+                for (int k = j + 1; k < N; k++)
+                    this->lu.value[i * N + k] -= factor * this->lu.value[j * N + k];
+            }
+        }
+    }
+
+    /**
+      @exception TmcException if the matrix is singular
+    */
+    LaFixedVector<N> solve(const LaFixedVector<N> &vector) const
+    {
+        if (this->singular)
+            throw TmcException(UB_EXARGS, "LaFixedLU.solve(): Matrix is singular");
+        LaFixedVector<N> x(vector);
+        for (int i = 0; i < N; i++)
+        {
+            const int p = this->permutations[i];
+            if (p != i)
+            {
+                const double dum = x.value[p];
+                x.value[p] = x.value[i];
+                x.value[i] = dum;
+            }
+            for (int j = 0; j < i; j++)
+                x.value[i] -= this->lu.value[i * N + j] * x.value[j];
+        }
+        for (int i = N - 1; i >= 0; i--)
+        {
+            for (int j = i + 1; j < N; j++)
+                x.value[i] -= this->lu.value[i * N + j] * x.value[j];
+            x.value[i] /= this->lu.value[i * N + i];
+        }
+        return x;
+    }
+
+    bool isSingular() const { return this->singular; }
+    double determinant() const
+    {
+        if (this->singular)
+            return 0.0;
+        double d = (double)this->rowinterchanges;
+        for (int i = 0; i < N; i++)
+            d *= this->lu.value[i * N + i];
+        return d;
+    }
+
+    const LaFixedMatrix<N> &getLUMatrix() const { return this->lu; }
+
+private:
+    LaFixedMatrix<N> lu;
+    int permutations[N];
+    int rowinterchanges;
+    bool singular;
+};
+
+/*======================================================================*/
+template <int N>
+double LaFixedMatrix<N>::determinant() const
+{
+    return LaFixedLU<N>(*this).determinant();
+}
+/*======================================================================*/
+template <int N>
+LaFixedVector<N> LaFixedMatrix<N>::solveLinearEquation(const LaFixedVector<N> &vector) const
+{
+    return LaFixedLU<N>(*this).solve(vector);
+}
+/*======================================================================*/
+template <int N>
+LaFixedMatrix<N> LaFixedMatrix<N>::inverse() const
+{
+    const LaFixedLU<N> lu(*this);
+    LaFixedMatrix<N> result;
+    for (int j = 0; j < N; j++)
+    {
+        LaFixedVector<N> e;
+        e.value[j] = 1.0;
+        const LaFixedVector<N> column = lu.solve(e);
+        for (int i = 0; i < N; i++)
+            result.value[i * N + j] = column.value[i];
+    }
+    return result;
+}
+#endif
@@ -0,0 +1,171 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    vector with compile-time size
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LAFIXEDVECTOR_H
+#define LAFIXEDVECTOR_H
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include <common/utilities/TmcException.h>
+
+#include "./LaVector.h"
+
+/**
+  Calls f(I), f(I+1), ..., f(N-1), the loop is unrolled at compile time.
+*/
+template <int I, int N>
+struct LaFixedUnroll
+{
+    template <typename F>
+    static inline void apply(F &f)
+    {
+        f(I);
+        LaFixedUnroll<I + 1, N>::apply(f);
+    }
+};
+
+template <int N>
+struct LaFixedUnroll<N, N>
+{
+    template <typename F>
+    static inline void apply(F &)
+    {
+    }
+};
+
+/**
+  Vector with N components on the stack.
+  <BR><BR>
+  Counterpart of LaVector for small systems (element vectors, single degrees of freedom):
+  no heap allocation, no name, no virtual functions, the operations are unrolled.
+*/
+template <int N>
+class LaFixedVector
+{
+public:
+    double value[N];
+
+    /*======================================================================*/
+    LaFixedVector() { this->setValues(0.0); }
+    explicit LaFixedVector(double a) { this->setValues(a); }
+    explicit LaFixedVector(const double *array)
+    {
+        for (int i = 0; i < N; i++)
+            this->value[i] = array[i];
+    }
+    /**
+      Copies the first N components of a dynamic vector.
+    */
+    explicit LaFixedVector(LaVector *vector)
+    {
+        if (vector->getDimension() < N)
+            throw TmcException(UB_EXARGS, "LaFixedVector(): vector too small");
+        for (int i = 0; i < N; i++)
+            this->value[i] = vector->getValue(i);
+    }
+
+    /*======================================================================*/
+    int getDimension() const { return N; }
+    double getValue(int row) const { return this->value[row]; }
+    void setValue(int row, double a) { this->value[row] = a; }
+    void addValue(int row, double a) { this->value[row] += a; }
+    double &operator[](int row) { return this->value[row]; }
+    const double &operator[](int row) const { return this->value[row]; }
+
+    void setValues(double a)
+    {
+        auto f = [this, a](int i) { this->value[i] = a; };
+        LaFixedUnroll<0, N>::apply(f);
+    }
+    void multiplyValue(double a)
+    {
+        auto f = [this, a](int i) { this->value[i] *= a; };
+        LaFixedUnroll<0, N>::apply(f);
+    }
+    /**
+      this += factor * vector
+    */
+    void add(const LaFixedVector &vector, double factor = 1.0)
+    {
+        auto f = [this, &vector, factor](int i) { this->value[i] += factor * vector.value[i]; };
+        LaFixedUnroll<0, N>::apply(f);
+    }
+    double dot(const LaFixedVector &vector) const
+    {
+        double sum = 0.0;
+        auto f = [this, &vector, &sum](int i) { sum += this->value[i] * vector.value[i]; };
+        LaFixedUnroll<0, N>::apply(f);
+        return sum;
+    }
+
+    /*======================================================================*/
+    /**
+      Writes the components to the first N components of a dynamic vector.
+    */
+    void copyTo(LaVector *vector) const
+    {
+        for (int i = 0; i < N; i++)
+            vector->setValue(i, this->value[i]);
+    }
+    /**
+      Adds the components to the components indices[0..N-1] of a dynamic vector.
+    */
+    void addTo(LaVector *vector, const int *indices) const
+    {
+        for (int i = 0; i < N; i++)
+            vector->addValue(indices[i], this->value[i]);
+    }
+    LaVector *toVector(std::string name = "LaFixedVector") const
+    {
+        LaVector *vector = new LaVector(N, name);
+        this->copyTo(vector);
+        return vector;
+    }
+
+    std::string toString() const
+    {
+        std::stringstream ss;
+        ss << "LaFixedVector<" << N << ">[";
+        for (int i = 0; i < N; i++)
+            ss << (i > 0 ? ", " : "") << this->value[i];
+        ss << "]";
+        return ss.str();
+    }
+};
+#endif
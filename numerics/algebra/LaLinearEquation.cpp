@@ -40,6 +40,7 @@
 \*---------------------------------------------------------------------------*/
 
 #include "./LaLinearEquation.h"
+#include <common/utilities/TmcTrace.h>
 
 using namespace std;
 
@@ -349,14 +350,36 @@ LaSquareMatrix *LaLinearEquation::getMatrix() { return (this->matrix); }
 */
 LaVector *LaLinearEquation::solve()
 {
+    LaVector *solution = new LaVector(this->vektor->getDimension());
+    try
+    {
+        this->solve(*solution);
+    }
+    catch (...)
+    {
+        delete solution;
+        throw;
+    }
+    return solution;
+}
+/**
+  Solves the linear equation <B>Ax=b</B> into an existing vector, no memory is allocated if the
+  solution vector has the right dimension and the matrix is already factorized.
+  The solution vector may be the right hand vector of this equation.
+  @param solution the result-vector
+*/
+void LaLinearEquation::solve(LaVector &solution)
+{
+    TMC_TRACE_SCOPE("solve", "algebra");
     int n = matrix->getRowNumber();
-    int m = (int)this->vektor->value->size();
+    int m = this->vektor->getDimension();
     if (n != m)
         throw TmcException("LaLE.solve(): incompatible matrix and vector dimensions");
 
     try
     {
-        return (this->matrix->solveLinearEquation(this->vektor));
+        // diagonal, tridiagonal, banded and symmetric positive definite systems get their own solver
+        this->matrix->solveLinearEquation(*this->vektor, solution);
     }
     catch (string &s)
     {
@@ -392,6 +415,7 @@ LaVector *LaLinearEquation::solve()
 */
 LaVector *LaLinearEquation::solveSeparated()
 {
+    TMC_TRACE_SCOPE("solveSeparated", "algebra");
     int n = this->matrix->getRowNumber();
     int m = (int)this->vektor->value->size();
     int o = (int)this->left->value->size();
@@ -93,6 +93,7 @@ public:
     LaSquareMatrix *getMatrix();
 
     LaVector *solve();
+    void solve(LaVector &solution);
     LaVector *solveSeparated();
 };
 #endif
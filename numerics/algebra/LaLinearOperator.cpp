@@ -0,0 +1,203 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    linear operators for matrix-free and iterative solvers
+
+\*---------------------------------------------------------------------------*/
+
+#include "./LaLinearOperator.h"
+
+#include "./LaSparseMatrix.h"
+#include "./LaSquareMatrix.h"
+
+#include <common/utilities/TmcException.h>
+
+#include <algorithm>
+
+using namespace std;
+
+/*======================================================================*/
+/*  LaDenseOperator                                                     */
+/*                                                                      */
+int LaDenseOperator::getDimension() const
+{
+    return this->matrix->getRowNumber();
+}
+/*======================================================================*/
+void LaDenseOperator::apply(const double *x, double *y) const
+{
+    const int n = this->matrix->getRowNumber();
+    std::fill(y, y + n, 0.0);
+    this->matrix->view().multiplyAdd(LaConstVectorView(x, n), LaVectorView(y, n));
+}
+/*======================================================================*/
+void LaDenseOperator::applyAdd(double factor, const double *x, double *y) const
+{
+    const int n = this->matrix->getRowNumber();
+    this->matrix->view().multiplyAdd(LaConstVectorView(x, n), LaVectorView(y, n), factor);
+}
+/*======================================================================*/
+void LaDenseOperator::getDiagonal(double *diagonal) const
+{
+    const LaConstMatrixView a = this->matrix->view();
+    for (int i = 0; i < a.getRowNumber(); i++)
+        diagonal[i] = a(i, i);
+}
+
+/*======================================================================*/
+/*  LaSparseOperator                                                    */
+/*                                                                      */
+int LaSparseOperator::getDimension() const
+{
+    return this->matrix->getRowNumber();
+}
+/*======================================================================*/
+void LaSparseOperator::apply(const double *x, double *y) const
+{
+    this->matrix->multiply(x, y);
+}
+/*======================================================================*/
+void LaSparseOperator::applyAdd(double factor, const double *x, double *y) const
+{
+    const int *start = this->matrix->columnStart();
+    const int *row = this->matrix->rowIndex();
+    const double *value = this->matrix->values();
+    for (int j = 0; j < this->matrix->getColumnNumber(); j++)
+    {
+        const double xj = factor * x[j];
+        for (int p = start[j]; p < start[j + 1]; p++)
+            y[row[p]] += value[p] * xj;
+    }
+}
+/*======================================================================*/
+void LaSparseOperator::getDiagonal(double *diagonal) const
+{
+    for (int i = 0; i < this->matrix->getRowNumber(); i++)
+        diagonal[i] = this->matrix->getValue(i, i);
+}
+
+/*======================================================================*/
+/*  LaOperatorSum                                                       */
+/*                                                                      */
+LaOperatorSum::LaOperatorSum(int dimension) : dimension(dimension) {}
+/*======================================================================*/
+int LaOperatorSum::add(double factor, const LaLinearOperator *term)
+{
+    if (term->getDimension() != this->dimension)
+        throw TmcException(UB_EXARGS, "LaOperatorSum - the dimension of the term does not fit");
+    this->factors.push_back(factor);
+    this->terms.push_back(term);
+    return (int)this->terms.size() - 1;
+}
+/*======================================================================*/
+void LaOperatorSum::applyTerms(const double *x, double *y) const
+{
+    std::fill(y, y + this->dimension, 0.0);
+    for (size_t k = 0; k < this->terms.size(); k++)
+        if (this->factors[k] != 0.0 && !this->terms[k]->isZero())
+            this->terms[k]->applyAdd(this->factors[k], x, y);
+}
+/*======================================================================*/
+void LaOperatorSum::apply(const double *x, double *y) const
+{
+    if (this->fixed.empty())
+    {
+        this->applyTerms(x, y);
+        return;
+    }
+    this->scratch.assign(x, x + this->dimension);
+    for (size_t k = 0; k < this->fixed.size(); k++)
+        this->scratch[this->fixed[k]] = 0.0;
+    this->applyTerms(this->scratch.data(), y);
+    for (size_t k = 0; k < this->fixed.size(); k++)
+        y[this->fixed[k]] = x[this->fixed[k]];
+}
+/*======================================================================*/
+void LaOperatorSum::applyAdd(double factor, const double *x, double *y) const
+{
+    if (factor == 0.0)
+        return;
+    const double *free = x;
+    if (!this->fixed.empty())
+    {
+        this->scratch.assign(x, x + this->dimension);
+        this->fixedRows.resize(this->fixed.size());
+        for (size_t k = 0; k < this->fixed.size(); k++)
+        {
+            this->scratch[this->fixed[k]] = 0.0;
+            this->fixedRows[k] = y[this->fixed[k]];
+        }
+        free = this->scratch.data();
+    }
+    for (size_t k = 0; k < this->terms.size(); k++)
+        if (this->factors[k] != 0.0 && !this->terms[k]->isZero())
+            this->terms[k]->applyAdd(factor * this->factors[k], free, y);
+    for (size_t k = 0; k < this->fixed.size(); k++)
+        y[this->fixed[k]] = this->fixedRows[k] + factor * x[this->fixed[k]];
+}
+/*======================================================================*/
+void LaOperatorSum::getDiagonal(double *diagonal) const
+{
+    std::fill(diagonal, diagonal + this->dimension, 0.0);
+    vector<double> termDiagonal(this->dimension);
+    for (size_t k = 0; k < this->terms.size(); k++)
+    {
+        if (this->factors[k] == 0.0 || this->terms[k]->isZero())
+            continue;
+        this->terms[k]->getDiagonal(termDiagonal.data());
+        for (int i = 0; i < this->dimension; i++)
+            diagonal[i] += this->factors[k] * termDiagonal[i];
+    }
+    for (size_t k = 0; k < this->fixed.size(); k++)
+        diagonal[this->fixed[k]] = 1.0;
+}
+/*======================================================================*/
+void LaOperatorSum::eliminate(const double *b, double *rhs) const
+{
+    bool prescribed = false;
+    for (size_t k = 0; k < this->fixed.size(); k++)
+        prescribed = prescribed || b[this->fixed[k]] != 0.0;
+    if (!prescribed)
+    {
+        std::copy(b, b + this->dimension, rhs);
+        return;
+    }
+    vector<double> g(this->dimension, 0.0);
+    for (size_t k = 0; k < this->fixed.size(); k++)
+        g[this->fixed[k]] = b[this->fixed[k]];
+    this->applyTerms(g.data(), rhs);
+    for (int i = 0; i < this->dimension; i++)
+        rhs[i] = b[i] - rhs[i];
+    for (size_t k = 0; k < this->fixed.size(); k++)
+        rhs[this->fixed[k]] = b[this->fixed[k]];
+}
@@ -0,0 +1,143 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    linear operators for matrix-free and iterative solvers
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LALINEAROPERATOR_H
+#define LALINEAROPERATOR_H
+
+#include <vector>
+
+#include <TmcMacroFile.h>
+
+class LaSquareMatrix;
+class LaSparseMatrix;
+
+/**
+  A linear map y = A x which is only known by its application, e.g. a matrix-free element
+  operator. Iterative solvers (LaConjugateGradient) and the matrix-free mode of the initial value
+  solvers work with this interface, LaDenseOperator and LaSparseOperator adapt stored matrices.
+*/
+class TMC_DLL_EXPORT LaLinearOperator
+{
+public:
+    virtual ~LaLinearOperator() {}
+
+    virtual int getDimension() const = 0;
+    /** y = A x, x and y must not overlap */
+    virtual void apply(const double *x, double *y) const = 0;
+    /** y += factor A x, x and y must not overlap, called in every iteration -> no temporary vectors */
+    virtual void applyAdd(double factor, const double *x, double *y) const = 0;
+    /** the diagonal of A, e.g. for a Jacobi preconditioner */
+    virtual void getDiagonal(double *diagonal) const = 0;
+    /** true if A x is zero for every x, such terms can be skipped */
+    virtual bool isZero() const { return false; }
+};
+
+/*======================================================================*/
+/** a dense matrix as operator, the matrix is not copied */
+class TMC_DLL_EXPORT LaDenseOperator : public LaLinearOperator
+{
+public:
+    explicit LaDenseOperator(const LaSquareMatrix *matrix) : matrix(matrix) {}
+
+    int getDimension() const;
+    void apply(const double *x, double *y) const;
+    void applyAdd(double factor, const double *x, double *y) const;
+    void getDiagonal(double *diagonal) const;
+
+private:
+    const LaSquareMatrix *matrix;
+};
+
+/*======================================================================*/
+/** a sparse matrix as operator, the matrix is not copied */
+class TMC_DLL_EXPORT LaSparseOperator : public LaLinearOperator
+{
+public:
+    explicit LaSparseOperator(const LaSparseMatrix *matrix) : matrix(matrix) {}
+
+    int getDimension() const;
+    void apply(const double *x, double *y) const;
+    void applyAdd(double factor, const double *x, double *y) const;
+    void getDiagonal(double *diagonal) const;
+
+private:
+    const LaSparseMatrix *matrix;
+};
+
+/*======================================================================*/
+/**
+  Linear combination A = sum factor<SUB>k</SUB> A<SUB>k</SUB> of operators, e.g. the step matrix
+  K + c<SUB>D</SUB> D + c<SUB>M</SUB> M of an implicit time integration. Rows and columns of fixed
+  unknowns are those of the identity, so a symmetric sum stays symmetric. Prescribed values of
+  the fixed unknowns are moved to the right hand side with eliminate().
+  The terms are referenced, not copied.
+*/
+class TMC_DLL_EXPORT LaOperatorSum : public LaLinearOperator
+{
+public:
+    explicit LaOperatorSum(int dimension = 0);
+
+    /** @return the index of the term */
+    int add(double factor, const LaLinearOperator *term);
+    void setFactor(int term, double factor) { this->factors[term] = factor; }
+    void setFixed(const std::vector<int> &indices) { this->fixed = indices; }
+    const std::vector<int> &getFixed() const { return this->fixed; }
+
+    int getDimension() const { return this->dimension; }
+    void apply(const double *x, double *y) const;
+    void applyAdd(double factor, const double *x, double *y) const;
+    void getDiagonal(double *diagonal) const;
+
+    /**
+      Right hand side of the system with the columns of the fixed unknowns eliminated:
+      rhs = b - A g on the free unknowns and rhs = b on the fixed ones, where g holds the
+      prescribed values b of the fixed unknowns. The solution then has x = b on the fixed unknowns.
+    */
+    void eliminate(const double *b, double *rhs) const;
+
+private:
+    void applyTerms(const double *x, double *y) const;
+
+    int dimension;
+    std::vector<double> factors;
+    std::vector<const LaLinearOperator *> terms;
+    std::vector<int> fixed;
+    mutable std::vector<double> scratch;
+    mutable std::vector<double> fixedRows; //< y of the fixed unknowns in applyAdd
+};
+
+#endif
@@ -0,0 +1,392 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    structure analysis of square matrices and the structured solvers
+
+\*---------------------------------------------------------------------------*/
+
+#include "./LaMatrixStructure.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+
+/*======================================================================*/
+LaMatrixStructure::LaMatrixStructure()
+    : dimension(0), lowerBandwidth(0), upperBandwidth(0), nonZeros(0), density(0.0), symmetric(true), identity(true), positiveDiagonal(true),
+      diagonallyDominant(true), zeroRows(0), blocks(0), solver(DENSE)
+{
+}
+/*======================================================================*/
+LaMatrixStructure LaMatrixStructure::analyze(const LaConstMatrixView &matrix, double tolerance)
+{
+    LaMatrixStructure back;
+    const int n = matrix.getRowNumber();
+    back.dimension = n;
+    if (n == 0)
+        return back;
+
+    vector<double> offDiagonal(n, 0.0);
+    vector<int> rowEntries(n, 0);
+    vector<int> reach(n, 0); //< largest index coupled with i through an entry (i,j) or (j,i), j >= i
+
+    // every pair (i,j), (j,i) is visited once
+    for (int i = 0; i < n; i++)
+    {
+        const double d = matrix(i, i);
+        if (std::fabs(d) > tolerance)
+        {
+            back.nonZeros++;
+            rowEntries[i]++;
+        }
+        if (d <= 0.0)
+            back.positiveDiagonal = false;
+        if (std::fabs(d - 1.0) > tolerance)
+            back.identity = false;
+        reach[i] = std::max(reach[i], i);
+
+        for (int j = i + 1; j < n; j++)
+        {
+            const double upper = matrix(i, j);
+            const double lower = matrix(j, i);
+            const bool upperNonZero = std::fabs(upper) > tolerance;
+            const bool lowerNonZero = std::fabs(lower) > tolerance;
+            if (upperNonZero)
+            {
+                back.nonZeros++;
+                rowEntries[i]++;
+                offDiagonal[i] += std::fabs(upper);
+                back.upperBandwidth = std::max(back.upperBandwidth, j - i);
+            }
+            if (lowerNonZero)
+            {
+                back.nonZeros++;
+                rowEntries[j]++;
+                offDiagonal[j] += std::fabs(lower);
+                back.lowerBandwidth = std::max(back.lowerBandwidth, j - i);
+            }
+            if (upperNonZero || lowerNonZero)
+            {
+                back.identity = false;
+                reach[i] = j;
+            }
+            if (std::fabs(upper - lower) > tolerance)
+                back.symmetric = false;
+        }
+    }
+
+    bool strict = false;
+    int blockEnd = -1;
+    for (int i = 0; i < n; i++)
+    {
+        const double d = std::fabs(matrix(i, i));
+        if (rowEntries[i] == 0)
+            back.zeroRows++;
+        if (d < offDiagonal[i])
+            back.diagonallyDominant = false;
+        else if (d > offDiagonal[i])
+            strict = true;
+
+        if (i > blockEnd)
+            back.blocks++;
+        blockEnd = std::max(blockEnd, reach[i]);
+    }
+    back.diagonallyDominant = back.diagonallyDominant && strict;
+    back.density = (double)back.nonZeros / ((double)n * n);
+
+    /*-------------------------------------------------------------------*/
+    /*  Solver: pivoting is only left out for matrices which are         */
+    /*  diagonally dominant or candidates for Cholesky                   */
+    /*                                                                   */
+    const bool cholesky = back.symmetric && back.positiveDiagonal;
+    const bool withoutPivoting = back.diagonallyDominant || cholesky;
+    if (back.zeroRows > 0)
+        back.solver = DENSE; //< singular, LU reports it
+    else if (back.isDiagonal())
+        back.solver = DIAGONAL;
+    else if (back.isTriDiagonal() && withoutPivoting)
+        back.solver = TRIDIAGONAL;
+    else if (withoutPivoting && 4 * back.getBandwidth() < n)
+        back.solver = BANDED;
+    else if (cholesky && n >= 200 && 10 * back.nonZeros < (long)n * n) //< smaller systems are faster with dense Cholesky
+        back.solver = SPARSE;
+    else if (cholesky)
+        back.solver = CHOLESKY;
+    else
+        back.solver = DENSE;
+    return back;
+}
+/*======================================================================*/
+std::string LaMatrixStructure::toString() const
+{
+    static const char *names[] = {"diagonal", "tridiagonal", "banded", "sparse", "cholesky", "dense"};
+    stringstream ss;
+    ss << "LaMatrixStructure[n=" << dimension << ", bandwidth=" << lowerBandwidth << "/" << upperBandwidth << ", nonzeros=" << nonZeros
+       << ", density=" << density << ", symmetric=" << symmetric << ", diagonally dominant=" << diagonallyDominant
+       << ", zero rows=" << zeroRows << ", blocks=" << blocks << ", solver=" << names[solver] << "]";
+    return ss.str();
+}
+
+/*======================================================================*/
+/*  LaStructuredSolver                                                  */
+/*                                                                      */
+LaStructuredSolver::LaStructuredSolver() : solver(LaMatrixStructure::DENSE), dimension(0), lower(0), upper(0), cholesky(false) {}
+/*======================================================================*/
+bool LaStructuredSolver::factorize(const LaConstMatrixView &matrix, const LaMatrixStructure &structure, const LaPermutation &ordering)
+{
+    if (!this->factorize(ordering.permute(matrix), structure))
+        return false;
+    if (!ordering.isIdentity())
+    {
+        this->ordering = ordering;
+        this->reordered.resize(ordering.getDimension());
+    }
+    return true;
+}
+/*======================================================================*/
+bool LaStructuredSolver::factorize(const LaConstMatrixView &matrix, const LaMatrixStructure &structure)
+{
+    const int n = matrix.getRowNumber();
+    this->solver = structure.solver;
+    this->dimension = n;
+    this->cholesky = false;
+    this->ordering = LaPermutation();
+
+    switch (structure.solver)
+    {
+    case LaMatrixStructure::DIAGONAL:
+        this->factors.resize(n);
+        for (int i = 0; i < n; i++)
+        {
+            if (matrix(i, i) == 0.0)
+                return false;
+            this->factors[i] = 1.0 / matrix(i, i);
+        }
+        return true;
+
+    case LaMatrixStructure::TRIDIAGONAL:
+    {
+        // Thomas: [sub, 1/pivot, super] per row
+        this->factors.resize(3 * (size_t)n);
+        double *sub = &this->factors[0];
+        double *pivot = &this->factors[n];
+        double *super = &this->factors[2 * (size_t)n];
+        for (int i = 0; i < n; i++)
+        {
+            sub[i] = i > 0 ? matrix(i, i - 1) : 0.0;
+            super[i] = i < n - 1 ? matrix(i, i + 1) : 0.0;
+            double p = matrix(i, i);
+            if (i > 0)
+                p -= sub[i] * super[i - 1] * pivot[i - 1];
+            if (p == 0.0)
+                return false;
+            // without diagonal dominance only positive definite matrices are safe without pivoting
+            if (p < 0.0 && !structure.diagonallyDominant)
+                return false;
+            pivot[i] = 1.0 / p;
+        }
+        return true;
+    }
+    case LaMatrixStructure::BANDED:
+        if (structure.symmetric && structure.positiveDiagonal && this->factorizeCholesky(matrix, structure.getBandwidth()))
+            return true;
+        return structure.diagonallyDominant && this->factorizeBandLU(matrix, structure.lowerBandwidth, structure.upperBandwidth);
+
+    case LaMatrixStructure::SPARSE:
+        // the lower triangle, the symbolic analysis is repeated only for a new pattern
+        return this->sparse.factorize(LaSparseMatrix(matrix, 0.0, true));
+
+    case LaMatrixStructure::CHOLESKY:
+        return this->factorizeCholesky(matrix, n - 1);
+
+    default:
+        return false;
+    }
+}
+/*======================================================================*/
+/**
+  L L^T = A, L is stored row by row with bandwidth + 1 entries per row,
+  L(i,j) at factors[i * (b + 1) + j - i + b].
+*/
+bool LaStructuredSolver::factorizeCholesky(const LaConstMatrixView &matrix, int bandwidth)
+{
+    const int n = this->dimension;
+    const int w = bandwidth + 1;
+    this->factors.assign((size_t)n * w, 0.0);
+    this->lower = bandwidth;
+    this->upper = bandwidth;
+    double *l = &this->factors[0];
+
+    for (int i = 0; i < n; i++)
+    {
+        double *li = l + (size_t)i * w + bandwidth - i; //< li[j] = L(i,j)
+        for (int j = std::max(0, i - bandwidth); j <= i; j++)
+        {
+            const double *lj = l + (size_t)j * w + bandwidth - j;
+            double sum = matrix(i, j);
+            for (int k = std::max(0, i - bandwidth); k < j; k++)
+                sum -= li[k] * lj[k];
+            if (i == j)
+            {
+                if (sum <= 0.0)
+                    return false; //< not positive definite
+                li[i] = std::sqrt(sum);
+            }
+            else
+                li[j] = sum / lj[j];
+        }
+    }
+    this->cholesky = true;
+    return true;
+}
+/*======================================================================*/
+/**
+  A = L U without pivoting, stored row by row with lower + upper + 1 entries,
+  (i,j) at factors[i * w + j - i + lower]. Only called for diagonally dominant matrices.
+*/
+bool LaStructuredSolver::factorizeBandLU(const LaConstMatrixView &matrix, int lower, int upper)
+{
+    const int n = this->dimension;
+    const int w = lower + upper + 1;
+    this->factors.assign((size_t)n * w, 0.0);
+    this->lower = lower;
+    this->upper = upper;
+    double *a = &this->factors[0];
+
+    for (int i = 0; i < n; i++)
+        for (int j = std::max(0, i - lower); j <= std::min(n - 1, i + upper); j++)
+            a[(size_t)i * w + j - i + lower] = matrix(i, j);
+
+    for (int k = 0; k < n; k++)
+    {
+        double *ak = a + (size_t)k * w + lower - k;
+        if (ak[k] == 0.0)
+            return false;
+        const double pivot = 1.0 / ak[k];
+        for (int i = k + 1; i <= std::min(n - 1, k + lower); i++)
+        {
+            double *ai = a + (size_t)i * w + lower - i;
+            const double factor = ai[k] * pivot;
+            ai[k] = factor;
+            for (int j = k + 1; j <= std::min(n - 1, k + upper); j++)
+                ai[j] -= factor * ak[j];
+        }
+    }
+    return true;
+}
+/*======================================================================*/
+void LaStructuredSolver::solve(double *vektor) const
+{
+    if (this->ordering.getDimension() == 0)
+    {
+        this->solveInOrder(vektor);
+        return;
+    }
+    double *x = &this->reordered[0];
+    this->ordering.apply(vektor, x);
+    this->solveInOrder(x);
+    this->ordering.applyInverse(x, vektor);
+}
+/*======================================================================*/
+void LaStructuredSolver::solveInOrder(double *x) const
+{
+    const int n = this->dimension;
+    switch (this->solver)
+    {
+    case LaMatrixStructure::DIAGONAL:
+        for (int i = 0; i < n; i++)
+            x[i] *= this->factors[i];
+        return;
+
+    case LaMatrixStructure::TRIDIAGONAL:
+    {
+        const double *sub = &this->factors[0];
+        const double *pivot = &this->factors[n];
+        const double *super = &this->factors[2 * (size_t)n];
+        for (int i = 1; i < n; i++)
+            x[i] -= sub[i] * pivot[i - 1] * x[i - 1];
+        x[n - 1] *= pivot[n - 1];
+        for (int i = n - 2; i >= 0; i--)
+            x[i] = (x[i] - super[i] * x[i + 1]) * pivot[i];
+        return;
+    }
+    case LaMatrixStructure::SPARSE:
+        this->sparse.solve(x);
+        return;
+    default:
+        break;
+    }
+
+    const double *f = &this->factors[0];
+    if (this->cholesky)
+    {
+        const int b = this->lower;
+        const int w = b + 1;
+        for (int i = 0; i < n; i++)
+        {
+            const double *li = f + (size_t)i * w + b - i;
+            double sum = x[i];
+            for (int k = std::max(0, i - b); k < i; k++)
+                sum -= li[k] * x[k];
+            x[i] = sum / li[i];
+        }
+        for (int i = n - 1; i >= 0; i--)
+        {
+            double sum = x[i];
+            for (int k = i + 1; k <= std::min(n - 1, i + b); k++)
+                sum -= f[(size_t)k * w + b - k + i] * x[k];
+            x[i] = sum / f[(size_t)i * w + b];
+        }
+        return;
+    }
+
+    const int w = this->lower + this->upper + 1;
+    for (int i = 0; i < n; i++)
+    {
+        const double *ai = f + (size_t)i * w + this->lower - i;
+        double sum = x[i];
+        for (int k = std::max(0, i - this->lower); k < i; k++)
+            sum -= ai[k] * x[k];
+        x[i] = sum;
+    }
+    for (int i = n - 1; i >= 0; i--)
+    {
+        const double *ai = f + (size_t)i * w + this->lower - i;
+        double sum = x[i];
+        for (int k = i + 1; k <= std::min(n - 1, i + this->upper); k++)
+            sum -= ai[k] * x[k];
+        x[i] = sum / ai[i];
+    }
+}
@@ -0,0 +1,140 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    structure analysis of square matrices and the structured solvers
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LAMATRIXSTRUCTURE_H
+#define LAMATRIXSTRUCTURE_H
+
+#include <string>
+#include <vector>
+
+#include "./LaPermutation.h"
+#include "./LaSparseCholesky.h"
+#include "./LaView.h"
+#include <TmcMacroFile.h>
+
+/**
+  Structure of a square matrix, found in one pass over the values.
+  <BR><BR>
+  Entries with |a<SUB>ij</SUB>| <= tolerance count as zero, a pair with
+  |a<SUB>ij</SUB> - a<SUB>ji</SUB>| <= tolerance as symmetric. The solver dispatch uses the
+  tolerance 0, so no value of the matrix is ignored.
+*/
+class TMC_DLL_EXPORT LaMatrixStructure
+{
+public:
+    /** the cheapest solver which is correct for the structure */
+    enum SOLVER
+    {
+        DIAGONAL,    //< O(n)
+        TRIDIAGONAL, //< Thomas algorithm, O(n)
+        BANDED,      //< band Cholesky or band LU without pivoting, O(n b^2)
+        SPARSE,      //< supernodal sparse Cholesky, depends on the fill-in
+        CHOLESKY,    //< dense Cholesky, n^3/3
+        DENSE        //< LU with partial pivoting, 2n^3/3
+    };
+
+public:
+    LaMatrixStructure();
+
+    static LaMatrixStructure analyze(const LaConstMatrixView &matrix, double tolerance = 0.0);
+
+    bool isDiagonal() const { return this->lowerBandwidth == 0 && this->upperBandwidth == 0; }
+    bool isTriDiagonal() const { return this->lowerBandwidth <= 1 && this->upperBandwidth <= 1; }
+    int getBandwidth() const { return this->lowerBandwidth > this->upperBandwidth ? this->lowerBandwidth : this->upperBandwidth; }
+
+    std::string toString() const;
+
+public:
+    int dimension;
+    int lowerBandwidth; //< largest i - j of a nonzero entry
+    int upperBandwidth; //< largest j - i of a nonzero entry
+    long nonZeros;
+    double density; //< nonZeros / n^2
+    bool symmetric;
+    bool identity;
+    bool positiveDiagonal;
+    bool diagonallyDominant; //< |a_ii| >= sum |a_ij| in every row, strictly in one
+    int zeroRows;
+    int blocks; //< number of independent diagonal blocks
+    SOLVER solver;
+};
+
+/*======================================================================*/
+/**
+  Factorization and solve for the solvers of LaMatrixStructure apart from DENSE,
+  which is the LU factorization of LaSquareMatrix.
+*/
+class TMC_DLL_EXPORT LaStructuredSolver
+{
+public:
+    LaStructuredSolver();
+
+    /**
+      Factorizes the matrix with the solver of the structure.
+      @return false if the matrix does not allow it (a Cholesky factorization of a matrix
+      which is not positive definite, a zero pivot), the caller has to use dense LU
+    */
+    bool factorize(const LaConstMatrixView &matrix, const LaMatrixStructure &structure);
+    /**
+      Factorizes P A P<SUP>T</SUP>, solve() permutes the right hand side and the solution.
+      @param structure the structure of the reordered matrix
+    */
+    bool factorize(const LaConstMatrixView &matrix, const LaMatrixStructure &structure, const LaPermutation &ordering);
+    /** solves in place */
+    void solve(double *vektor) const;
+
+    LaMatrixStructure::SOLVER getSolver() const { return this->solver; }
+    /** the sparse factorization, its symbolic analysis is kept while the pattern stays the same */
+    const LaSparseCholesky &getSparseCholesky() const { return this->sparse; }
+
+private:
+    bool factorizeCholesky(const LaConstMatrixView &matrix, int bandwidth);
+    bool factorizeBandLU(const LaConstMatrixView &matrix, int lower, int upper);
+    void solveInOrder(double *x) const;
+
+    LaMatrixStructure::SOLVER solver;
+    int dimension;
+    int lower;
+    int upper;
+    bool cholesky;
+    std::vector<double> factors;
+    LaPermutation ordering; //< empty if the matrix is not reordered
+    mutable std::vector<double> reordered;
+    LaSparseCholesky sparse;
+};
+
+#endif
@@ -0,0 +1,414 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    symmetric reorderings (reverse Cuthill-McKee, minimum degree) of linear systems
+
+\*---------------------------------------------------------------------------*/
+
+#include "./LaPermutation.h"
+
+#include <common/utilities/TmcException.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+/*======================================================================*/
+LaPermutation::LaPermutation() {}
+/*======================================================================*/
+LaPermutation::LaPermutation(int dimension) : order(dimension), position(dimension)
+{
+    for (int i = 0; i < dimension; i++)
+        this->order[i] = this->position[i] = i;
+}
+/*======================================================================*/
+LaPermutation::LaPermutation(const std::vector<int> &order) : order(order), position(order.size(), -1)
+{
+    for (int i = 0; i < (int)order.size(); i++)
+    {
+        if (order[i] < 0 || order[i] >= (int)order.size() || this->position[order[i]] != -1)
+            throw TmcException(UB_EXARGS, "LaPermutation - the order is no permutation");
+        this->position[order[i]] = i;
+    }
+}
+/*======================================================================*/
+bool LaPermutation::isIdentity() const
+{
+    for (int i = 0; i < (int)this->order.size(); i++)
+        if (this->order[i] != i)
+            return false;
+    return true;
+}
+/*======================================================================*/
+LaPermutation LaPermutation::inverse() const
+{
+    return LaPermutation(this->position);
+}
+/*======================================================================*/
+void LaPermutation::apply(const double *source, double *target) const
+{
+    for (int i = 0; i < (int)this->order.size(); i++)
+        target[i] = source[this->order[i]];
+}
+/*======================================================================*/
+void LaPermutation::applyInverse(const double *source, double *target) const
+{
+    for (int i = 0; i < (int)this->order.size(); i++)
+        target[this->order[i]] = source[i];
+}
+/*======================================================================*/
+LaConstMatrixView LaPermutation::permute(const LaConstMatrixView &matrix) const
+{
+    const int n = this->getDimension();
+    if (matrix.getRowNumber() != n || matrix.getColumnNumber() != n)
+        throw TmcException(UB_EXARGS, "LaPermutation - dimensions do not fit");
+    return matrix.select(this->data(), n, this->data(), n);
+}
+/*======================================================================*/
+/**
+  Neighbours of every node in the pattern of A + A^T, without the diagonal.
+*/
+vector<vector<int> > LaPermutation::adjacency(const LaConstMatrixView &matrix)
+{
+    const int n = matrix.getRowNumber();
+    vector<vector<int> > back(n);
+    for (int i = 0; i < n; i++)
+        for (int j = i + 1; j < n; j++)
+            if (matrix(i, j) != 0.0 || matrix(j, i) != 0.0)
+            {
+                back[i].push_back(j);
+                back[j].push_back(i);
+            }
+    return back;
+}
+/*======================================================================*/
+vector<vector<int> > LaPermutation::adjacency(const LaSparseMatrix &matrix)
+{
+    const int n = matrix.getRowNumber();
+    const int *start = matrix.columnStart();
+    const int *row = matrix.rowIndex();
+    vector<vector<int> > back(n);
+    for (int j = 0; j < n; j++)
+        for (int p = start[j]; p < start[j + 1]; p++)
+            if (row[p] != j)
+            {
+                back[j].push_back(row[p]);
+                back[row[p]].push_back(j);
+            }
+    // a pattern which is not symmetric contributes both (i,j) and (j,i)
+    for (int i = 0; i < n; i++)
+    {
+        std::sort(back[i].begin(), back[i].end());
+        back[i].erase(std::unique(back[i].begin(), back[i].end()), back[i].end());
+    }
+    return back;
+}
+/*======================================================================*/
+LaPermutation LaPermutation::reverseCuthillMcKee(const LaConstMatrixView &matrix)
+{
+    return LaPermutation::reverseCuthillMcKee(LaPermutation::adjacency(matrix));
+}
+/*======================================================================*/
+LaPermutation LaPermutation::reverseCuthillMcKee(const LaSparseMatrix &matrix)
+{
+    return LaPermutation::reverseCuthillMcKee(LaPermutation::adjacency(matrix));
+}
+/*======================================================================*/
+LaPermutation LaPermutation::minimumDegree(const LaConstMatrixView &matrix)
+{
+    return LaPermutation::minimumDegree(LaPermutation::adjacency(matrix));
+}
+/*======================================================================*/
+LaPermutation LaPermutation::minimumDegree(const LaSparseMatrix &matrix)
+{
+    return LaPermutation::minimumDegree(LaPermutation::adjacency(matrix));
+}
+/*======================================================================*/
+/**
+  Cuthill-McKee breadth first search from a pseudo-peripheral node of every connected
+  component (George and Liu), neighbours in the order of increasing degree, reversed at the end.
+*/
+LaPermutation LaPermutation::reverseCuthillMcKee(const vector<vector<int> > &graph)
+{
+    const int n = (int)graph.size();
+    vector<int> order;
+    order.reserve(n);
+    vector<bool> visited(n, false);
+    vector<int> level(n, -1);
+
+    // breadth first search, returns the nodes of the last level and the depth
+    vector<int> front;
+    auto levels = [&](int start, vector<int> &last) -> int {
+        std::fill(level.begin(), level.end(), -1);
+        front.assign(1, start);
+        level[start] = 0;
+        int depth = 0;
+        last = front;
+        while (!front.empty())
+        {
+            vector<int> next;
+            for (int node : front)
+                for (int neighbour : graph[node])
+                    if (level[neighbour] < 0)
+                    {
+                        level[neighbour] = level[node] + 1;
+                        next.push_back(neighbour);
+                    }
+            if (!next.empty())
+            {
+                depth++;
+                last = next;
+            }
+            front.swap(next);
+        }
+        return depth;
+    };
+
+    for (int seed = 0; seed < n; seed++)
+    {
+        if (visited[seed])
+            continue;
+
+        // pseudo-peripheral node: walk to a node of minimal degree in the last level
+        // as long as the depth increases
+        int start = seed;
+        vector<int> last;
+        int depth = levels(start, last);
+        for (;;)
+        {
+            int candidate = last[0];
+            for (int node : last)
+                if (graph[node].size() < graph[candidate].size())
+                    candidate = node;
+            vector<int> candidateLast;
+            const int candidateDepth = levels(candidate, candidateLast);
+            if (candidateDepth <= depth)
+                break;
+            start = candidate;
+            depth = candidateDepth;
+            last.swap(candidateLast);
+        }
+
+        const size_t begin = order.size();
+        order.push_back(start);
+        visited[start] = true;
+        for (size_t k = begin; k < order.size(); k++)
+        {
+            vector<int> next;
+            for (int neighbour : graph[order[k]])
+                if (!visited[neighbour])
+                {
+                    visited[neighbour] = true;
+                    next.push_back(neighbour);
+                }
+            std::sort(next.begin(), next.end(), [&](int a, int b) {
+                return graph[a].size() < graph[b].size() || (graph[a].size() == graph[b].size() && a < b);
+            });
+            order.insert(order.end(), next.begin(), next.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return LaPermutation(order);
+}
+/*======================================================================*/
+/**
+  Minimum degree ordering on the quotient graph of the elimination (George and Liu): an
+  eliminated node becomes an element, the clique of its neighbours is represented by the
+  element instead of explicit edges. The degrees are the approximate degrees of AMD (Amestoy,
+  Davis and Duff), an upper bound which is computed in time proportional to the adjacency and
+  not to the fill. Elements which are covered by a new element are absorbed.
+  Supervariables and mass elimination are left out.
+*/
+LaPermutation LaPermutation::minimumDegree(const vector<vector<int> > &graph)
+{
+    enum
+    {
+        VARIABLE,
+        ELEMENT,
+        ABSORBED
+    };
+    const int n = (int)graph.size();
+    vector<vector<int> > variables(graph); //< A_i, adjacent variables
+    vector<vector<int> > elements(n);      //< E_i, adjacent elements
+    vector<vector<int> > members(n);       //< L_e, variables of element e
+    vector<char> state(n, VARIABLE);
+    vector<int> degree(n);
+    vector<int> weight(n, 0); //< |L_e \ L_p| during the elimination of p
+    vector<int> mark(n, -1);
+    vector<int> weightMark(n, -1);
+    // doubly linked lists of the variables per degree
+    vector<int> head(n + 1, -1), next(n, -1), previous(n, -1);
+    int minimum = n;
+    auto insert = [&](int i) {
+        next[i] = head[degree[i]];
+        previous[i] = -1;
+        if (next[i] >= 0)
+            previous[next[i]] = i;
+        head[degree[i]] = i;
+        minimum = std::min(minimum, degree[i]);
+    };
+    auto remove = [&](int i) {
+        if (previous[i] >= 0)
+            next[previous[i]] = next[i];
+        else
+            head[degree[i]] = next[i];
+        if (next[i] >= 0)
+            previous[next[i]] = previous[i];
+    };
+    for (int i = 0; i < n; i++)
+    {
+        degree[i] = (int)graph[i].size();
+        insert(i);
+    }
+
+    vector<int> order;
+    order.reserve(n);
+    while ((int)order.size() < n)
+    {
+        while (head[minimum] < 0)
+            minimum++;
+        const int p = head[minimum];
+        remove(p);
+        const int step = (int)order.size();
+        order.push_back(p);
+        state[p] = ELEMENT;
+
+        // L_p = A_p united with the variables of the elements of p, these elements are absorbed
+        vector<int> &lp = members[p];
+        mark[p] = step;
+        for (int v : variables[p])
+            if (state[v] == VARIABLE && mark[v] != step)
+            {
+                mark[v] = step;
+                lp.push_back(v);
+            }
+        for (int e : elements[p])
+        {
+            if (state[e] != ELEMENT)
+                continue;
+            for (int v : members[e])
+                if (state[v] == VARIABLE && mark[v] != step)
+                {
+                    mark[v] = step;
+                    lp.push_back(v);
+                }
+            state[e] = ABSORBED;
+            vector<int>().swap(members[e]);
+        }
+        vector<int>().swap(variables[p]);
+        vector<int>().swap(elements[p]);
+
+        // |L_e \ L_p| of the other elements of the variables in L_p
+        for (int i : lp)
+            for (int e : elements[i])
+            {
+                if (state[e] != ELEMENT)
+                    continue;
+                // an element with an eliminated variable is absorbed, so L_e holds only variables
+                if (weightMark[e] != step)
+                {
+                    weightMark[e] = step;
+                    weight[e] = (int)members[e].size();
+                }
+                weight[e]--;
+            }
+
+        const int remaining = n - step - 1;
+        for (int i : lp)
+        {
+            // edges inside L_p are represented by the element p
+            vector<int> &ai = variables[i];
+            ai.erase(std::remove_if(ai.begin(), ai.end(), [&](int v) { return state[v] != VARIABLE || mark[v] == step; }), ai.end());
+
+            int d = (int)ai.size() + (int)lp.size() - 1;
+            vector<int> &ei = elements[i];
+            size_t kept = 0;
+            for (size_t k = 0; k < ei.size(); k++)
+            {
+                const int e = ei[k];
+                if (state[e] != ELEMENT)
+                    continue;
+                if (weight[e] == 0) //< L_e is part of L_p
+                {
+                    state[e] = ABSORBED;
+                    vector<int>().swap(members[e]);
+                    continue;
+                }
+                d += weight[e];
+                ei[kept++] = e;
+            }
+            ei.resize(kept);
+            ei.push_back(p);
+
+            d = std::min(d, remaining - 1);
+            d = std::min(d, degree[i] + (int)lp.size());
+            remove(i);
+            degree[i] = std::max(d, 0);
+            insert(i);
+        }
+    }
+    return LaPermutation(order);
+}
+/*======================================================================*/
+int LaPermutation::getBandwidth(const LaConstMatrixView &matrix, const LaPermutation &permutation)
+{
+    const LaConstMatrixView reordered = permutation.permute(matrix);
+    const int n = reordered.getRowNumber();
+    int back = 0;
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            if (reordered(i, j) != 0.0)
+                back = std::max(back, std::abs(i - j));
+    return back;
+}
+/*======================================================================*/
+long LaPermutation::getProfile(const LaConstMatrixView &matrix, const LaPermutation &permutation)
+{
+    const LaConstMatrixView reordered = permutation.permute(matrix);
+    const int n = reordered.getRowNumber();
+    long back = 0;
+    for (int i = 0; i < n; i++)
+    {
+        // first column of row i or row of column i in the lower triangle of A + A^T
+        int first = i;
+        for (int j = 0; j < i; j++)
+            if (reordered(i, j) != 0.0 || reordered(j, i) != 0.0)
+            {
+                first = j;
+                break;
+            }
+        back += i - first + 1;
+    }
+    return back;
+}
@@ -0,0 +1,103 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    symmetric reorderings (reverse Cuthill-McKee, minimum degree) of linear systems
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LAPERMUTATION_H
+#define LAPERMUTATION_H
+
+#include <vector>
+
+#include "./LaSparseMatrix.h"
+#include "./LaView.h"
+#include <TmcMacroFile.h>
+
+/**
+  Symmetric reordering of the unknowns of a linear system.
+  <BR><BR>
+  Row and column i of the reordered matrix are row and column getIndex(i) of the original
+  matrix. The reordered matrix needs no copy, it is the view
+  matrix.select(p.data(), n, p.data(), n). A system A x = b is solved as
+  (P A P<SUP>T</SUP>) (P x) = P b: apply() to b, solve, applyInverse() to the result.
+  <BR><BR>
+  The orderings work on the pattern of A + A<SUP>T</SUP> (exact nonzeros of a dense matrix or
+  the pattern of a sparse matrix): reverseCuthillMcKee() reduces bandwidth and profile for
+  banded solvers, minimumDegree() reduces the fill-in of a sparse Cholesky or LU factorization.
+*/
+class TMC_DLL_EXPORT LaPermutation
+{
+public:
+    LaPermutation();
+    /** identity */
+    explicit LaPermutation(int dimension);
+    /** @param order order[i] is the original index of the new index i */
+    explicit LaPermutation(const std::vector<int> &order);
+
+    static LaPermutation reverseCuthillMcKee(const LaConstMatrixView &matrix);
+    static LaPermutation reverseCuthillMcKee(const LaSparseMatrix &matrix);
+    static LaPermutation minimumDegree(const LaConstMatrixView &matrix);
+    static LaPermutation minimumDegree(const LaSparseMatrix &matrix);
+
+    int getDimension() const { return (int)this->order.size(); }
+    bool isIdentity() const;
+    int getIndex(int i) const { return this->order[i]; }
+    int getPosition(int original) const { return this->position[original]; }
+    const int *data() const { return this->order.data(); }
+    LaPermutation inverse() const;
+
+    /** target[i] = source[getIndex(i)] */
+    void apply(const double *source, double *target) const;
+    /** target[getIndex(i)] = source[i] */
+    void applyInverse(const double *source, double *target) const;
+
+    /** the matrix in the new order, a view without copies */
+    LaConstMatrixView permute(const LaConstMatrixView &matrix) const;
+
+    /** largest |i - j| of a nonzero of the reordered matrix */
+    static int getBandwidth(const LaConstMatrixView &matrix, const LaPermutation &permutation);
+    /** number of entries inside the envelope (skyline) of the lower triangle of the reordered matrix */
+    static long getProfile(const LaConstMatrixView &matrix, const LaPermutation &permutation);
+
+private:
+    static std::vector<std::vector<int> > adjacency(const LaConstMatrixView &matrix);
+    static std::vector<std::vector<int> > adjacency(const LaSparseMatrix &matrix);
+    static LaPermutation reverseCuthillMcKee(const std::vector<std::vector<int> > &graph);
+    static LaPermutation minimumDegree(const std::vector<std::vector<int> > &graph);
+
+    std::vector<int> order;
+    std::vector<int> position;
+};
+
+#endif
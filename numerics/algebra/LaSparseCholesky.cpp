@@ -0,0 +1,662 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    supernodal sparse Cholesky factorization with symbolic and numeric phase
+
+\*---------------------------------------------------------------------------*/
+
+#include "./LaSparseCholesky.h"
+
+#include <common/utilities/TmcException.h>
+#include <common/utilities/TmcTrace.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+// below this number of floating point operations the threads cost more than they save
+static const double LASPARSECHOLESKY_PARALLEL_WORK = 4.0e6;
+// columns of a panel of the blocked front factorization
+static const int LASPARSECHOLESKY_PANEL = 32;
+
+/*======================================================================*/
+LaSparseCholesky::LaSparseCholesky()
+    : analyzed(false), factorized(false), threadNumber(0), dimension(0), totalWork(0.0), factorNonZeros(0)
+{
+}
+/*======================================================================*/
+bool LaSparseCholesky::fits(const LaSparseMatrix &matrix) const
+{
+    if (!this->analyzed || matrix.getRowNumber() != this->dimension || matrix.getNonZeros() != (long)this->patternRows.size())
+        return false;
+    const int n = this->dimension;
+    return std::equal(matrix.columnStart(), matrix.columnStart() + n + 1, this->patternStart.begin()) &&
+           std::equal(matrix.rowIndex(), matrix.rowIndex() + this->patternRows.size(), this->patternRows.begin());
+}
+/*======================================================================*/
+void LaSparseCholesky::analyze(const LaSparseMatrix &matrix)
+{
+    TMC_TRACE_SCOPE("sparse Cholesky analysis", "algebra");
+    const int n = matrix.getRowNumber();
+    const int *start = matrix.columnStart();
+    const int *row = matrix.rowIndex();
+    this->dimension = n;
+    this->patternStart.assign(start, start + n + 1);
+    this->patternRows.assign(row, row + start[n]);
+    this->analyzed = false;
+    this->factorized = false;
+
+    // a pattern with entries on both sides of the diagonal is read by one triangle only
+    bool lower = true, upper = true;
+    for (int j = 0; j < n; j++)
+        for (int p = start[j]; p < start[j + 1]; p++)
+        {
+            lower = lower && row[p] >= j;
+            upper = upper && row[p] <= j;
+        }
+    const bool triangular = lower || upper;
+
+    /*-------------------------------------------------------------------*/
+    /*  Fill reducing ordering, elimination tree and its postorder       */
+    /*                                                                   */
+    LaPermutation permutation = LaPermutation::minimumDegree(matrix);
+    vector<int> parent(n);
+    // rows above the diagonal of every row of P A P^T
+    auto upperPattern = [&](const LaPermutation &p, vector<vector<int> > &rows) {
+        rows.assign(n, vector<int>());
+        for (int j = 0; j < n; j++)
+            for (int k = start[j]; k < start[j + 1]; k++)
+            {
+                const int a = p.getPosition(row[k]);
+                const int b = p.getPosition(j);
+                if (a != b)
+                    rows[std::max(a, b)].push_back(std::min(a, b));
+            }
+        for (int i = 0; i < n; i++)
+        {
+            std::sort(rows[i].begin(), rows[i].end());
+            rows[i].erase(std::unique(rows[i].begin(), rows[i].end()), rows[i].end());
+        }
+    };
+    // Liu's algorithm with path compression
+    auto eliminationTree = [&](const vector<vector<int> > &rows) {
+        vector<int> ancestor(n, -1);
+        for (int k = 0; k < n; k++)
+        {
+            parent[k] = -1;
+            for (int j : rows[k])
+            {
+                int r = j;
+                while (ancestor[r] != -1 && ancestor[r] != k)
+                {
+                    const int next = ancestor[r];
+                    ancestor[r] = k;
+                    r = next;
+                }
+                if (ancestor[r] == -1)
+                {
+                    ancestor[r] = k;
+                    parent[r] = k;
+                }
+            }
+        }
+    };
+    vector<vector<int> > upperRows;
+    upperPattern(permutation, upperRows);
+    eliminationTree(upperRows);
+    {
+        vector<int> firstChild(n, -1), nextSibling(n, -1);
+        for (int j = n - 1; j >= 0; j--)
+            if (parent[j] >= 0)
+            {
+                nextSibling[j] = firstChild[parent[j]];
+                firstChild[parent[j]] = j;
+            }
+        vector<int> postorder;
+        postorder.reserve(n);
+        vector<int> stack;
+        for (int root = 0; root < n; root++)
+        {
+            if (parent[root] >= 0)
+                continue;
+            stack.push_back(root);
+            while (!stack.empty())
+            {
+                const int j = stack.back();
+                if (firstChild[j] >= 0)
+                {
+                    // descend, the child is removed from the list of j
+                    const int child = firstChild[j];
+                    firstChild[j] = nextSibling[child];
+                    stack.push_back(child);
+                }
+                else
+                {
+                    postorder.push_back(j);
+                    stack.pop_back();
+                }
+            }
+        }
+        vector<int> order(n);
+        for (int i = 0; i < n; i++)
+            order[i] = permutation.getIndex(postorder[i]);
+        this->ordering = LaPermutation(order);
+    }
+    upperPattern(this->ordering, upperRows);
+    eliminationTree(upperRows);
+
+    /*-------------------------------------------------------------------*/
+    /*  Column patterns (rows below the diagonal) and supernodes,        */
+    /*  the pattern of a column is the union of its entries and the      */
+    /*  patterns of its children                                         */
+    /*                                                                   */
+    vector<vector<int> > lowerRows(n);
+    for (int i = 0; i < n; i++)
+        for (int j : upperRows[i])
+            lowerRows[j].push_back(i);
+    vector<vector<int> > childColumns(n);
+    for (int j = 0; j < n; j++)
+        if (parent[j] >= 0)
+            childColumns[parent[j]].push_back(j);
+
+    vector<vector<int> > columnPattern(n);
+    vector<int> mark(n, -1);
+    vector<int> supernodeOf(n);
+    this->supernodes.clear();
+    this->rowPattern.clear();
+    int previousCount = -1;
+    for (int j = 0; j < n; j++)
+    {
+        vector<int> &pattern = columnPattern[j];
+        mark[j] = j;
+        for (int i : lowerRows[j])
+            if (mark[i] != j)
+            {
+                mark[i] = j;
+                pattern.push_back(i);
+            }
+        for (int c : childColumns[j])
+        {
+            for (int i : columnPattern[c])
+                if (mark[i] != j)
+                {
+                    mark[i] = j;
+                    pattern.push_back(i);
+                }
+            vector<int>().swap(columnPattern[c]);
+        }
+        std::sort(pattern.begin(), pattern.end());
+        vector<int>().swap(lowerRows[j]);
+
+        const int count = (int)pattern.size();
+        if (j > 0 && parent[j - 1] == j && previousCount == count + 1)
+            this->supernodes.back().columns++;
+        else
+        {
+            // the pattern of the first column holds the rows of the whole supernode
+            Supernode supernode = {j, 1, count + 1, this->rowPattern.size(), 0, -1};
+            this->supernodes.push_back(supernode);
+            this->rowPattern.push_back(j);
+            this->rowPattern.insert(this->rowPattern.end(), pattern.begin(), pattern.end());
+        }
+        supernodeOf[j] = (int)this->supernodes.size() - 1;
+        previousCount = count;
+        if (parent[j] < 0)
+            vector<int>().swap(pattern);
+    }
+
+    const int supernodeNumber = (int)this->supernodes.size();
+    size_t factorSize = 0;
+    this->totalWork = 0.0;
+    this->childStart.assign(supernodeNumber + 1, 0);
+    for (int s = 0; s < supernodeNumber; s++)
+    {
+        Supernode &supernode = this->supernodes[s];
+        const int last = supernode.first + supernode.columns - 1;
+        supernode.parent = parent[last] >= 0 ? supernodeOf[parent[last]] : -1;
+        supernode.factor = factorSize;
+        factorSize += (size_t)supernode.rows * supernode.columns;
+        this->totalWork += (double)supernode.columns * supernode.rows * supernode.rows;
+        if (supernode.parent >= 0)
+            this->childStart[supernode.parent + 1]++;
+    }
+    for (int s = 0; s < supernodeNumber; s++)
+        this->childStart[s + 1] += this->childStart[s];
+    this->children.resize(this->childStart[supernodeNumber]);
+    {
+        vector<int> next(this->childStart.begin(), this->childStart.end() - 1);
+        for (int s = 0; s < supernodeNumber; s++)
+            if (this->supernodes[s].parent >= 0)
+                this->children[next[this->supernodes[s].parent]++] = s;
+    }
+    this->factorNonZeros = 0;
+    for (int s = 0; s < supernodeNumber; s++)
+    {
+        const long k = this->supernodes[s].columns;
+        this->factorNonZeros += k * (k + 1) / 2 + k * (this->supernodes[s].rows - k);
+    }
+
+    /*-------------------------------------------------------------------*/
+    /*  Map of the entries of the matrix into the fronts                 */
+    /*                                                                   */
+    this->assemblyStart.assign(supernodeNumber + 1, 0);
+    vector<int> entrySupernode(start[n], -1);
+    vector<int> entryTarget(start[n], -1);
+    for (int j = 0; j < n; j++)
+        for (int p = start[j]; p < start[j + 1]; p++)
+        {
+            const int a = this->ordering.getPosition(row[p]);
+            const int b = this->ordering.getPosition(j);
+            if (!triangular && a < b)
+                continue;
+            const int r = std::max(a, b);
+            const int c = std::min(a, b);
+            const int s = supernodeOf[c];
+            const Supernode &supernode = this->supernodes[s];
+            const int *rows = &this->rowPattern[supernode.pattern];
+            const int local = (int)(std::lower_bound(rows, rows + supernode.rows, r) - rows);
+            entrySupernode[p] = s;
+            entryTarget[p] = (c - supernode.first) * supernode.rows + local;
+            this->assemblyStart[s + 1]++;
+        }
+    for (int s = 0; s < supernodeNumber; s++)
+        this->assemblyStart[s + 1] += this->assemblyStart[s];
+    this->assemblySource.resize(this->assemblyStart[supernodeNumber]);
+    this->assemblyTarget.resize(this->assemblyStart[supernodeNumber]);
+    {
+        vector<int> next(this->assemblyStart.begin(), this->assemblyStart.end() - 1);
+        for (int p = 0; p < start[n]; p++)
+            if (entrySupernode[p] >= 0)
+            {
+                const int k = next[entrySupernode[p]]++;
+                this->assemblySource[k] = p;
+                this->assemblyTarget[k] = entryTarget[p];
+            }
+    }
+
+    this->factorValues.assign(factorSize, 0.0);
+    this->updates.assign(supernodeNumber, vector<double>());
+    this->reordered.resize(n);
+    this->partition();
+    this->analyzed = true;
+}
+/*======================================================================*/
+/**
+  Splits the heaviest subtree into its children until there are enough subtrees for the
+  threads, the split supernodes form the top of the tree.
+*/
+void LaSparseCholesky::partition()
+{
+    const int supernodeNumber = (int)this->supernodes.size();
+    vector<double> work(supernodeNumber);
+    vector<int> firstDescendant(supernodeNumber);
+    for (int s = 0; s < supernodeNumber; s++)
+    {
+        const Supernode &supernode = this->supernodes[s];
+        work[s] += (double)supernode.columns * supernode.rows * supernode.rows;
+        if (this->childStart[s] == this->childStart[s + 1])
+            firstDescendant[s] = s;
+        else
+            firstDescendant[s] = firstDescendant[this->children[this->childStart[s]]];
+        if (supernode.parent >= 0)
+            work[supernode.parent] += work[s];
+    }
+
+    vector<int> candidates;
+    for (int s = 0; s < supernodeNumber; s++)
+        if (this->supernodes[s].parent < 0)
+            candidates.push_back(s);
+    this->top.clear();
+    const int wanted = 4 * (this->threadNumber > 0 ? this->threadNumber : (int)std::max(1u, std::thread::hardware_concurrency()));
+    while ((int)candidates.size() < wanted)
+    {
+        size_t heaviest = 0;
+        for (size_t k = 1; k < candidates.size(); k++)
+            if (work[candidates[k]] > work[candidates[heaviest]])
+                heaviest = k;
+        const int s = candidates.empty() ? -1 : candidates[heaviest];
+        if (s < 0 || this->childStart[s] == this->childStart[s + 1])
+            break;
+        candidates.erase(candidates.begin() + heaviest);
+        this->top.push_back(s);
+        candidates.insert(candidates.end(), this->children.begin() + this->childStart[s], this->children.begin() + this->childStart[s + 1]);
+    }
+    std::sort(this->top.begin(), this->top.end());
+
+    this->subtrees.clear();
+    for (int s : candidates)
+    {
+        const Supernode &supernode = this->supernodes[s];
+        Subtree subtree = {firstDescendant[s], s + 1, supernode.first + supernode.columns - 1, work[s]};
+        this->subtrees.push_back(subtree);
+    }
+    // the heavy subtrees first, the light ones fill the gaps
+    std::sort(this->subtrees.begin(), this->subtrees.end(), [](const Subtree &a, const Subtree &b) { return a.work > b.work; });
+
+    this->topColumns.clear();
+    for (int s : this->top)
+        for (int j = 0; j < this->supernodes[s].columns; j++)
+            this->topColumns.push_back(this->supernodes[s].first + j);
+
+    // work buffers for the largest number of threads getThreads() can return
+    const int threads = this->getThreads(LASPARSECHOLESKY_PARALLEL_WORK);
+    const int n = this->dimension;
+    this->positions.assign(threads, vector<int>(n));
+    this->fronts.resize(threads);
+    this->outside.assign(threads > 1 ? threads : 0, vector<double>(n, 0.0));
+}
+/*======================================================================*/
+void LaSparseCholesky::setThreadNumber(int threads)
+{
+    this->threadNumber = threads;
+    if (this->analyzed)
+        this->partition();
+}
+/*======================================================================*/
+int LaSparseCholesky::getThreads(double work) const
+{
+    if (work < LASPARSECHOLESKY_PARALLEL_WORK || this->subtrees.size() < 2)
+        return 1;
+    int threads = this->threadNumber > 0 ? this->threadNumber : (int)std::thread::hardware_concurrency();
+    return std::max(1, std::min(threads, (int)this->subtrees.size()));
+}
+/*======================================================================*/
+bool LaSparseCholesky::factorize(const LaSparseMatrix &matrix)
+{
+    if (!this->fits(matrix))
+        this->analyze(matrix);
+    TMC_TRACE_SCOPE("sparse Cholesky factorization", "algebra");
+    this->factorized = false;
+    const double *values = matrix.values();
+    const int n = this->dimension;
+
+    std::atomic<bool> positive(true);
+    const int threads = this->getThreads(this->totalWork);
+    if (threads > 1)
+    {
+        std::atomic<int> next(0);
+        this->pool.run(threads, [&](int thread) {
+            for (int t = next++; t < (int)this->subtrees.size() && positive; t = next++)
+                for (int s = this->subtrees[t].begin; s < this->subtrees[t].end && positive; s++)
+                    if (!this->factorizeSupernode(s, values, this->positions[thread], this->fronts[thread]))
+                        positive = false;
+        });
+        for (size_t k = 0; k < this->top.size() && positive; k++)
+            positive = this->factorizeSupernode(this->top[k], values, this->positions[0], this->fronts[0]);
+    }
+    else
+    {
+        for (int s = 0; s < (int)this->supernodes.size() && positive; s++)
+            positive = this->factorizeSupernode(s, values, this->positions[0], this->fronts[0]);
+    }
+    for (size_t s = 0; s < this->updates.size(); s++)
+        vector<double>().swap(this->updates[s]);
+    this->factorized = positive;
+    return this->factorized;
+}
+/*======================================================================*/
+bool LaSparseCholesky::factorizeSupernode(int s, const double *values, std::vector<int> &position, std::vector<double> &front)
+{
+    const Supernode &supernode = this->supernodes[s];
+    const int m = supernode.rows;
+    const int k = supernode.columns;
+    const int *rows = &this->rowPattern[supernode.pattern];
+    front.assign((size_t)m * m, 0.0);
+
+    for (int a = this->assemblyStart[s]; a < this->assemblyStart[s + 1]; a++)
+        front[this->assemblyTarget[a]] += values[this->assemblySource[a]];
+
+    // extend-add of the update matrices of the children
+    for (int i = 0; i < m; i++)
+        position[rows[i]] = i;
+    for (int c = this->childStart[s]; c < this->childStart[s + 1]; c++)
+    {
+        const int child = this->children[c];
+        const Supernode &childnode = this->supernodes[child];
+        const int mc = childnode.rows - childnode.columns;
+        const int *childrows = &this->rowPattern[childnode.pattern] + childnode.columns;
+        vector<double> &update = this->updates[child];
+        for (int jj = 0; jj < mc; jj++)
+        {
+            double *column = &front[(size_t)position[childrows[jj]] * m];
+            const double *source = &update[(size_t)jj * mc];
+            for (int ii = jj; ii < mc; ii++)
+                column[position[childrows[ii]]] += source[ii];
+        }
+        vector<double>().swap(update);
+    }
+
+    if (!LaSparseCholesky::factorizeFront(front.data(), m, k))
+        return false;
+
+    std::memcpy(&this->factorValues[supernode.factor], front.data(), (size_t)m * k * sizeof(double));
+    const int mu = m - k;
+    if (mu > 0)
+    {
+        vector<double> &update = this->updates[s];
+        update.resize((size_t)mu * mu);
+        for (int jj = 0; jj < mu; jj++)
+            std::memcpy(&update[(size_t)jj * mu + jj], &front[(size_t)(k + jj) * m + k + jj], (size_t)(mu - jj) * sizeof(double));
+    }
+    return true;
+}
+/*======================================================================*/
+/**
+  Right-looking blocked Cholesky: a panel of columns is factorized left-looking, the columns
+  right of it (the remaining columns of the supernode and the update matrix) get the rank
+  update of the panel, four panel columns into two target columns at a time.
+*/
+bool LaSparseCholesky::factorizeFront(double *front, int m, int k)
+{
+    for (int jb = 0; jb < k; jb += LASPARSECHOLESKY_PANEL)
+    {
+        const int je = std::min(k, jb + LASPARSECHOLESKY_PANEL);
+        for (int j = jb; j < je; j++)
+        {
+            double *lj = front + (size_t)j * m;
+            for (int p = jb; p < j; p++)
+            {
+                const double *lp = front + (size_t)p * m;
+                const double ljp = lp[j];
+                for (int i = j; i < m; i++)
+                    lj[i] -= lp[i] * ljp;
+            }
+            if (!(lj[j] > 0.0))
+                return false; //< not positive definite
+            const double d = std::sqrt(lj[j]);
+            lj[j] = d;
+            const double inverse = 1.0 / d;
+            for (int i = j + 1; i < m; i++)
+                lj[i] *= inverse;
+        }
+        // two target columns share the loads of the panel columns
+        int c = je;
+        for (; c + 1 < m; c += 2)
+        {
+            double *lc = front + (size_t)c * m;
+            double *ld = lc + m;
+            int p = jb;
+            for (; p + 3 < je; p += 4)
+            {
+                const double *l0 = front + (size_t)p * m;
+                const double *l1 = l0 + m;
+                const double *l2 = l1 + m;
+                const double *l3 = l2 + m;
+                const double a0 = l0[c], a1 = l1[c], a2 = l2[c], a3 = l3[c];
+                const double b0 = l0[c + 1], b1 = l1[c + 1], b2 = l2[c + 1], b3 = l3[c + 1];
+                lc[c] -= a0 * l0[c] + a1 * l1[c] + a2 * l2[c] + a3 * l3[c];
+                for (int i = c + 1; i < m; i++)
+                {
+                    const double x0 = l0[i], x1 = l1[i], x2 = l2[i], x3 = l3[i];
+                    lc[i] -= a0 * x0 + a1 * x1 + a2 * x2 + a3 * x3;
+                    ld[i] -= b0 * x0 + b1 * x1 + b2 * x2 + b3 * x3;
+                }
+            }
+            for (; p < je; p++)
+            {
+                const double *lp = front + (size_t)p * m;
+                const double a = lp[c], b = lp[c + 1];
+                lc[c] -= a * lp[c];
+                for (int i = c + 1; i < m; i++)
+                {
+                    lc[i] -= a * lp[i];
+                    ld[i] -= b * lp[i];
+                }
+            }
+        }
+        if (c < m)
+        {
+            double *lc = front + (size_t)c * m;
+            for (int p = jb; p < je; p++)
+            {
+                const double *lp = front + (size_t)p * m;
+                lc[c] -= lp[c] * lp[c];
+            }
+        }
+    }
+    return true;
+}
+/*======================================================================*/
+/**
+  L y = b for the columns of the supernode, the contributions to rows after lastColumn go to
+  outside if it is not NULL (rows of the top of the tree while subtrees run in parallel).
+*/
+void LaSparseCholesky::forward(int s, double *x, double *outside, int lastColumn) const
+{
+    const Supernode &supernode = this->supernodes[s];
+    const int m = supernode.rows;
+    const int k = supernode.columns;
+    const int *rows = &this->rowPattern[supernode.pattern];
+    const double *l = &this->factorValues[supernode.factor];
+    double *xs = x + supernode.first;
+    const int split = outside ? (int)(std::upper_bound(rows + k, rows + m, lastColumn) - rows) : m;
+    for (int j = 0; j < k; j++)
+    {
+        const double *lj = l + (size_t)j * m;
+        const double xj = xs[j] / lj[j];
+        xs[j] = xj;
+        for (int i = j + 1; i < k; i++)
+            xs[i] -= lj[i] * xj;
+        for (int i = k; i < split; i++)
+            x[rows[i]] -= lj[i] * xj;
+        for (int i = split; i < m; i++)
+            outside[rows[i]] -= lj[i] * xj;
+    }
+}
+/*======================================================================*/
+/** L<SUP>T</SUP> x = y for the columns of the supernode, the rows below are solved already */
+void LaSparseCholesky::backward(int s, double *x) const
+{
+    const Supernode &supernode = this->supernodes[s];
+    const int m = supernode.rows;
+    const int k = supernode.columns;
+    const int *rows = &this->rowPattern[supernode.pattern];
+    const double *l = &this->factorValues[supernode.factor];
+    double *xs = x + supernode.first;
+    for (int j = k - 1; j >= 0; j--)
+    {
+        const double *lj = l + (size_t)j * m;
+        double sum = xs[j];
+        for (int i = j + 1; i < k; i++)
+            sum -= lj[i] * xs[i];
+        for (int i = k; i < m; i++)
+            sum -= lj[i] * x[rows[i]];
+        xs[j] = sum / lj[j];
+    }
+}
+/*======================================================================*/
+void LaSparseCholesky::solve(double *vektor) const
+{
+    if (!this->factorized)
+        throw TmcException(UB_EXARGS, "LaSparseCholesky - the matrix is not factorized");
+    TMC_TRACE_SCOPE("sparse Cholesky solve", "algebra");
+    const int n = this->dimension;
+    double *x = &this->reordered[0];
+    this->ordering.apply(vektor, x);
+
+    const int supernodeNumber = (int)this->supernodes.size();
+    const int threads = this->getThreads(4.0 * this->factorNonZeros);
+    if (threads > 1)
+    {
+        const int taskNumber = (int)this->subtrees.size();
+        std::atomic<int> next(0);
+        this->pool.run(threads, [&](int thread) {
+            double *contributions = this->outside[thread].data();
+            for (int t = next++; t < taskNumber; t = next++)
+                for (int s = this->subtrees[t].begin; s < this->subtrees[t].end; s++)
+                    this->forward(s, x, contributions, this->subtrees[t].lastColumn);
+        });
+        // the subtrees contribute to the rows of the top only
+        for (int t = 0; t < threads; t++)
+        {
+            double *contributions = this->outside[t].data();
+            for (int i : this->topColumns)
+            {
+                x[i] += contributions[i];
+                contributions[i] = 0.0;
+            }
+        }
+        for (size_t k = 0; k < this->top.size(); k++)
+            this->forward(this->top[k], x, NULL, n);
+
+        for (int k = (int)this->top.size() - 1; k >= 0; k--)
+            this->backward(this->top[k], x);
+        next = 0;
+        this->pool.run(threads, [&](int) {
+            for (int t = next++; t < taskNumber; t = next++)
+                for (int s = this->subtrees[t].end - 1; s >= this->subtrees[t].begin; s--)
+                    this->backward(s, x);
+        });
+    }
+    else
+    {
+        for (int s = 0; s < supernodeNumber; s++)
+            this->forward(s, x, NULL, n);
+        for (int s = supernodeNumber - 1; s >= 0; s--)
+            this->backward(s, x);
+    }
+    this->ordering.applyInverse(x, vektor);
+}
+/*======================================================================*/
+std::string LaSparseCholesky::toString() const
+{
+    stringstream ss;
+    ss << "LaSparseCholesky[n=" << this->dimension << ", nonzeros=" << this->patternRows.size() << ", factor nonzeros=" << this->factorNonZeros
+       << ", supernodes=" << this->supernodes.size() << ", subtrees=" << this->subtrees.size() << ", factorized=" << this->factorized << "]";
+    return ss.str();
+}
@@ -0,0 +1,152 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    supernodal sparse Cholesky factorization with symbolic and numeric phase
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LASPARSECHOLESKY_H
+#define LASPARSECHOLESKY_H
+
+#include <string>
+#include <vector>
+
+#include "./LaPermutation.h"
+#include "./LaSparseMatrix.h"
+#include "./LaWorkerPool.h"
+#include <TmcMacroFile.h>
+
+/**
+  Supernodal sparse Cholesky factorization P A P<SUP>T</SUP> = L L<SUP>T</SUP> of a symmetric
+  positive definite LaSparseMatrix.
+  <BR><BR>
+  The work is split into a symbolic and a numeric part. analyze() depends only on the pattern
+  and runs once per mesh: minimum degree ordering, elimination tree in postorder, supernodes
+  (columns with the same pattern below the diagonal) and the map from the entries of the matrix
+  into the frontal matrices. factorize() repeats only the numeric part as long as the pattern
+  stays the same, e.g. when the time step changes the effective matrix of an initial value solver.
+  <BR><BR>
+  The numeric factorization is multifrontal: every supernode assembles its entries and the
+  update matrices of its children into a dense front, which is factorized with a blocked dense
+  kernel. Independent subtrees of the elimination tree are factorized and solved in parallel,
+  the remaining top of the tree afterwards. The threads and their work buffers are kept from
+  one factorization and solve to the next.
+  <BR><BR>
+  If the pattern is symmetric, only the entries of one triangle of each symmetric pair are read,
+  a pattern with only one triangle is used as it is.
+*/
+class TMC_DLL_EXPORT LaSparseCholesky
+{
+public:
+    LaSparseCholesky();
+
+    /** symbolic analysis of the pattern, the values are not used */
+    void analyze(const LaSparseMatrix &matrix);
+    bool isAnalyzed() const { return this->analyzed; }
+    /** true if the matrix has the pattern of the analysis */
+    bool fits(const LaSparseMatrix &matrix) const;
+    /**
+      Numeric factorization, the pattern is analyzed first if it differs from the analyzed one.
+      @return false if the matrix is not positive definite
+    */
+    bool factorize(const LaSparseMatrix &matrix);
+    bool isFactorized() const { return this->factorized; }
+    /** solves A x = b in place */
+    void solve(double *vektor) const;
+
+    /** number of threads for factorization and solve, 0 (default): one per hardware thread */
+    void setThreadNumber(int threads);
+
+    int getDimension() const { return this->dimension; }
+    int getSupernodeNumber() const { return (int)this->supernodes.size(); }
+    long getFactorNonZeros() const { return this->factorNonZeros; }
+    const LaPermutation &getOrdering() const { return this->ordering; }
+    std::string toString() const;
+
+private:
+    struct Supernode
+    {
+        int first;      //< first column
+        int columns;    //< number of columns
+        int rows;       //< rows of the front, the columns included
+        size_t pattern; //< offset of the rows in rowPattern
+        size_t factor;  //< offset of the columns of L (rows x columns, column-major) in factorValues
+        int parent;     //< -1 for a root
+    };
+    /** a range of supernodes which forms complete subtrees */
+    struct Subtree
+    {
+        int begin;
+        int end;
+        int lastColumn;
+        double work;
+    };
+
+    void partition();
+    int getThreads(double work) const;
+    bool factorizeSupernode(int s, const double *values, std::vector<int> &position, std::vector<double> &front);
+    void forward(int s, double *x, double *outside, int lastColumn) const;
+    void backward(int s, double *x) const;
+    /** partial Cholesky of the first k columns of the m x m front (column-major, lower part) */
+    static bool factorizeFront(double *front, int m, int k);
+
+    bool analyzed;
+    bool factorized;
+    int threadNumber;
+    int dimension;
+    std::vector<int> patternStart; //< the analyzed pattern
+    std::vector<int> patternRows;
+    LaPermutation ordering;
+    std::vector<Supernode> supernodes;
+    std::vector<int> rowPattern;
+    std::vector<int> childStart; //< children of the supernodes
+    std::vector<int> children;
+    std::vector<int> assemblyStart; //< entries of the matrix per supernode: value index and position in the front
+    std::vector<int> assemblySource;
+    std::vector<int> assemblyTarget;
+    std::vector<Subtree> subtrees;
+    std::vector<int> top; //< supernodes outside the subtrees, ascending
+    double totalWork;
+    long factorNonZeros;
+    std::vector<double> factorValues;
+    std::vector<std::vector<double> > updates;
+    mutable std::vector<double> reordered;
+
+    mutable LaWorkerPool pool;
+    std::vector<int> topColumns;                       //< columns of the top supernodes
+    std::vector<std::vector<int> > positions;          //< per thread: rows of the front
+    std::vector<std::vector<double> > fronts;          //< per thread: the front, keeps its largest size
+    mutable std::vector<std::vector<double> > outside; //< per thread: forward contributions to the top
+};
+
+#endif
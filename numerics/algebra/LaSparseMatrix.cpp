@@ -0,0 +1,238 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    square sparse matrix in compressed column storage
+
+\*---------------------------------------------------------------------------*/
+
+#include "./LaSparseMatrix.h"
+
+#include <common/utilities/TmcException.h>
+
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+
+/*======================================================================*/
+LaSparseMatrix::LaSparseMatrix() : dimension(0), columnstart(1, 0) {}
+/*======================================================================*/
+LaSparseMatrix::LaSparseMatrix(int dimension, std::string name) : name(name), dimension(dimension), columnstart(dimension + 1, 0)
+{
+    if (dimension < 0)
+        throw TmcException(UB_EXARGS, "LaSparseMatrix - negative dimension");
+}
+/*======================================================================*/
+LaSparseMatrix::LaSparseMatrix(const LaConstMatrixView &matrix, double tolerance, bool lower)
+    : dimension(matrix.getRowNumber()), columnstart(matrix.getRowNumber() + 1, 0)
+{
+    if (matrix.getRowNumber() != matrix.getColumnNumber())
+        throw TmcException(UB_EXARGS, "LaSparseMatrix - the matrix is not square");
+    const int n = this->dimension;
+    // the dense matrix is row-major, counting first keeps the copy at two passes
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < (lower ? i + 1 : n); j++)
+        {
+            const double a = matrix(i, j);
+            if (a > tolerance || a < -tolerance)
+                this->columnstart[j + 1]++;
+        }
+    for (int j = 0; j < n; j++)
+        this->columnstart[j + 1] += this->columnstart[j];
+    this->rowindex.resize(this->columnstart[n]);
+    this->value.resize(this->columnstart[n]);
+    vector<int> next(this->columnstart.begin(), this->columnstart.end() - 1);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < (lower ? i + 1 : n); j++)
+        {
+            const double a = matrix(i, j);
+            if (a > tolerance || a < -tolerance)
+            {
+                this->rowindex[next[j]] = i;
+                this->value[next[j]++] = a;
+            }
+        }
+}
+/*======================================================================*/
+int LaSparseMatrix::find(int row, int column) const
+{
+    if (row < 0 || row >= this->dimension || column < 0 || column >= this->dimension)
+        throw TmcException(UB_EXARGS, "LaSparseMatrix - index out of range");
+    const int *begin = this->rowindex.data() + this->columnstart[column];
+    const int *end = this->rowindex.data() + this->columnstart[column + 1];
+    const int *position = std::lower_bound(begin, end, row);
+    if (position == end || *position != row)
+        return -1;
+    return (int)(position - this->rowindex.data());
+}
+/*======================================================================*/
+void LaSparseMatrix::addValue(int row, int column, double value)
+{
+    const int position = this->find(row, column);
+    if (position >= 0)
+        this->value[position] += value;
+    else
+    {
+        Entry entry = {row, column, value};
+        this->pending.push_back(entry);
+    }
+}
+/*======================================================================*/
+void LaSparseMatrix::setValue(int row, int column, double value)
+{
+    const int position = this->find(row, column);
+    if (position >= 0)
+    {
+        this->value[position] = value;
+        return;
+    }
+    // a later set replaces earlier pending values of the entry
+    for (size_t k = 0; k < this->pending.size(); k++)
+        if (this->pending[k].row == row && this->pending[k].column == column)
+            this->pending[k].value = 0.0;
+    Entry entry = {row, column, value};
+    this->pending.push_back(entry);
+}
+/*======================================================================*/
+void LaSparseMatrix::setZero()
+{
+    std::fill(this->value.begin(), this->value.end(), 0.0);
+    for (size_t k = 0; k < this->pending.size(); k++)
+        this->pending[k].value = 0.0;
+}
+/*======================================================================*/
+void LaSparseMatrix::compress()
+{
+    if (this->pending.empty())
+        return;
+    const int n = this->dimension;
+    std::sort(this->pending.begin(), this->pending.end(),
+              [](const Entry &a, const Entry &b) { return a.column < b.column || (a.column == b.column && a.row < b.row); });
+
+    vector<int> start(n + 1, 0);
+    vector<int> rows;
+    vector<double> values;
+    rows.reserve(this->rowindex.size() + this->pending.size());
+    values.reserve(this->rowindex.size() + this->pending.size());
+    size_t k = 0;
+    for (int j = 0; j < n; j++)
+    {
+        // merge the sorted column with the sorted pending entries of the column
+        int p = this->columnstart[j];
+        const int end = this->columnstart[j + 1];
+        while (p < end || (k < this->pending.size() && this->pending[k].column == j))
+        {
+            const bool old = p < end && (k == this->pending.size() || this->pending[k].column != j || this->rowindex[p] <= this->pending[k].row);
+            const int row = old ? this->rowindex[p] : this->pending[k].row;
+            const double a = old ? this->value[p++] : this->pending[k++].value;
+            if (!rows.empty() && (int)rows.size() > start[j] && rows.back() == row)
+                values.back() += a;
+            else
+            {
+                rows.push_back(row);
+                values.push_back(a);
+            }
+        }
+        start[j + 1] = (int)rows.size();
+    }
+    this->columnstart.swap(start);
+    this->rowindex.swap(rows);
+    this->value.swap(values);
+    this->pending.clear();
+}
+/*======================================================================*/
+void LaSparseMatrix::checkCompressed() const
+{
+    if (!this->pending.empty())
+        throw TmcException(UB_EXARGS, "LaSparseMatrix - the matrix has to be compressed");
+}
+/*======================================================================*/
+double LaSparseMatrix::getValue(int row, int column) const
+{
+    this->checkCompressed();
+    const int position = this->find(row, column);
+    return position >= 0 ? this->value[position] : 0.0;
+}
+/*======================================================================*/
+void LaSparseMatrix::multiply(const double *x, double *y) const
+{
+    this->checkCompressed();
+    std::fill(y, y + this->dimension, 0.0);
+    for (int j = 0; j < this->dimension; j++)
+    {
+        const double xj = x[j];
+        for (int p = this->columnstart[j]; p < this->columnstart[j + 1]; p++)
+            y[this->rowindex[p]] += this->value[p] * xj;
+    }
+}
+/*======================================================================*/
+bool LaSparseMatrix::hasSamePattern(const LaSparseMatrix &matrix) const
+{
+    this->checkCompressed();
+    matrix.checkCompressed();
+    return this->dimension == matrix.dimension && this->columnstart == matrix.columnstart && this->rowindex == matrix.rowindex;
+}
+/*======================================================================*/
+const int *LaSparseMatrix::columnStart() const
+{
+    this->checkCompressed();
+    return this->columnstart.data();
+}
+/*======================================================================*/
+const int *LaSparseMatrix::rowIndex() const
+{
+    this->checkCompressed();
+    return this->rowindex.data();
+}
+/*======================================================================*/
+const double *LaSparseMatrix::values() const
+{
+    this->checkCompressed();
+    return this->value.data();
+}
+/*======================================================================*/
+double *LaSparseMatrix::values()
+{
+    this->checkCompressed();
+    return this->value.data();
+}
+/*======================================================================*/
+std::string LaSparseMatrix::toString() const
+{
+    stringstream ss;
+    ss << "LaSparseMatrix[" << this->name << ", n=" << this->dimension << ", nonzeros=" << this->rowindex.size();
+    if (!this->pending.empty())
+        ss << ", pending=" << this->pending.size();
+    ss << "]";
+    return ss.str();
+}
@@ -0,0 +1,125 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    square sparse matrix in compressed column storage
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LASPARSEMATRIX_H
+#define LASPARSEMATRIX_H
+
+#include <string>
+#include <vector>
+
+#include "./LaView.h"
+#include <TmcMacroFile.h>
+
+/**
+  Square sparse matrix in compressed column storage.
+  <BR><BR>
+  The matrix is assembled in two phases: addValue() and setValue() change entries of the
+  pattern directly, entries outside the pattern are collected and merged into the pattern by
+  compress(). After the first assembly of a mesh the pattern stays fixed, the values are set to
+  zero with setZero() and assembled again, so a factorization can keep its symbolic analysis
+  (see LaSparseCholesky). Read access requires a compressed matrix.
+  <BR><BR>
+  Example:
+  <PRE>
+    LaSparseMatrix a(n);
+    for (...) a.addValue(i, j, value); //duplicates are summed
+    a.compress();
+  </PRE>
+*/
+class TMC_DLL_EXPORT LaSparseMatrix
+{
+public:
+    LaSparseMatrix();
+    explicit LaSparseMatrix(int dimension, std::string name = "");
+    /**
+      Copies a dense matrix, entries with |a<SUB>ij</SUB>| <= tolerance are left out.
+      @param lower true: only the lower triangle (i >= j) is stored, e.g. for LaSparseCholesky
+    */
+    explicit LaSparseMatrix(const LaConstMatrixView &matrix, double tolerance = 0.0, bool lower = false);
+
+    int getRowNumber() const { return this->dimension; }
+    int getColumnNumber() const { return this->dimension; }
+    long getNonZeros() const { return (long)this->rowindex.size(); }
+    std::string getName() const { return this->name; }
+
+    /** adds the value, the entry is created if it is not in the pattern */
+    void addValue(int row, int column, double value);
+    /** sets the value, the entry is created if it is not in the pattern */
+    void setValue(int row, int column, double value);
+    /** sets all values to zero, the pattern is kept */
+    void setZero();
+    /** merges the entries which are not yet in the pattern, duplicates are summed */
+    void compress();
+    bool isCompressed() const { return this->pending.empty(); }
+
+    double getValue(int row, int column) const;
+    /** position of the entry in values(), -1 if it is not in the pattern */
+    int getPosition(int row, int column) const { return this->find(row, column); }
+
+    /** y = A x */
+    void multiply(const double *x, double *y) const;
+    /** true if the patterns are equal (not the values) */
+    bool hasSamePattern(const LaSparseMatrix &matrix) const;
+
+    /** compressed columns: the rows and values of column j are at columnStart()[j] ... columnStart()[j + 1] - 1, rows ascending */
+    const int *columnStart() const;
+    const int *rowIndex() const;
+    const double *values() const;
+    double *values();
+
+    std::string toString() const;
+
+private:
+    struct Entry
+    {
+        int row;
+        int column;
+        double value;
+    };
+    /** position of the entry in rowindex/value, -1 if it is not in the pattern */
+    int find(int row, int column) const;
+    void checkCompressed() const;
+
+    std::string name;
+    int dimension;
+    std::vector<int> columnstart;
+    std::vector<int> rowindex;
+    std::vector<double> value;
+    std::vector<Entry> pending;
+};
+
+#endif
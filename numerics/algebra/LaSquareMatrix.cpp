@@ -40,17 +40,64 @@
 \*---------------------------------------------------------------------------*/
 
 #include "./LaSquareMatrix.h"
+#include "./LaAllocator.h"
+#include "./LaBinaryFormat.h"
 #include <common/utilities/TmcFileInput.h>
 #include <common/utilities/TmcFileOutput.h>
+#include <common/utilities/TmcFileInputBinary.h>
+#include <common/utilities/TmcFileOutputBinary.h>
+#include <common/utilities/TmcTrace.h>
+
+#include <algorithm>
 
 using namespace std;
 
+/*======================================================================*/
+/**
+  Distance of two rows, rows are padded to a multiple of 8 values (64 bytes).
+*/
+static int rowStride(int columns)
+{
+    return (columns + 7) & ~7;
+}
+/**
+  Row pointers into one 64 byte aligned block (LaAllocator), every row starts at a cache line.
+  The values are initialized with 0.0.
+*/
+static double **allocateRows(int rows, int columns)
+{
+    double **back = new double *[rows > 0 ? rows : 1];
+    if (rows <= 0)
+    {
+        back[0] = NULL;
+        return back;
+    }
+    const size_t stride = (size_t)rowStride(columns);
+    double *storage = LaAllocator::allocate<double>((size_t)rows * stride);
+    for (int i = 0; i < rows; i++)
+    {
+        back[i] = storage + (size_t)i * stride;
+        for (int j = 0; j < columns; j++)
+            back[i][j] = 0.0;
+    }
+    return back;
+}
+static void freeRows(double **rows)
+{
+    if (!rows)
+        return;
+    if (rows[0])
+        LaAllocator::deallocate(rows[0]);
+    delete[] rows;
+}
+
 /**
   Creates a square matrix with no rows and columns.
 */
 LaSquareMatrix::LaSquareMatrix() : LaObject("LaSquareMatrix")
 {
     this->Init(0);
+    this->value = NULL;
 }
 /**
   Creates a square matrix with the specified dimension and initial values 0.0.
@@ -59,12 +106,7 @@ LaSquareMatrix::LaSquareMatrix() : LaObject("LaSquareMatrix")
 LaSquareMatrix::LaSquareMatrix(int dimension) : LaObject("LaSquareMatrix")
 {
     this->Init(dimension);
-    this->value = new double *[dimension];
-    for (int i = 0; i < dimension; i++)
-        this->value[i] = new double[dimension];
-    for (int i = 0; i < dimension; i++)
-        for (int j = 0; j < dimension; j++)
-            this->value[i][j] = 0.0;
+    this->value = allocateRows(dimension, dimension);
 }
 /**
   Creates a square matrix from the specified twodimensional double-array.
@@ -75,9 +117,7 @@ LaSquareMatrix::LaSquareMatrix(double **doublearray, int dimension) : LaObject("
 {
     // cout<<"Dimension:"<<dimension;
     this->Init(dimension);
-    this->value = new double *[dimension];
-    for (int i = 0; i < dimension; i++)
-        this->value[i] = new double[dimension];
+    this->value = allocateRows(dimension, dimension);
     for (int i = 0; i < dimension; i++)
         for (int j = 0; j < dimension; j++)
             this->value[i][j] = doublearray[i][j];
@@ -90,9 +130,7 @@ LaSquareMatrix::LaSquareMatrix(LaSquareMatrix *matrix) : LaObject(matrix->name)
 {
     int dimension = matrix->getRowNumber();
     this->Init(dimension);
-    this->value = new double *[dimension];
-    for (int i = 0; i < dimension; i++)
-        this->value[i] = new double[dimension];
+    this->value = allocateRows(dimension, dimension);
 
     for (int i = 0; i < dimension; i++)
         for (int j = 0; j < dimension; j++)
@@ -102,9 +140,7 @@ LaSquareMatrix::LaSquareMatrix(LaSquareMatrix *matrix, string name) : LaObject(n
 {
     int dimension = matrix->getRowNumber();
     this->Init(dimension);
-    this->value = new double *[dimension];
-    for (int i = 0; i < dimension; i++)
-        this->value[i] = new double[dimension];
+    this->value = allocateRows(dimension, dimension);
 
     for (int i = 0; i < dimension; i++)
         for (int j = 0; j < dimension; j++)
@@ -133,6 +169,7 @@ LaSquareMatrix::LaSquareMatrix(LaSquareMatrix *matrix, string name) : LaObject(n
 LaSquareMatrix::LaSquareMatrix(string name) : LaObject(name)
 {
     this->Init(0);
+    this->value = NULL;
 }
 /**
   Creates a square matrix with the specified dimension, initial values 0.0 and the specified name.
@@ -142,22 +179,166 @@ LaSquareMatrix::LaSquareMatrix(string name) : LaObject(name)
 LaSquareMatrix::LaSquareMatrix(int dimension, string name) : LaObject(name)
 {
     this->Init(dimension);
-    this->value = new double *[dimension];
-    for (int i = 0; i < dimension; i++)
-        this->value[i] = new double[dimension];
+    this->value = allocateRows(dimension, dimension);
+}
+/**
+  Creates a square matrix as copy of the specified square matrix. Only the values and the name
+  are copied, factorizations and eigensystem are recomputed when they are needed.
+*/
+LaSquareMatrix::LaSquareMatrix(const LaSquareMatrix &matrix) : LaObject(matrix.name)
+{
+    int dimension = matrix.rows;
+    this->Init(dimension);
+    this->value = allocateRows(dimension, dimension);
     for (int i = 0; i < dimension; i++)
         for (int j = 0; j < dimension; j++)
-            this->value[i][j] = 0.0;
+            this->value[i][j] = matrix.value[i][j];
+}
+/**
+  Takes over values, factorizations and eigensystem of the specified matrix,
+  which is left as matrix with no rows and columns.
+*/
+LaSquareMatrix::LaSquareMatrix(LaSquareMatrix &&matrix) : LaObject(matrix.name)
+{
+    this->Init(0);
+    this->value = NULL;
+    this->swap(matrix);
 }
 LaSquareMatrix::~LaSquareMatrix()
 {
-    if (this->value)
+    this->release();
+}
+/**
+  Copies the values, the name of this matrix is kept.
+  If the dimensions are equal, the storage is reused.
+*/
+LaSquareMatrix &LaSquareMatrix::operator=(const LaSquareMatrix &matrix)
+{
+    if (this == &matrix)
+        return *this;
+    if (this->rows != matrix.rows || this->value == NULL)
     {
-        for (int i = 0; i < rows; i++)
-            delete[] value[i];
-        delete[] value;
-        this->value = NULL;
+        this->release();
+        this->Init(matrix.rows);
+        this->value = allocateRows(matrix.rows, matrix.rows);
+    }
+    for (int i = 0; i < this->rows; i++)
+        for (int j = 0; j < this->columns; j++)
+            this->value[i][j] = matrix.value[i][j];
+    this->setInconsistent();
+    return *this;
+}
+/**
+  Takes over the storage of the specified matrix, the name of this matrix is kept.
+*/
+LaSquareMatrix &LaSquareMatrix::operator=(LaSquareMatrix &&matrix)
+{
+    if (this != &matrix)
+    {
+        std::string ownName = this->name;
+        this->swap(matrix);
+        this->name = ownName;
+        matrix.release();
+        matrix.Init(0);
     }
+    return *this;
+}
+/**
+  Exchanges values, names, factorizations and eigensystems of two matrices.
+*/
+void LaSquareMatrix::swap(LaSquareMatrix &matrix)
+{
+    std::swap(this->name, matrix.name);
+    std::swap(this->isDiagonal, matrix.isDiagonal);
+    std::swap(this->diagonalChecked, matrix.diagonalChecked);
+    std::swap(this->isTriDiagonal, matrix.isTriDiagonal);
+    std::swap(this->triDiagonalChecked, matrix.triDiagonalChecked);
+    std::swap(this->isIdentity, matrix.isIdentity);
+    std::swap(this->identityChecked, matrix.identityChecked);
+    std::swap(this->isScaledIdentity, matrix.isScaledIdentity);
+    std::swap(this->identityScale, matrix.identityScale);
+    std::swap(this->scaledIdentityChecked, matrix.scaledIdentityChecked);
+    std::swap(this->isSymmetric, matrix.isSymmetric);
+    std::swap(this->symmetricChecked, matrix.symmetricChecked);
+    std::swap(this->isAntisymmetric, matrix.isAntisymmetric);
+    std::swap(this->antisymmetricChecked, matrix.antisymmetricChecked);
+    std::swap(this->isOrthogonal, matrix.isOrthogonal);
+    std::swap(this->orthogonalChecked, matrix.orthogonalChecked);
+    std::swap(this->structure, matrix.structure);
+    std::swap(this->structureChecked, matrix.structureChecked);
+    std::swap(this->structuredsolver, matrix.structuredsolver);
+    std::swap(this->structuredconsistent, matrix.structuredconsistent);
+    std::swap(this->ordering, matrix.ordering);
+    std::swap(this->reordered, matrix.reordered);
+    std::swap(this->value, matrix.value);
+    std::swap(this->rows, matrix.rows);
+    std::swap(this->columns, matrix.columns);
+    std::swap(this->lufactorization, matrix.lufactorization);
+    std::swap(this->permutations, matrix.permutations);
+    std::swap(this->rowinterchanges, matrix.rowinterchanges);
+    std::swap(this->LUconsistent, matrix.LUconsistent);
+    std::swap(this->isNearlySingular, matrix.isNearlySingular);
+    std::swap(this->decompositionBehaviour, matrix.decompositionBehaviour);
+    std::swap(this->singularEpsilon, matrix.singularEpsilon);
+    std::swap(this->updaterows, matrix.updaterows);
+    std::swap(this->updatedifference, matrix.updatedifference);
+    std::swap(this->updatesolution, matrix.updatesolution);
+    std::swap(this->capacitance, matrix.capacitance);
+    std::swap(this->LUupdatable, matrix.LUupdatable);
+    std::swap(this->lufactorization2, matrix.lufactorization2);
+    std::swap(this->permutations2, matrix.permutations2);
+    std::swap(this->leftunknownsize, matrix.leftunknownsize);
+    std::swap(this->rightunknownsize, matrix.rightunknownsize);
+    std::swap(this->leftunknown, matrix.leftunknown);
+    std::swap(this->rightunknown, matrix.rightunknown);
+    std::swap(this->LUconsistent2, matrix.LUconsistent2);
+    std::swap(this->isNearlySingular2, matrix.isNearlySingular2);
+    std::swap(this->factoredunknown, matrix.factoredunknown);
+    std::swap(this->factoredposition, matrix.factoredposition);
+    std::swap(this->removedunknown, matrix.removedunknown);
+    std::swap(this->addedunknown, matrix.addedunknown);
+    std::swap(this->removedsolution, matrix.removedsolution);
+    std::swap(this->addedsolution, matrix.addedsolution);
+    std::swap(this->removedmatrix, matrix.removedmatrix);
+    std::swap(this->schurcomplement, matrix.schurcomplement);
+    std::swap(this->borderconsistent, matrix.borderconsistent);
+    std::swap(this->eigenvectors, matrix.eigenvectors);
+    std::swap(this->eigenvalues, matrix.eigenvalues);
+    std::swap(this->eigenvaluesI, matrix.eigenvaluesI);
+    std::swap(this->solvedEigensystem, matrix.solvedEigensystem);
+}
+/**
+  Frees values, factorizations and eigensystem.
+*/
+void LaSquareMatrix::release()
+{
+    freeRows(this->value);
+    this->value = NULL;
+    freeRows(this->lufactorization);
+    this->lufactorization = NULL;
+    delete[] this->permutations;
+    this->permutations = NULL;
+    delete this->capacitance;
+    this->capacitance = NULL;
+    delete this->structuredsolver;
+    this->structuredsolver = NULL;
+    freeRows(this->lufactorization2);
+    this->lufactorization2 = NULL;
+    delete[] this->permutations2;
+    this->permutations2 = NULL;
+    this->leftunknown.clear();
+    this->rightunknown.clear();
+    delete this->removedmatrix;
+    this->removedmatrix = NULL;
+    delete this->schurcomplement;
+    this->schurcomplement = NULL;
+    delete this->eigenvectors;
+    this->eigenvectors = NULL;
+    delete this->eigenvalues;
+    this->eigenvalues = NULL;
+    delete this->eigenvaluesI;
+    this->eigenvaluesI = NULL;
+    this->setInconsistent();
 }
 /*======================================================================*/
 void LaSquareMatrix::Init(int dimension)
@@ -171,12 +352,19 @@ void LaSquareMatrix::Init(int dimension)
     triDiagonalChecked = false;
     isIdentity = false;
     identityChecked = false;
+    isScaledIdentity = false;
+    identityScale = 0.0;
+    scaledIdentityChecked = false;
     isSymmetric = false;
     symmetricChecked = false;
     isAntisymmetric = false;
     antisymmetricChecked = false;
     isOrthogonal = false;
     orthogonalChecked = false;
+    structureChecked = false;
+    structuredsolver = NULL;
+    structuredconsistent = false;
+    reordered = false;
     lufactorization = NULL;
     permutations = NULL;
     rowinterchanges = 1;
@@ -184,14 +372,28 @@ void LaSquareMatrix::Init(int dimension)
     isNearlySingular = false;
     decompositionBehaviour = false;
     singularEpsilon = 1.0e-10;
+    updaterows.clear();
+    updatedifference.clear();
+    updatesolution.clear();
+    capacitance = NULL;
+    LUupdatable = false;
     lufactorization2 = NULL;
     permutations2 = NULL;
     leftunknownsize = -1;
     rightunknownsize = -1;
-    leftunknown = NULL;
-    rightunknown = NULL;
+    leftunknown.clear();
+    rightunknown.clear();
     LUconsistent2 = false;
     isNearlySingular2 = false;
+    factoredunknown.clear();
+    factoredposition.clear();
+    removedunknown.clear();
+    addedunknown.clear();
+    removedsolution.clear();
+    addedsolution.clear();
+    removedmatrix = NULL;
+    schurcomplement = NULL;
+    borderconsistent = false;
     eigenvectors = NULL;
     eigenvalues = NULL;
     eigenvaluesI = NULL;
@@ -199,8 +401,16 @@ void LaSquareMatrix::Init(int dimension)
     solvedEigensystem = false;
 }
 
-int LaSquareMatrix::getRowNumber() { return (this->rows); }
-int LaSquareMatrix::getColumnNumber() { return (this->columns); }
+int LaSquareMatrix::getRowNumber() const { return (this->rows); }
+int LaSquareMatrix::getColumnNumber() const { return (this->columns); }
+LaMatrixView LaSquareMatrix::view()
+{
+    return LaMatrixView(this->value ? this->value[0] : NULL, this->rows, this->columns, rowStride(this->columns));
+}
+LaConstMatrixView LaSquareMatrix::view() const
+{
+    return LaConstMatrixView(this->value ? this->value[0] : NULL, this->rows, this->columns, rowStride(this->columns));
+}
 
 /**
   Sets the element specified by a rownumber and columnnumber
@@ -221,8 +431,9 @@ void LaSquareMatrix::setValue(int row, int column, double a)
         throw TmcException("LaSquareMatrix.setValue() - row out of range ");
     if (column >= this->columns)
         throw TmcException("LaSquareMatrix.setValue() - column out of range ");
+    const double difference = a - this->value[row][column];
     this->value[row][column] = a;
-    this->setInconsistent();
+    this->setInconsistent(row, column, difference);
 }
 /**
   Returns the number of rows/colums
@@ -302,7 +513,7 @@ double LaSquareMatrix::getSingularityEpsilon()
 void LaSquareMatrix::addValue(int row, int column, double a)
 {
     this->value[row][column] += a;
-    this->setInconsistent();
+    this->setInconsistent(row, column, a);
 }
 /**
   Subtracts the specified value from the element specified by a rownumber and columnnumber
@@ -314,7 +525,7 @@ void LaSquareMatrix::addValue(int row, int column, double a)
 void LaSquareMatrix::subtractValue(int row, int column, double a)
 {
     this->value[row][column] -= a;
-    this->setInconsistent();
+    this->setInconsistent(row, column, -a);
 }
 /**
   Multiplies the specified value to the element specified by a rownumber
@@ -325,8 +536,9 @@ void LaSquareMatrix::subtractValue(int row, int column, double a)
 */
 void LaSquareMatrix::multiplyValue(int row, int column, double a)
 {
+    const double old = this->value[row][column];
     this->value[row][column] *= a;
-    this->setInconsistent();
+    this->setInconsistent(row, column, this->value[row][column] - old);
 }
 /**
   Divides the element specified by a rownumber by the specified value
@@ -337,8 +549,9 @@ void LaSquareMatrix::multiplyValue(int row, int column, double a)
 */
 void LaSquareMatrix::divideByValue(int row, int column, double a)
 {
+    const double old = this->value[row][column];
     this->value[row][column] /= a;
-    this->setInconsistent();
+    this->setInconsistent(row, column, this->value[row][column] - old);
 }
 /**
   Subtracts the specified value from all elements
@@ -361,28 +574,85 @@ void LaSquareMatrix::setInconsistent()
     this->diagonalChecked = false;
     this->triDiagonalChecked = false;
     this->identityChecked = false;
+    this->scaledIdentityChecked = false;
     this->symmetricChecked = false;
     this->antisymmetricChecked = false;
     this->orthogonalChecked = false;
+    this->structureChecked = false;
+    this->structuredconsistent = false;
     this->LUconsistent = false;
+    this->LUupdatable = false;
     this->LUconsistent2 = false;
     this->solvedEigensystem = false;
 }
+/**
+  Like setInconsistent(), but a change of one element keeps the factorization usable: the
+  change is recorded as low rank update and solved with the Woodbury formula. Changes in
+  different rows increase the rank, once it exceeds rows / 8 the next solve factorizes again.
+*/
+void LaSquareMatrix::setInconsistent(int row, int column, double difference)
+{
+    if (difference == 0.0)
+        return; //< the values didn't change
+    const bool factorized = this->LUconsistent;
+    const bool updatable = factorized || this->LUupdatable;
+    this->setInconsistent();
+    if (!updatable)
+        return;
+    if (factorized)
+    {
+        updaterows.clear();
+        updatedifference.clear();
+        updatesolution.clear();
+        delete capacitance;
+        capacitance = NULL;
+    }
+
+    int k = (int)(std::find(updaterows.begin(), updaterows.end(), row) - updaterows.begin());
+    if (k == (int)updaterows.size())
+    {
+        if (8 * (k + 1) > this->rows)
+            return; //< factorizing again is cheaper
+        updaterows.push_back(row);
+        updatedifference.resize(updatedifference.size() + this->rows, 0.0);
+    }
+    updatedifference[(size_t)k * this->rows + column] += difference;
+    delete capacitance;
+    capacitance = NULL;
+    this->LUupdatable = true;
+}
 /*======================================================================*/
 
-LaVector *LaSquareMatrix::multiply(LaVector *vector)
+/**
+  Multiplies the square matrix with a vector.
+  @param vector vector to multiply with
+  @return the result-vector
+  @exception TmcException if sizes are incompatible
+*/
+LaVector LaSquareMatrix::multiply(const LaVector &vector) const
 {
     int n = this->rows;
     int m = this->columns;
-    int p = (int)vector->value->size();
+    int p = vector.getDimension();
     if (p != m)
         throw TmcException(".multiply(): incompatible sizes");
 
-    LaVector *back = new LaVector(n);
+    LaVector back(n);
     for (int i = 0; i < n; i++)
+    {
+        double sum = 0.0;
         for (int k = 0; k < m; k++)
-            (*back->value)[i] += value[i][k] * (*vector->value)[k];
-    return (back);
+            sum += value[i][k] * vector.elements()[k];
+        back.elements()[i] = sum;
+    }
+    return back;
+}
+/**
+  Multiplies the square matrix with a vector, the caller owns the result.
+*/
+LaVector *LaSquareMatrix::multiply(LaVector *vector)
+{
+    return new LaVector(this->multiply(*vector));
 }
 
 /**
@@ -391,18 +661,28 @@ LaVector *LaSquareMatrix::multiply(LaVector *vector)
   @return the result-matrix
   @exception ArrayIndexOutOfBoundsException if sizes are incompatible
 */
-LaSquareMatrix *LaSquareMatrix::multiply(LaSquareMatrix *matrix)
+LaSquareMatrix LaSquareMatrix::multiply(const LaSquareMatrix &matrix) const
 {
     int n = this->rows;
-    int p = matrix->getRowNumber();
+    int p = matrix.getRowNumber();
     if (p != n)
         throw TmcException("LaSquareMatrix.multiply()");
-    LaSquareMatrix *back = new LaSquareMatrix(n);
+    LaSquareMatrix back(n);
     for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++)
-            for (int k = 0; k < n; k++)
-                back->value[i][j] += this->value[i][k] * matrix->value[k][j];
-    return (back);
+        for (int k = 0; k < n; k++)
+        {
+            const double a = this->value[i][k];
+            for (int j = 0; j < n; j++)
+                back.value[i][j] += a * matrix.value[k][j];
+        }
+    return back;
+}
+/**
+  Multiplies the square matrix with another square matrix, the caller owns the result.
+*/
+LaSquareMatrix *LaSquareMatrix::multiply(LaSquareMatrix *matrix)
+{
+    return new LaSquareMatrix(this->multiply(*matrix));
 }
 
 /**
@@ -412,25 +692,7 @@ LaSquareMatrix *LaSquareMatrix::multiply(LaSquareMatrix *matrix)
 bool LaSquareMatrix::isDiagonalMatrix()
 {
     if (!this->diagonalChecked)
-    {
-        this->isDiagonal = false;
-        if (this->isSymmetricMatrix())
-        {
-            this->isDiagonal = true;
-            for (int i = 0; i < this->rows - 1; i++)
-            {
-                if (!this->isDiagonal)
-                    break;
-                for (int j = i + 1; j < columns; j++)
-                    if (std::fabs(value[i][j]) > 1e-10)
-                    {
-                        this->isDiagonal = false;
-                        break;
-                    }
-            }
-            this->diagonalChecked = true;
-        }
-    }
+        this->checkStructure();
     return (this->isDiagonal);
 }
 /**
@@ -440,25 +702,7 @@ bool LaSquareMatrix::isDiagonalMatrix()
 bool LaSquareMatrix::isTriDiagonalMatrix()
 {
     if (!this->triDiagonalChecked)
-    {
-        this->isTriDiagonal = false;
-        if (this->isSymmetricMatrix())
-        {
-            this->isTriDiagonal = true;
-            for (int i = 0; i < rows - 2; i++)
-            {
-                if (!this->isTriDiagonal)
-                    break;
-                for (int j = i + 2; j < rows; j++)
-                    if (std::fabs(this->value[i][j]) > 1e-10)
-                    {
-                        this->isTriDiagonal = false;
-                        break;
-                    }
-            }
-            this->triDiagonalChecked = true;
-        }
-    }
+        this->checkStructure();
     return (this->isTriDiagonal);
 }
 /**
@@ -468,21 +712,50 @@ bool LaSquareMatrix::isTriDiagonalMatrix()
 bool LaSquareMatrix::isIdentityMatrix()
 {
     if (!this->identityChecked)
+        this->checkStructure();
+    return (this->isIdentity);
+}
+/**
+  Returns true if all elements outside the diagonal are zero and the diagonal elements are equal.
+  Unlike isIdentityMatrix() there is no tolerance, a product with the matrix is exactly a scaling.
+  @param scale the diagonal element, if the matrix is a scaled identity
+*/
+bool LaSquareMatrix::isScaledIdentityMatrix(double *scale)
+{
+    if (!this->scaledIdentityChecked)
+        this->checkScaledIdentity();
+    if (scale && this->isScaledIdentity)
+        *scale = this->identityScale;
+    return this->isScaledIdentity;
+}
+/**
+  Returns true if all elements are zero.
+*/
+bool LaSquareMatrix::isZeroMatrix()
+{
+    double scale;
+    return this->isScaledIdentityMatrix(&scale) && scale == 0.0;
+}
+/**
+  Stops at the first element which does not fit, so a general matrix costs little.
+*/
+void LaSquareMatrix::checkScaledIdentity()
+{
+    this->isScaledIdentity = this->rows > 0;
+    this->identityScale = this->rows > 0 ? this->value[0][0] : 0.0;
+    for (int i = 0; i < this->rows && this->isScaledIdentity; i++)
     {
-        this->isIdentity = false;
-        if (this->isDiagonalMatrix())
+        const double *row = this->value[i];
+        for (int j = 0; j < this->columns; j++)
         {
-            this->isIdentity = true;
-            for (int i = 0; i < rows; i++)
-                if (std::fabs(this->value[i][i] - 1.0) > 1e-10)
-                {
-                    this->isIdentity = false;
-                    break;
-                }
-            this->identityChecked = true;
+            if (row[j] != (i == j ? this->identityScale : 0.0))
+            {
+                this->isScaledIdentity = false;
+                break;
+            }
         }
     }
-    return (this->isIdentity);
+    this->scaledIdentityChecked = true;
 }
 /**
   Returns true if this real matrix is symmetric (<B>A<SUP>T</SUP></B>=<B>A</B>). To be a symmetric matrix, the corresponding elements difference has to be less 10<SUP>-10</SUP>.
@@ -492,22 +765,98 @@ bool LaSquareMatrix::isIdentityMatrix()
 bool LaSquareMatrix::isSymmetricMatrix()
 {
     if (!this->symmetricChecked)
+        this->checkStructure();
+    return (this->isSymmetric);
+}
+/**
+  Sets the flags of diagonal, tridiagonal, identity and symmetric matrices with one pass over
+  the values (tolerance 10<SUP>-10</SUP>). Diagonal and tridiagonal matrices have to be symmetric.
+*/
+void LaSquareMatrix::checkStructure()
+{
+    const LaMatrixStructure checked = LaMatrixStructure::analyze(this->view(), 1e-10);
+    this->isSymmetric = checked.symmetric;
+    this->isDiagonal = checked.symmetric && checked.isDiagonal();
+    this->isTriDiagonal = checked.symmetric && checked.isTriDiagonal();
+    this->isIdentity = this->isDiagonal && checked.identity;
+    this->symmetricChecked = true;
+    this->diagonalChecked = true;
+    this->triDiagonalChecked = true;
+    this->identityChecked = true;
+}
+const LaMatrixStructure &LaSquareMatrix::getStructure()
+{
+    if (!this->structureChecked)
+    {
+        this->structure = LaMatrixStructure::analyze(this->view());
+        this->reordered = false;
+        // a permutation keeps symmetry, diagonal and dominance, so only the bandwidth can change
+        const bool withoutPivoting = this->structure.diagonallyDominant || (this->structure.symmetric && this->structure.positiveDiagonal);
+        if (withoutPivoting && this->structure.zeroRows == 0 &&
+            (this->structure.solver == LaMatrixStructure::SPARSE || this->structure.solver == LaMatrixStructure::CHOLESKY ||
+             this->structure.solver == LaMatrixStructure::DENSE))
+            this->reordered = this->reorder();
+        this->structureChecked = true;
+    }
+    return this->structure;
+}
+/**
+  Tries the kept ordering and, if it does not give a banded matrix (new pattern), a new
+  reverse Cuthill-McKee ordering. Sets the structure of the reordered matrix on success.
+*/
+bool LaSquareMatrix::reorder()
+{
+    bool fresh = false;
+    for (;;)
     {
-        this->isSymmetric = true;
-        for (int i = 0; i < rows - 1; i++)
+        if (this->ordering.getDimension() != this->rows || fresh)
         {
-            if (!this->isSymmetric)
-                break;
-            for (int j = i + 1; j < rows; j++)
-                if (std::fabs(this->value[i][j] - this->value[j][i]) > 1e-10)
-                {
-                    this->isSymmetric = false;
-                    break;
-                }
+            TMC_TRACE_SCOPE("reverse Cuthill-McKee ordering", "algebra");
+            this->ordering = LaPermutation::reverseCuthillMcKee(this->view());
+            fresh = true;
         }
-        this->symmetricChecked = true;
+        const LaMatrixStructure permuted = LaMatrixStructure::analyze(this->ordering.permute(this->view()));
+        if (permuted.solver == LaMatrixStructure::DIAGONAL || permuted.solver == LaMatrixStructure::TRIDIAGONAL ||
+            permuted.solver == LaMatrixStructure::BANDED)
+        {
+            this->structure = permuted;
+            return true;
+        }
+        if (fresh)
+            return false; //< the pattern has no narrow band in any order
+        fresh = true;
     }
-    return (this->isSymmetric);
+}
+const LaPermutation &LaSquareMatrix::getOrdering()
+{
+    static const LaPermutation none;
+    return this->getStructure().solver != LaMatrixStructure::DENSE && this->reordered ? this->ordering : none;
+}
+LaStructuredSolver *LaSquareMatrix::getStructuredSolver()
+{
+    if (this->LUconsistent || this->LUupdatable)
+        return NULL;
+    // the structured solvers don't pivot, the check for nearly singular matrices is the one of decomposeLU()
+    if (this->decompositionBehaviour)
+        return NULL;
+    if (this->getStructure().solver == LaMatrixStructure::DENSE)
+        return NULL;
+    if (!this->structuredconsistent)
+    {
+        TMC_TRACE_SCOPE("structured factorization", "algebra");
+        if (!this->structuredsolver)
+            this->structuredsolver = new LaStructuredSolver;
+        const bool factorized = this->reordered ? this->structuredsolver->factorize(this->view(), this->structure, this->ordering)
+                                                : this->structuredsolver->factorize(this->view(), this->structure);
+        if (!factorized)
+        {
+            // e.g. symmetric with positive diagonal, but not positive definite
+            this->structure.solver = LaMatrixStructure::DENSE;
+            return NULL;
+        }
+        this->structuredconsistent = true;
+    }
+    return this->structuredsolver;
 }
 /**
   Returns true if this real matrix is antisymmetric (<B>-A<SUP>T</SUP></B>=<B>A</B>).
@@ -565,20 +914,19 @@ LaSquareMatrix *LaSquareMatrix::inverse()
     try
     {
         int length = this->getColumnNumber();
-        vector<double> *vektor = new vector<double>;
-        vektor->resize(length, 0.0);
+        vector<double> vektor(length, 0.0);
         LaSquareMatrix *back = new LaSquareMatrix(length);
 
         decomposeLU();
         for (int i = 0; i < length; i++)
         {
             for (int j = 0; j < length; j++)
-                (*vektor)[j] = 0.0;
-            (*vektor)[i] = 1.0;
+                vektor[j] = 0.0;
+            vektor[i] = 1.0;
 
-            vector<double> *result = substituteLUback(vektor);
+            substituteLUback(vektor.data());
             for (int j = 0; j < length; j++)
-                back->value[j][i] = (*result)[j];
+                back->value[j][i] = vektor[j];
         }
         return (back);
     }
@@ -683,16 +1031,45 @@ LaSquareMatrix *LaSquareMatrix::getEigenvectors()
 */
 LaVector *LaSquareMatrix::solveLinearEquation(LaVector *vektor)
 {
-    if (rows != (int)vektor->value->size())
+    return new LaVector(this->solveLinearEquation(*vektor));
+}
+LaVector LaSquareMatrix::solveLinearEquation(const LaVector &vektor)
+{
+    LaVector back(vektor.getDimension());
+    this->solveLinearEquation(vektor, back);
+    return back;
+}
+/**
+  Solves the linear equation Ax=b without allocating memory (apart from the first factorization).
+  solution and vektor may be the same vector. Diagonal, tridiagonal, banded and symmetric positive
+  definite matrices use their structured solver (getStructuredSolver()), all others the LU-factorization.
+  @param vektor the right hand vector b
+  @param solution the result x, resized if necessary
+*/
+void LaSquareMatrix::solveLinearEquation(const LaVector &vektor, LaVector &solution)
+{
+    if (rows != vektor.getDimension())
         throw TmcException("LaSquareMatrix.solveLinearEquation");
 
     try
     {
-        decomposeLU();
-        vector<double> *substituteVec = substituteLUback(vektor->value);
-        LaVector *back = new LaVector(substituteVec);
-        delete substituteVec;
-        return (back);
+        LaStructuredSolver *structured = this->getStructuredSolver();
+        if (structured)
+        {
+            if (&solution != &vektor)
+                solution.elements().assign(vektor.elements().begin(), vektor.elements().end());
+            structured->solve(solution.data());
+            return;
+        }
+        const bool updated = !LUconsistent && LUupdatable;
+        if (!updated)
+            decomposeLU();
+        if (&solution != &vektor)
+            solution.elements().assign(vektor.elements().begin(), vektor.elements().end());
+        if (updated)
+            substituteUpdatedLUback(solution.data());
+        else
+            substituteLUback(solution.data());
     }
     catch (string &s)
     {
@@ -704,6 +1081,10 @@ LaVector *LaSquareMatrix::solveLinearEquation(LaVector *vektor)
         cout << *s << endl;
         throw TmcException(__FILE__, __LINE__, "LaSquareMatrix.solveLinearEquation()");
     }
+    catch (TmcException &)
+    {
+        throw;
+    }
     catch (...)
     {
         throw TmcException("LaSquareMatrix.solveLinearEquation()");
@@ -721,18 +1102,22 @@ LaVector *LaSquareMatrix::solveLinearEquation(LaVector *vektor)
 */
 LaVector *LaSquareMatrix::solveLinearEquation(LaVector *left, LaVector *right, vector<bool> *index)
 {
-    if (rows != (int)left->value->size())
+    return new LaVector(this->solveLinearEquation(*left, *right, *index));
+}
+LaVector LaSquareMatrix::solveLinearEquation(const LaVector &left, const LaVector &right, const std::vector<bool> &index)
+{
+    if (rows != left.getDimension())
         throw TmcException("LaSquareMatrix.solveLinearEquation()");
-    if (rows != (int)right->value->size())
+    if (rows != right.getDimension())
         throw TmcException("LaSquareMatrix.solveLinearEquation()");
 
     try
     {
-        prepareSeparationVectors(index);
+        prepareSeparationVectors(&index);
         decomposeLU2();
-        LaVector *result = new LaVector(substituteLUback2(left, right));
-        result->setName("Result");
-        return (result);
+        LaVector result("Result");
+        result.elements() = substituteLUback2(left, right);
+        return result;
     }
     catch (string &s)
     {
@@ -760,6 +1145,7 @@ void LaSquareMatrix::decomposeLU()
     {
         return;
     }
+    TMC_TRACE_SCOPE("decomposeLU", "algebra");
 
     int o = rows;
     int imax = 0;
@@ -767,11 +1153,7 @@ void LaSquareMatrix::decomposeLU()
     vektor.resize(o, 0.0);
     if (lufactorization == NULL)
     {
-        lufactorization = new double *[o];
-        for (int i = 0; i < o; i++)
-        {
-            lufactorization[i] = new double[o];
-        }
+        lufactorization = allocateRows(o, o);
     }
     if (permutations == NULL)
         permutations = new int[o];
@@ -845,43 +1227,86 @@ void LaSquareMatrix::decomposeLU()
         throw TmcException("LaMatrix.decomposeLU(): Matrix is nearly singular");
 
     LUconsistent = true;
+    updaterows.clear();
+    updatedifference.clear();
+    updatesolution.clear();
+    delete capacitance;
+    capacitance = NULL;
 }
 
-vector<double> *LaSquareMatrix::substituteLUback(vector<double> *vektor)
+void LaSquareMatrix::substituteLUback(double *back)
 {
+    TMC_TRACE_SCOPE("substituteLUback", "algebra");
 
-    int o = (int)vektor->size();
+    int o = rows;
     int flag = -1;
-    vector<double> *back = new vector<double>;
-    back->resize(o, 0.0);
-
-    for (int i = 0; i < o; i++)
-        (*back)[i] = (*vektor)[i];
 
     /*-------------------------------------------------------------------*/
     /*  Substituting back - Calculating unknown left hand parts          */
     /*                                                                   */
     for (int i = 0; i < o; i++)
     {
-        double sum = (*back)[permutations[i]];
-        (*back)[permutations[i]] = (*back)[i];
+        double sum = back[permutations[i]];
+        back[permutations[i]] = back[i];
 
         if (flag >= 0)
             for (int j = flag; j < i; j++)
-                sum -= lufactorization[i][j] * (*back)[j];
+                sum -= lufactorization[i][j] * back[j];
         else if (sum != 0.0)
             flag = i;
 
-        (*back)[i] = sum;
+        back[i] = sum;
     }
     for (int i = o - 1; i >= 0; i--)
     {
-        double sum = (*back)[i];
+        double sum = back[i];
         for (int j = i + 1; j < o; j++)
-            sum -= lufactorization[i][j] * (*back)[j];
-        (*back)[i] = sum / lufactorization[i][i];
+            sum -= lufactorization[i][j] * back[j];
+        back[i] = sum / lufactorization[i][i];
+    }
+}
+/**
+  Solves (LU + U V^T) x = b in place with the Woodbury formula, U = [e_row], V^T = the rows of
+  updatedifference: x = y - Z inv(I + V^T Z) V^T y with y = inv(LU) b and Z = inv(LU) U.
+  The columns of Z are computed once per updated row, the capacitance matrix once per change.
+*/
+void LaSquareMatrix::substituteUpdatedLUback(double *back)
+{
+    TMC_TRACE_SCOPE("substituteUpdatedLUback", "algebra");
+    const int n = this->rows;
+    const int k = (int)updaterows.size();
+
+    for (int c = (int)(updatesolution.size() / n); c < k; c++)
+    {
+        updatesolution.resize(updatesolution.size() + n, 0.0);
+        double *column = &updatesolution[(size_t)c * n];
+        column[updaterows[c]] = 1.0;
+        substituteLUback(column);
+    }
+    if (!capacitance)
+    {
+        capacitance = new LaSquareMatrix(k, "capacitance");
+        for (int i = 0; i < k; i++)
+        {
+            const LaConstVectorView difference(&updatedifference[(size_t)i * n], n);
+            for (int j = 0; j < k; j++)
+                capacitance->value[i][j] = (i == j ? 1.0 : 0.0) + difference.dot(LaConstVectorView(&updatesolution[(size_t)j * n], n));
+        }
+    }
+
+    substituteLUback(back);
+    const LaConstVectorView y(back, n);
+    LaVector projection(k);
+    for (int i = 0; i < k; i++)
+        projection.elements()[i] = LaConstVectorView(&updatedifference[(size_t)i * n], n).dot(y);
+    capacitance->solveLinearEquation(projection, projection);
+    for (int j = 0; j < k; j++)
+    {
+        const double *column = &updatesolution[(size_t)j * n];
+        const double w = projection.elements()[j];
+        for (int i = 0; i < n; i++)
+            back[i] -= w * column[i];
     }
-    return (back);
 }
 /*======================================================================*/
 
@@ -1393,77 +1818,87 @@ void LaSquareMatrix::calculateEigenvaluesAndEigenvectors()
 /*======================================================================*/
 /*  indexed part of matrix                                              */
 /*                                                                      */
-void LaSquareMatrix::prepareSeparationVectors(vector<bool> *index)
+void LaSquareMatrix::prepareSeparationVectors(const vector<bool> *index)
 {
+    bool changed = false;
     if (leftunknownsize + rightunknownsize != (int)index->size())
-        LUconsistent2 = false;
+        changed = true;
     else if (leftunknownsize == -1)
-        LUconsistent2 = false;
+        changed = true;
     else if (rightunknownsize == -1)
-        LUconsistent2 = false;
+        changed = true;
     else
     {
-        for (int i = 0; i < leftunknownsize; i++)
+        for (int i = 0; i < leftunknownsize && !changed; i++)
             if (!(*index)[leftunknown[i]])
-            {
-                LUconsistent2 = false;
-                break;
-            }
-        for (int i = 0; i < rightunknownsize; i++)
+                changed = true;
+        for (int i = 0; i < rightunknownsize && !changed; i++)
             if ((*index)[rightunknown[i]])
-            {
-                LUconsistent2 = false;
-                break;
-            }
+                changed = true;
     }
-    if (!LUconsistent2)
-    {
-        leftunknownsize = 0;
-        int j = 0;
-        int k = 0;
-
-        for (int i = 0; i < (int)index->size(); i++)
-            if ((*index)[i])
-                leftunknownsize++;
-        rightunknownsize = (int)index->size() - leftunknownsize;
-
-        leftunknown = new int[leftunknownsize];
-        rightunknown = new int[rightunknownsize];
+    if (!changed)
+        return;
 
-        for (int i = 0; i < (int)index->size(); i++)
-        {
-            if ((*index)[i])
-            {
-                leftunknown[j] = i;
-                j++;
-            }
-            else
-            {
-                rightunknown[k] = i;
-                k++;
-            }
-        }
+    // the index lists keep their capacity, a new separation of the same system does not allocate
+    leftunknown.clear();
+    rightunknown.clear();
+    for (int i = 0; i < (int)index->size(); i++)
+    {
+        if ((*index)[i])
+            leftunknown.push_back(i);
+        else
+            rightunknown.push_back(i);
     }
+    leftunknownsize = (int)leftunknown.size();
+    rightunknownsize = (int)rightunknown.size();
+    // the factorization is kept, decomposeLU2() borders it or factorizes again
+    borderconsistent = false;
 }
+/**
+  Makes the mixed system solvable for the current separation. A factorization of
+  the matrix values is bordered as long as the separation differs by at most a quarter of
+  the left unknowns from the factorized one, which costs O(n^2 k) instead of O(n^3).
+*/
 void LaSquareMatrix::decomposeLU2()
 {
-    if (LUconsistent2)
+    if (LUconsistent2 && borderconsistent)
         return;
+    if (LUconsistent2)
+    {
+        int changes = 0;
+        for (int i = 0; i < leftunknownsize; i++)
+            if (factoredposition[leftunknown[i]] < 0)
+                changes++;
+        // every factorized unknown which is not unknown anymore
+        changes += (int)factoredunknown.size() - (leftunknownsize - changes);
+        if (4 * changes <= leftunknownsize)
+        {
+            this->borderLU2();
+            return;
+        }
+    }
+    this->factorizeLU2();
+}
+void LaSquareMatrix::factorizeLU2()
+{
+    TMC_TRACE_SCOPE("decomposeLU2", "algebra");
 
     int imax = 0;
-    vector<double> *vektor = new vector<double>;
-    vektor->resize(leftunknownsize, 0.0);
-
-    lufactorization2 = new double *[leftunknownsize];
-    for (int i = 0; i < leftunknownsize; i++)
-        lufactorization2[i] = new double[leftunknownsize];
+    vector<double> vektor(leftunknownsize, 0.0);
 
-    permutations2 = new int[leftunknownsize];
+    if (!lufactorization2 || (int)factoredunknown.size() != leftunknownsize)
+    {
+        freeRows(lufactorization2);
+        lufactorization2 = allocateRows(leftunknownsize, leftunknownsize);
+        delete[] permutations2;
+        permutations2 = new int[leftunknownsize];
+    }
     isNearlySingular2 = false;
+    LUconsistent2 = false;
 
-    for (int i = 0; i < leftunknownsize; i++)
-        for (int j = 0; j < leftunknownsize; j++)
-            lufactorization2[i][j] = value[leftunknown[i]][leftunknown[j]];
+    // the block of the left hand unknowns, gathered straight into the factorization
+    const LaConstMatrixView known = this->view().select(leftunknown.data(), leftunknownsize, leftunknown.data(), leftunknownsize);
+    known.copyTo(lufactorization2[0], rowStride(leftunknownsize));
 
     for (int i = 0; i < leftunknownsize; i++)
     {
@@ -1475,7 +1910,7 @@ void LaSquareMatrix::decomposeLU2()
             throw TmcException("LaMatrix.decomposeLU(): Partial Matrix is singular");
         if (big < singularEpsilon)
             isNearlySingular2 = true;
-        (*vektor)[i] = 1.0 / big;
+        vektor[i] = 1.0 / big;
     }
     for (int j = 0; j < leftunknownsize; j++)
     {
@@ -1493,9 +1928,9 @@ void LaSquareMatrix::decomposeLU2()
             for (int k = 0; k < j; k++)
                 sum -= lufactorization2[i][k] * lufactorization2[k][j];
             lufactorization2[i][j] = sum;
-            if ((*vektor)[i] * std::fabs(sum) >= big)
+            if (vektor[i] * std::fabs(sum) >= big)
             {
-                big = (*vektor)[i] * std::fabs(sum);
+                big = vektor[i] * std::fabs(sum);
                 imax = i;
             }
         }
@@ -1507,7 +1942,7 @@ void LaSquareMatrix::decomposeLU2()
                 lufactorization2[imax][k] = lufactorization2[j][k];
                 lufactorization2[j][k] = dum;
             }
-            (*vektor)[imax] = (*vektor)[j];
+            vektor[imax] = vektor[j];
         }
         permutations2[j] = imax;
         if (lufactorization2[j][j] == 0.0)
@@ -1524,65 +1959,202 @@ void LaSquareMatrix::decomposeLU2()
     if (decompositionBehaviour && isNearlySingular2)
         throw TmcException("LaSquareMatrix.decomposeLU(): Partial Matrix is nearly singular");
     LUconsistent2 = true;
-};
 
-vector<double> *LaSquareMatrix::substituteLUback2(LaVector *left, LaVector *right)
+    factoredunknown = leftunknown;
+    factoredposition.assign(rows, -1);
+    for (int i = 0; i < leftunknownsize; i++)
+        factoredposition[leftunknown[i]] = i;
+    removedunknown.clear();
+    addedunknown.clear();
+    removedsolution.clear();
+    addedsolution.clear();
+    delete removedmatrix;
+    removedmatrix = NULL;
+    delete schurcomplement;
+    schurcomplement = NULL;
+    borderconsistent = true;
+}
+/**
+  Borders the factorization of the block F = factoredunknown for the current left unknowns
+  L = (F without R) + A. The unknowns R which became known are eliminated with the columns
+  W = inv(A_FF) e_R and the small matrix W_RR, the new unknowns A are added with the Schur
+  complement A_AA - A_AS inv(A_SS) A_SA, S = F without R.
+*/
+void LaSquareMatrix::borderLU2()
 {
-    int flag = -1;
+    TMC_TRACE_SCOPE("borderLU2", "algebra");
+    const int n = (int)factoredunknown.size();
 
-    vector<double> *back = new vector<double>;
-    back->resize(leftunknownsize + rightunknownsize, 0.0);
-
-    /*-------------------------------------------------------------------*/
-    /*  Initializing return vector                                       */
-    /*                                                                   */
+    vector<bool> unknown(rows, false);
+    addedunknown.clear();
     for (int i = 0; i < leftunknownsize; i++)
     {
-        double sum = 0.0;
-        for (int j = 0; j < rightunknownsize; j++)
-            sum += this->value[leftunknown[i]][rightunknown[j]] * (*left->value)[rightunknown[j]];
-        (*back)[leftunknown[i]] = (*right->value)[leftunknown[i]] - sum;
+        unknown[leftunknown[i]] = true;
+        if (factoredposition[leftunknown[i]] < 0)
+            addedunknown.push_back(leftunknown[i]);
+    }
+    removedunknown.clear();
+    for (int p = 0; p < n; p++)
+        if (!unknown[factoredunknown[p]])
+            removedunknown.push_back(p);
+    const int r = (int)removedunknown.size();
+    const int a = (int)addedunknown.size();
+
+    delete removedmatrix;
+    removedmatrix = NULL;
+    delete schurcomplement;
+    schurcomplement = NULL;
+    removedsolution.assign((size_t)n * r, 0.0);
+    if (r > 0)
+    {
+        removedmatrix = new LaSquareMatrix(r, "removed unknowns");
+        for (int k = 0; k < r; k++)
+        {
+            double *column = &removedsolution[(size_t)k * n];
+            column[removedunknown[k]] = 1.0;
+            this->substituteLU2(column);
+            for (int l = 0; l < r; l++)
+                removedmatrix->value[l][k] = column[removedunknown[l]];
+        }
     }
 
-    /*-------------------------------------------------------------------*/
-    /*  Substituting back - Calculating unknown left hand parts          */
-    /*                                                                   */
-    for (int i = 0; i < leftunknownsize; i++)
+    addedsolution.assign((size_t)n * a, 0.0);
+    if (a > 0)
+    {
+        const LaConstMatrixView matrix = this->view();
+        for (int k = 0; k < a; k++)
+        {
+            double *column = &addedsolution[(size_t)k * n];
+            matrix.column(addedunknown[k]).gather(factoredunknown.data(), n).copyTo(column);
+            this->substituteBorderedLU2(column);
+        }
+        schurcomplement = new LaSquareMatrix(a, "schur complement");
+        const LaConstMatrixView aaf = matrix.select(addedunknown.data(), a, factoredunknown.data(), n);
+        for (int i = 0; i < a; i++)
+            for (int j = 0; j < a; j++)
+                schurcomplement->value[i][j] = this->value[addedunknown[i]][addedunknown[j]] - aaf.row(i).dot(LaConstVectorView(&addedsolution[(size_t)j * n], n));
+    }
+    borderconsistent = true;
+}
+/**
+  Solves A_FF x = b in place with the factorization, vektor in the order of factoredunknown.
+*/
+void LaSquareMatrix::substituteLU2(double *vektor)
+{
+    const int n = (int)factoredunknown.size();
+    int flag = -1;
+    for (int i = 0; i < n; i++)
     {
-        double sum = (*back)[leftunknown[permutations2[i]]];
-        (*back)[leftunknown[permutations2[i]]] = (*back)[leftunknown[i]];
+        double sum = vektor[permutations2[i]];
+        vektor[permutations2[i]] = vektor[i];
 
         if (flag >= 0)
             for (int j = flag; j < i; j++)
-                sum -= lufactorization2[i][j] * (*back)[leftunknown[j]];
+                sum -= lufactorization2[i][j] * vektor[j];
         else if (sum != 0.0)
             flag = i;
 
-        (*back)[leftunknown[i]] = sum;
+        vektor[i] = sum;
     }
-    for (int i = leftunknownsize - 1; i >= 0; i--)
+    for (int i = n - 1; i >= 0; i--)
     {
-        double sum = (*back)[leftunknown[i]];
-        for (int j = i + 1; j < leftunknownsize; j++)
-            sum -= lufactorization2[i][j] * (*back)[leftunknown[j]];
-        (*back)[leftunknown[i]] = sum / lufactorization2[i][i];
+        double sum = vektor[i];
+        for (int j = i + 1; j < n; j++)
+            sum -= lufactorization2[i][j] * vektor[j];
+        vektor[i] = sum / lufactorization2[i][i];
     }
+}
+/**
+  Solves A_SS y = c in place, S = factoredunknown without the removed unknowns.
+  vektor is in the order of factoredunknown, the entries of the removed unknowns are 0.0 on return.
+*/
+void LaSquareMatrix::substituteBorderedLU2(double *vektor)
+{
+    const int n = (int)factoredunknown.size();
+    const int r = (int)removedunknown.size();
 
-    /*-------------------------------------------------------------------*/
-    /*  Calculating unknown right hand parts                             */
-    /*                                                                   */
-    for (int i = 0; i < rightunknownsize; i++)
+    for (int k = 0; k < r; k++)
+        vektor[removedunknown[k]] = 0.0;
+    this->substituteLU2(vektor);
+    if (r == 0)
+        return;
+
+    // the multipliers of the removed unknowns make their entries zero
+    LaVector residual(r);
+    for (int k = 0; k < r; k++)
+        residual.elements()[k] = -vektor[removedunknown[k]];
+    LaVector multiplier(r);
+    removedmatrix->solveLinearEquation(residual, multiplier);
+    for (int k = 0; k < r; k++)
     {
-        double sum = 0.0;
+        const double *column = &removedsolution[(size_t)k * n];
+        const double m = multiplier.elements()[k];
+        for (int p = 0; p < n; p++)
+            vektor[p] += m * column[p];
+    }
+    for (int k = 0; k < r; k++)
+        vektor[removedunknown[k]] = 0.0;
+}
 
-        for (int j = 0; j < leftunknownsize; j++)
-            sum += this->value[rightunknown[i]][leftunknown[j]] * (*back)[leftunknown[j]];
-        for (int j = 0; j < rightunknownsize; j++)
-            sum += this->value[rightunknown[i]][rightunknown[j]] * (*left->value)[rightunknown[j]];
+vector<double> LaSquareMatrix::substituteLUback2(const LaVector &left, const LaVector &right)
+{
+    TMC_TRACE_SCOPE("substituteLUback2", "algebra");
+    const int n = (int)factoredunknown.size();
+    const int a = (int)addedunknown.size();
+
+    vector<double> back(leftunknownsize + rightunknownsize, 0.0);
+
+    // partitions of the matrix and the vectors, no values are copied
+    const int *l = leftunknown.data();
+    const int *r = rightunknown.data();
+    const LaConstMatrixView matrix = this->view();
+    const LaConstMatrixView alr = matrix.select(l, leftunknownsize, r, rightunknownsize);
+    const LaConstMatrixView arl = matrix.select(r, rightunknownsize, l, leftunknownsize);
+    const LaConstMatrixView arr = matrix.select(r, rightunknownsize, r, rightunknownsize);
+    const LaConstVectorView knownLeft = left.view().gather(r, rightunknownsize);
+    const LaConstVectorView knownRight = right.view().gather(l, leftunknownsize);
+    const LaVectorView unknownLeft = LaVectorView(back.data(), l, leftunknownsize);
+    const LaVectorView unknownRight = LaVectorView(back.data(), r, rightunknownsize);
+
+    /*-------------------------------------------------------------------*/
+    /*  Initializing return vector                                       */
+    /*                                                                   */
+    for (int i = 0; i < leftunknownsize; i++)
+        unknownLeft[i] = knownRight[i] - alr.row(i).dot(knownLeft);
 
-        (*back)[rightunknown[i]] = sum;
+    /*-------------------------------------------------------------------*/
+    /*  Substituting back - Calculating unknown left hand parts          */
+    /*                                                                   */
+    const LaVectorView factored = LaVectorView(back.data(), factoredunknown.data(), n);
+    vector<double> y(n);
+    factored.copyTo(y.data());
+    this->substituteBorderedLU2(y.data());
+    if (a > 0)
+    {
+        const LaVectorView added = LaVectorView(back.data(), addedunknown.data(), a);
+        const LaConstMatrixView aas = matrix.select(addedunknown.data(), a, factoredunknown.data(), n);
+        LaVector residual(a);
+        for (int i = 0; i < a; i++)
+            residual.elements()[i] = added[i] - aas.row(i).dot(LaConstVectorView(y.data(), n));
+        LaVector z(a);
+        schurcomplement->solveLinearEquation(residual, z);
+        for (int k = 0; k < a; k++)
+        {
+            const double *column = &addedsolution[(size_t)k * n];
+            for (int p = 0; p < n; p++)
+                y[p] -= z.elements()[k] * column[p];
+            added[k] = z.elements()[k];
+        }
     }
-    return (back);
+    // the removed unknowns are known now, their entries of back are overwritten below
+    factored.assign(LaConstVectorView(y.data(), n));
+
+    /*-------------------------------------------------------------------*/
+    /*  Calculating unknown right hand parts                             */
+    /*                                                                   */
+    for (int i = 0; i < rightunknownsize; i++)
+        unknownRight[i] = arl.row(i).dot(unknownLeft) + arr.row(i).dot(knownLeft);
+    return back;
 }
 /*======================================================================*/
 
@@ -1635,18 +2207,19 @@ void LaSquareMatrix::read(TmcFileInput *in)
 {
     if (in == NULL)
         throw TmcException(this->name + ".readFromFile(): null input-stream");
+    if (in->getFileType() == TmcFileInput::BINARY)
+    {
+        this->readBinary(dynamic_cast<TmcFileInputBinary *>(in));
+        return;
+    }
     try
     {
         this->name = in->readString();
         int dimension = in->readInteger();
 
-        this->value = new double *[dimension];
-        for (int i = 0; i < dimension; i++)
-            this->value[i] = new double[dimension];
-        for (int i = 0; i < dimension; i++)
-            for (int j = 0; j < dimension; j++)
-                this->value[i][j] = 0.0;
+        this->release();
         this->Init(dimension);
+        this->value = allocateRows(dimension, dimension);
 
         in->readLine();
         for (int i = 0; i < this->rows; i++)
@@ -1661,6 +2234,11 @@ void LaSquareMatrix::read(TmcFileInput *in)
 
 void LaSquareMatrix::write(TmcFileOutput *out)
 {
+    if (out != NULL && out->getFileType() == TmcFileOutput::BINARY)
+    {
+        this->writeBinary(dynamic_cast<TmcFileOutputBinary *>(out));
+        return;
+    }
     try
     {
         out->writeString(this->name);
@@ -1681,3 +2259,36 @@ void LaSquareMatrix::write(TmcFileOutput *out)
         throw TmcException(this->name + ".writeToFile(): error while writing");
     }
 }
+/*======================================================================*/
+void LaSquareMatrix::readBinary(TmcFileInputBinary *in)
+{
+    LaBinaryFormat::Header header;
+    bool swap = LaBinaryFormat::readHeader(in, header);
+    if (header.storage != LaBinaryFormat::DENSE_MATRIX || header.rows != header.columns)
+        throw TmcException(UB_EXARGS, in->getFileName() + " contains no square matrix");
+
+    this->release();
+    int dimension = (int)header.rows;
+    this->Init(dimension);
+    this->name = header.name;
+    this->value = allocateRows(dimension, dimension);
+
+    uint64_t checksum = LaBinaryFormat::CHECKSUM_SEED;
+    for (int i = 0; i < dimension; i++)
+        checksum = LaBinaryFormat::readPayload(in, this->value[i], dimension, swap, checksum);
+    if (checksum != header.checksum)
+        throw TmcException(UB_EXARGS, "checksum error in " + in->getFileName());
+}
+/*======================================================================*/
+void LaSquareMatrix::writeBinary(TmcFileOutputBinary *out)
+{
+    uint64_t checksum = LaBinaryFormat::CHECKSUM_SEED;
+    for (int i = 0; i < rows; i++)
+        checksum = LaBinaryFormat::checksum(value[i], columns, checksum);
+
+    LaBinaryFormat::writeHeader(out, this->name, LaBinaryFormat::DENSE_MATRIX, rows, columns, checksum);
+    for (int i = 0; i < rows; i++)
+        LaBinaryFormat::writePayload(out, value[i], columns);
+    if (!(*out))
+        throw TmcException(UB_EXARGS, this->name + ".writeToFile(): error while writing");
+}
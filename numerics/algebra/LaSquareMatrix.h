@@ -48,9 +48,12 @@
 
 #include "./LaObject.h"
 #include "./LaVector.h"
+#include "./LaMatrixStructure.h"
 #include <TmcMacroFile.h>
 class TmcFileInput;
 class TmcFileOutput;
+class TmcFileInputBinary;
+class TmcFileOutputBinary;
 
 class TMC_DLL_EXPORT LaSquareMatrix : public LaObject
 {
@@ -64,12 +67,21 @@ private:
     bool triDiagonalChecked;
     bool isIdentity;
     bool identityChecked;
+    bool isScaledIdentity;
+    double identityScale;
+    bool scaledIdentityChecked;
     bool isSymmetric;
     bool symmetricChecked;
     bool isAntisymmetric;
     bool antisymmetricChecked;
     bool isOrthogonal;
     bool orthogonalChecked;
+    LaMatrixStructure structure;
+    bool structureChecked;
+    LaStructuredSolver *structuredsolver;
+    bool structuredconsistent;
+    LaPermutation ordering; //< bandwidth reducing ordering, depends only on the pattern and is kept
+    bool reordered;
 
     double **value;
     int rows;
@@ -86,6 +98,18 @@ private:
     bool decompositionBehaviour;
     double singularEpsilon;
 
+    /*......................................................................*/
+    /*  Low rank updates of the factorization                               */
+    /*  values = factorized values + sum e_row * difference row, solved     */
+    /*  with the Sherman-Morrison-Woodbury formula until the rank exceeds   */
+    /*  rows / 8                                                            */
+    /*                                                                      */
+    std::vector<int> updaterows;
+    std::vector<double> updatedifference; // one row of differences per entry of updaterows
+    std::vector<double> updatesolution;   // inv(LU) e_row, one column per entry of updaterows
+    LaSquareMatrix *capacitance;
+    bool LUupdatable;
+
     /*......................................................................*/
     /*  Mixed unknown equation system                                       */
     /*                                                                      */
@@ -93,11 +117,27 @@ private:
     int *permutations2;
     int leftunknownsize;
     int rightunknownsize;
-    int *leftunknown;
-    int *rightunknown;
+    std::vector<int> leftunknown;
+    std::vector<int> rightunknown;
     bool LUconsistent2;
     bool isNearlySingular2;
 
+    /*......................................................................*/
+    /*  Bordered update of the mixed system                                 */
+    /*  lufactorization2 belongs to the left unknowns factoredunknown, a    */
+    /*  separation which differs by a few entries is solved by bordering   */
+    /*  this factorization instead of factorizing again                    */
+    /*                                                                      */
+    std::vector<int> factoredunknown;
+    std::vector<int> factoredposition; // position in factoredunknown or -1
+    std::vector<int> removedunknown;   // positions in factoredunknown which are known now
+    std::vector<int> addedunknown;     // unknowns which are not in factoredunknown
+    std::vector<double> removedsolution;
+    std::vector<double> addedsolution;
+    LaSquareMatrix *removedmatrix;
+    LaSquareMatrix *schurcomplement;
+    bool borderconsistent;
+
     /*......................................................................*/
     /*  Eigensystem properties                                              */
     /*                                                                      */
@@ -116,16 +156,31 @@ public:
     LaSquareMatrix(LaSquareMatrix *matrix, std::string name);
     LaSquareMatrix(std::string name);
     LaSquareMatrix(int dimension, std::string name);
+    LaSquareMatrix(const LaSquareMatrix &matrix);
+    LaSquareMatrix(LaSquareMatrix &&matrix);
     ~LaSquareMatrix();
 
-    int getRowNumber();
-    int getColumnNumber();
+    LaSquareMatrix &operator=(const LaSquareMatrix &matrix);
+    LaSquareMatrix &operator=(LaSquareMatrix &&matrix);
+    void swap(LaSquareMatrix &matrix);
+
+    int getRowNumber() const;
+    int getColumnNumber() const;
 
     LaSquareMatrix *getLUMatrix();
     LaSquareMatrix *getUntereDreiecksMatrix();
 
     double getValue(int row, int column);
     void setValue(int row, int column, double a);
+    /**
+      Direct access to the values of a row, used by the vector expressions (LaVectorExpression.h).
+    */
+    const double *getRow(int row) const { return this->value[row]; }
+    /** the values of the matrix, rows, columns and blocks are views of this view */
+    LaMatrixView view();
+    LaConstMatrixView view() const;
+    /** to be called after the values were changed through view(), discards the cached properties and factorizations */
+    void setValuesChanged() { this->setInconsistent(); }
     int getDimension();
     void setDecompositionBehaviour(bool decompositionBehaviour);
     void setSingularityEpsilon(double epsilon);
@@ -138,14 +193,45 @@ public:
 
 private:
     void Init(int dimension);
+    void checkStructure();
+    void checkScaledIdentity();
+    bool reorder();
     void setInconsistent();
+    void setInconsistent(int row, int column, double difference);
+    void release();
 
 public:
+    LaVector multiply(const LaVector &vector) const;
+    LaSquareMatrix multiply(const LaSquareMatrix &matrix) const;
+    /* pointer versions, the caller owns the result */
     LaVector *multiply(LaVector *vector);
     LaSquareMatrix *multiply(LaSquareMatrix *matrix);
+    /**
+      Structure of the values (exact zeros), analyzed in one pass when it is needed.
+      If only the numbering of the unknowns prevents a banded solver, the structure is the one
+      of the matrix reordered with getOrdering().
+    */
+    const LaMatrixStructure &getStructure();
+    /**
+      The reverse Cuthill-McKee ordering of the structured solver, empty if the matrix is used
+      in its own order. It is computed once and kept as long as it fits the pattern of the values.
+    */
+    const LaPermutation &getOrdering();
+    /**
+      The factorized solver for the structure, NULL if dense LU is the right choice or a dense
+      factorization (possibly with low rank updates) exists already. Also NULL with the decomposition
+      behaviour set, only the pivoting LU-factorization detects nearly singular matrices.
+    */
+    LaStructuredSolver *getStructuredSolver();
     bool isDiagonalMatrix();
     bool isTriDiagonalMatrix();
     bool isIdentityMatrix();
+    /**
+      True if the matrix is exactly s I, the zero matrix is 0 I. Products with such matrices are
+      scalings (LaVectorExpression.h), zero terms of the initial value solvers are skipped.
+    */
+    bool isScaledIdentityMatrix(double *scale = NULL);
+    bool isZeroMatrix();
     bool isSymmetricMatrix();
     bool isAntisymmetricMatrix();
     bool isHermitian();
@@ -158,22 +244,31 @@ public:
     LaVector *getEigenvalues();
     LaVector *getImaginaryEigenvalues();
     LaSquareMatrix *getEigenvectors();
+    LaVector solveLinearEquation(const LaVector &vektor);
+    void solveLinearEquation(const LaVector &vektor, LaVector &solution);
+    LaVector solveLinearEquation(const LaVector &left, const LaVector &right, const std::vector<bool> &index);
+    /* pointer versions, the caller owns the result */
     LaVector *solveLinearEquation(LaVector *vektor);
     LaVector *solveLinearEquation(LaVector *left, LaVector *right, std::vector<bool> *index);
 
     void decomposeLU();
 
 private:
-    std::vector<double> *substituteLUback(std::vector<double> *vektor);
+    void substituteLUback(double *vektor);
+    void substituteUpdatedLUback(double *vektor);
 
     double i_PHYTAG(double a, double b);
     double i_SIGN(double a, double b);
     double i_SQR(double a);
     void calculateEigenvaluesAndEigenvectors();
 
-    void prepareSeparationVectors(std::vector<bool> *index);
+    void prepareSeparationVectors(const std::vector<bool> *index);
     void decomposeLU2();
-    std::vector<double> *substituteLUback2(LaVector *left, LaVector *right);
+    void factorizeLU2();
+    void borderLU2();
+    void substituteLU2(double *vektor);
+    void substituteBorderedLU2(double *vektor);
+    std::vector<double> substituteLUback2(const LaVector &left, const LaVector &right);
 
 public:
     void cleanSmallNumbers(int base);
@@ -182,5 +277,9 @@ public:
 
     void read(TmcFileInput *in);
     void write(TmcFileOutput *out);
+
+private:
+    void readBinary(TmcFileInputBinary *in);
+    void writeBinary(TmcFileOutputBinary *out);
 };
 #endif
@@ -41,66 +41,74 @@
 
 #include "./LaVector.h"
 
+#include "./LaBinaryFormat.h"
+
 #include <common/utilities/TmcFileInput.h>
 #include <common/utilities/TmcFileOutput.h>
+#include <common/utilities/TmcFileInputBinary.h>
+#include <common/utilities/TmcFileOutputBinary.h>
 
 using namespace std;
 
 /*=========================================================================*/
-LaVector::LaVector() : LaObject("LaVector")
+LaVector::LaVector() : LaObject("LaVector"), value(&this->storage)
 {
-    this->value = NULL;
 }
 /*=========================================================================*/
-LaVector::LaVector(int dimension) : LaObject("LaVector")
+LaVector::LaVector(int dimension) : LaObject("LaVector"), value(&this->storage), storage(dimension, 0.0)
 {
-    this->value = new vector<double>;
-    this->value->resize(dimension, 0.0);
 }
 /*=========================================================================*/
-LaVector::LaVector(vector<double> *array) : LaObject("LaVector")
+LaVector::LaVector(vector<double> *array) : LaObject("LaVector"), value(&this->storage), storage(*array)
 {
-    this->value = new vector<double>;
-    this->value->resize((int)array->size(), 0.0);
-    for (int u = 0; u < (int)this->value->size(); u++)
-    {
-        (*this->value)[u] = (*array)[u];
-    }
 }
 /*=========================================================================*/
-LaVector::LaVector(double *array, int size) : LaObject("LaVector")
+LaVector::LaVector(double *array, int size) : LaObject("LaVector"), value(&this->storage), storage(array, array + size)
 {
-    this->value = new vector<double>;
-    this->value->resize(size, 0.0);
-    for (int u = 0; u < size; u++)
-    {
-        (*this->value)[u] = array[u];
-    }
 }
 /*=========================================================================*/
-LaVector::LaVector(LaVector *vektor) : LaObject(vektor->name)
+LaVector::LaVector(LaVector *vektor) : LaObject(vektor->name), value(&this->storage), storage(vektor->storage)
 {
-    this->value = new vector<double>;
-    this->value->resize((int)vektor->value->size(), 0.0);
-    for (int u = 0; u < (int)this->value->size(); u++)
-    {
-        (*this->value)[u] = (*vektor->value)[u];
-    }
 }
 /*=========================================================================*/
-LaVector::LaVector(string name) : LaObject(name)
+LaVector::LaVector(string name) : LaObject(name), value(&this->storage)
 {
 }
 /*=========================================================================*/
-LaVector::LaVector(int dimension, string name) : LaObject(name)
+LaVector::LaVector(int dimension, string name) : LaObject(name), value(&this->storage), storage(dimension, 0.0)
+{
+}
+/*=========================================================================*/
+LaVector::LaVector(const LaVector &vektor) : LaObject(vektor.name), value(&this->storage), storage(vektor.storage)
+{
+}
+/*=========================================================================*/
+LaVector::LaVector(LaVector &&vektor) : LaObject(vektor.name), value(&this->storage), storage(std::move(vektor.storage))
 {
-    this->value = new vector<double>;
-    this->value->resize(dimension, 0.0);
 }
 /*=========================================================================*/
 LaVector::~LaVector()
 {
-    delete this->value;
+}
+/*=========================================================================*/
+/**
+  Copies the values, the name of this vector is kept.
+  If the dimensions are equal, the storage is reused.
+*/
+LaVector &LaVector::operator=(const LaVector &vektor)
+{
+    if (this != &vektor)
+        this->storage.assign(vektor.storage.begin(), vektor.storage.end());
+    return *this;
+}
+/*=========================================================================*/
+/**
+  Takes over the storage of vektor, the name of this vector is kept.
+*/
+LaVector &LaVector::operator=(LaVector &&vektor)
+{
+    this->storage.swap(vektor.storage);
+    return *this;
 }
 /*=========================================================================*/
 
@@ -114,8 +122,8 @@ string LaVector::toString()
     stringstream ss;
     ss << "LaVector[";
     ss << this->name << "]" << endl;
-    for (int i = 0; i < (int)value->size(); i++)
-        ss << " " << (*value)[i];
+    for (int i = 0; i < (int)storage.size(); i++)
+        ss << " " << storage[i];
     ss << endl;
     return ((ss.str()).c_str());
 }
@@ -129,16 +137,16 @@ void LaVector::cleanSmallNumbers(int base)
 {
     throw TmcException("not yet implemented");
 }
-int LaVector::getDimension() { return ((int)this->value->size()); }
+int LaVector::getDimension() const { return ((int)this->storage.size()); }
 
 void LaVector::setValue(int row, double a)
 {
-    (*this->value)[row] = a;
+    this->storage[row] = a;
 }
 void LaVector::setValues(double a)
 {
-    for (int i = 0; i < (int)this->value->size(); i++)
-        (*this->value)[i] *= a;
+    for (int i = 0; i < (int)this->storage.size(); i++)
+        this->storage[i] = a;
 }
 
 /**
@@ -146,55 +154,49 @@ void LaVector::setValues(double a)
      @param values the values to set this vector with
      @exception ArrayIndexOutOfBoundsException if the specified array does not match
    */
-double LaVector::getValue(int row)
+double LaVector::getValue(int row) const
 {
-    return ((*this->value)[row]);
+    return (this->storage[row]);
 }
 vector<double> *LaVector::getValues()
 {
-    vector<double> *values = new vector<double>;
-    values->resize((int)this->value->size(), 0.0);
-    for (int u = 0; u < (int)this->value->size(); u++)
-    {
-        (*values)[u] = (*this->value)[u];
-    }
-    return (values);
+    return (new vector<double>(this->storage));
 }
 void LaVector::addValue(int row, double a)
 {
-    (*this->value)[row] += a;
+    this->storage[row] += a;
 }
 void LaVector::subtractValue(int row, double a)
 {
-    (*this->value)[row] -= a;
+    this->storage[row] -= a;
 }
 void LaVector::multiplyValue(int row, double a)
 {
-    (*this->value)[row] *= a;
+    this->storage[row] *= a;
 }
 void LaVector::divideByValue(int row, double a)
 {
-    (*this->value)[row] /= a;
+    this->storage[row] /= a;
 }
 void LaVector::addValue(double a)
 {
-    for (int i = 0; i < (int)this->value->size(); i++)
-        (*this->value)[i] += a;
+    for (int i = 0; i < (int)this->storage.size(); i++)
+        this->storage[i] += a;
 }
 void LaVector::subtractValue(double a)
 {
-    for (int i = 0; i < (int)this->value->size(); i++)
-        (*this->value)[i] -= a;
+    for (int i = 0; i < (int)this->storage.size(); i++)
+        this->storage[i] -= a;
 }
 void LaVector::multiplyValue(double a)
 {
-    for (int i = 0; i < (int)this->value->size(); i++)
-        (*this->value)[i] *= a;
+    for (int i = 0; i < (int)this->storage.size(); i++)
+        this->storage[i] *= a;
 }
 void LaVector::divideByValue(double a)
 {
-    for (int i = 0; i < (int)this->value->size(); i++)
-        (*this->value)[i] /= a;
+    for (int i = 0; i < (int)this->storage.size(); i++)
+        this->storage[i] /= a;
 };
 /*======================================================================*/
 
@@ -209,7 +211,7 @@ void LaVector::divideByValue(double a)
 // LaVector* multiply(LaScalar *scalar)
 //  {
 //     LaVector *vector = new LaVector(this->value);
-// for(int i=0; i<(int)vector->value->size(); i++) (*vector->value)[i] *= scalar->value;
+// for(int i=0; i<(int)vector->value.size(); i++) vector->value[i] *= scalar->value;
 //    return(vector);
 // };
 /**
@@ -220,44 +222,83 @@ void LaVector::divideByValue(double a)
 // LaVector* divide(LaScalar *scalar)
 // {
 //    LaVector *vector = new LaVector(this->value);
-//    for(int i=0; i<(int)vector->value->size(); i++) (*vector->value)[i] /= scalar->value;
+//    for(int i=0; i<(int)vector->value.size(); i++) vector->value[i] /= scalar->value;
 //    return(vector);
 // };
+/**
+  Adds a vector in place
+  @param vector the vector to add
+  @exception TmcException if vector sizes are incompatible
+*/
+LaVector &LaVector::operator+=(const LaVector &vector)
+{
+    if (this->storage.size() != vector.storage.size())
+        throw TmcException(UB_EXARGS, this->name + ".add(" + vector.name + "): incompatible sizes");
+    for (size_t i = 0; i < this->storage.size(); i++)
+        this->storage[i] += vector.storage[i];
+    return *this;
+}
+/**
+  Subtracts a vector in place
+  @param vector the vector to subtract
+  @exception TmcException if vector sizes are incompatible
+*/
+LaVector &LaVector::operator-=(const LaVector &vector)
+{
+    if (this->storage.size() != vector.storage.size())
+        throw TmcException(UB_EXARGS, this->name + ".subtract(" + vector.name + "): incompatible sizes");
+    for (size_t i = 0; i < this->storage.size(); i++)
+        this->storage[i] -= vector.storage[i];
+    return *this;
+}
+LaVector &LaVector::operator*=(double a)
+{
+    this->multiplyValue(a);
+    return *this;
+}
 /**
   Add two vectors
   @param vector the vector to add
   @return the result-vector
-  @exception ArrayIndexOutOfBoundsException if vector sizes are incompatible
+  @exception TmcException if vector sizes are incompatible
 */
-LaVector *LaVector::add(LaVector *vector)
+LaVector LaVector::operator+(const LaVector &vector) const
 {
-    int n = (int)this->value->size();
-    int m = (int)vector->value->size();
-    if (n != m)
-        throw new string("LaVector.add"); //(this.name+".add("+vector.name+"): incompatible sizes");
-
-    //		LaVector *back = new LaVector(this->value);
-    //      for(int i=0; i<(int)back->value->size(); i++) (*back->value)[i] += (*vector->value)[i];
-    //      return(back);
-    return NULL;
+    LaVector back(*this);
+    back += vector;
+    return back;
 }
 /**
   Subtract two vectors
   @param vector the vector to subtract
   @return the result-vector
-  @exception ArrayIndexOutOfBoundsException if vector sizes are incompatible
+  @exception TmcException if vector sizes are incompatible
+*/
+LaVector LaVector::operator-(const LaVector &vector) const
+{
+    LaVector back(*this);
+    back -= vector;
+    return back;
+}
+LaVector LaVector::operator*(double a) const
+{
+    LaVector back(*this);
+    back *= a;
+    return back;
+}
+/**
+  Add two vectors, the caller owns the result
+*/
+LaVector *LaVector::add(LaVector *vector)
+{
+    return new LaVector(*this + *vector);
+}
+/**
+  Subtract two vectors, the caller owns the result
 */
 LaVector *LaVector::subtract(LaVector *vector)
 {
-    int n = (int)this->value->size();
-    int m = (int)vector->value->size();
-    if (n != m)
-        throw new string("LaVector.substract");
-
-    // LaVector *back = new LaVector(this->value);
-    //		for(int i=0; i<(int)back->value->size(); i++) (*back->value)[i] -= (*vector->value)[i];
-    //      return(back);
-    return NULL;
+    return new LaVector(*this - *vector);
 }
 
 /**
@@ -374,16 +415,20 @@ void LaVector::read(TmcFileInput *in)
 {
     if (in == NULL)
         throw TmcException(this->name + ".readFromFile(): null input-stream");
+    if (in->getFileType() == TmcFileInput::BINARY)
+    {
+        this->readBinary(dynamic_cast<TmcFileInputBinary *>(in));
+        return;
+    }
     try
     {
         this->name = in->readString();
         int dimension = in->readInteger();
-        this->value = new vector<double>;
-        this->value->resize(dimension, 0.0);
+        this->storage.assign(dimension, 0.0);
 
         in->readLine();
-        for (int i = 0; i < (int)value->size(); i++)
-            (*value)[i] = in->readDouble();
+        for (int i = 0; i < (int)storage.size(); i++)
+            storage[i] = in->readDouble();
     }
     catch (...)
     {
@@ -393,14 +438,19 @@ void LaVector::read(TmcFileInput *in)
 
 void LaVector::write(TmcFileOutput *out)
 {
+    if (out != NULL && out->getFileType() == TmcFileOutput::BINARY)
+    {
+        this->writeBinary(dynamic_cast<TmcFileOutputBinary *>(out));
+        return;
+    }
     try
     {
         out->writeString(this->name);
         out->writeInteger(this->getDimension());
         out->writeLine();
         stringstream ss;
-        for (int i = 0; i < (int)value->size(); i++)
-            ss << " " << (*value)[i];
+        for (int i = 0; i < (int)storage.size(); i++)
+            ss << " " << storage[i];
         ss << endl;
         out->writeString(ss.str());
     }
@@ -409,5 +459,30 @@ void LaVector::write(TmcFileOutput *out)
         throw TmcException(this->name + ".writeToFile(): error while writing");
     }
 }
+/*=========================================================================*/
+void LaVector::readBinary(TmcFileInputBinary *in)
+{
+    LaBinaryFormat::Header header;
+    bool swap = LaBinaryFormat::readHeader(in, header);
+    if (header.storage != LaBinaryFormat::VECTOR)
+        throw TmcException(UB_EXARGS, in->getFileName() + " contains no vector");
+
+    this->name = header.name;
+    this->storage.resize((size_t)header.rows);
+
+    uint64_t checksum = LaBinaryFormat::readPayload(in, this->storage.data(), header.rows, swap);
+    if (checksum != header.checksum)
+        throw TmcException(UB_EXARGS, "checksum error in " + in->getFileName());
+}
+/*=========================================================================*/
+void LaVector::writeBinary(TmcFileOutputBinary *out)
+{
+    const uint64_t dimension = this->storage.size();
+    const double *data = this->storage.data();
+    LaBinaryFormat::writeHeader(out, this->name, LaBinaryFormat::VECTOR, dimension, 1, LaBinaryFormat::checksum(data, dimension));
+    LaBinaryFormat::writePayload(out, data, dimension);
+    if (!(*out))
+        throw TmcException(UB_EXARGS, this->name + ".writeToFile(): error while writing");
+}
 
 /*=========================================================================*/
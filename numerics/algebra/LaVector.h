@@ -48,11 +48,24 @@
 #include <iostream>
 
 #include "./LaObject.h"
+#include "./LaView.h"
 #include <TmcMacroFile.h>
 
 class TmcFileInput;
 class TmcFileOutput;
-
+class TmcFileInputBinary;
+class TmcFileOutputBinary;
+
+/**
+  Vector of doubles with value semantics.
+  <BR><BR>
+  A LaVector owns its values. It can be copied and moved like a std::vector; results of the
+  value operations are returned by value (moved, no deep copy). The methods taking and returning
+  pointers are kept for the existing code, the caller owns every returned pointer.
+  <BR>
+  value points to the storage of this vector for the existing code, new code uses elements()
+  or data().
+*/
 class TMC_DLL_EXPORT LaVector : public LaObject
 {
 public:
@@ -65,17 +78,28 @@ public:
     LaVector(LaVector *vektor);
     LaVector(std::string name);
     LaVector(int dimension, std::string name);
+    LaVector(const LaVector &vektor);
+    LaVector(LaVector &&vektor);
     ~LaVector();
 
+    LaVector &operator=(const LaVector &vektor);
+    LaVector &operator=(LaVector &&vektor);
+
     /*======================================================================*/
     std::string toString();
     std::string toString(std::string format);
     void cleanSmallNumbers(int base);
-    int getDimension();
+    int getDimension() const;
     void setValue(int row, double a);
     void setValues(double a);
-    double getValue(int row);
+    double getValue(int row) const;
     std::vector<double> *getValues();
+    std::vector<double> &elements() { return this->storage; }
+    const std::vector<double> &elements() const { return this->storage; }
+    double *data() { return this->storage.data(); }
+    const double *data() const { return this->storage.data(); }
+    LaVectorView view() { return LaVectorView(this->storage.data(), (int)this->storage.size()); }
+    LaConstVectorView view() const { return LaConstVectorView(this->storage.data(), (int)this->storage.size()); }
     void addValue(int row, double a);
     void subtractValue(int row, double a);
     void multiplyValue(int row, double a);
@@ -85,10 +109,23 @@ public:
     void multiplyValue(double a);
     void divideByValue(double a);
 
+    LaVector &operator+=(const LaVector &vector);
+    LaVector &operator-=(const LaVector &vector);
+    LaVector &operator*=(double a);
+    LaVector operator+(const LaVector &vector) const;
+    LaVector operator-(const LaVector &vector) const;
+    LaVector operator*(double a) const;
+
     LaVector *add(LaVector *vector);
     LaVector *subtract(LaVector *vector);
 
     void read(TmcFileInput *in);
     void write(TmcFileOutput *out);
+
+private:
+    void readBinary(TmcFileInputBinary *in);
+    void writeBinary(TmcFileOutputBinary *out);
+
+    std::vector<double> storage;
 };
 #endif
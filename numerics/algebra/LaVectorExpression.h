@@ -0,0 +1,291 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    expression templates for fused vector arithmetic
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LAVECTOREXPRESSION_H
+#define LAVECTOREXPRESSION_H
+
+#include <vector>
+
+#include <common/utilities/TmcException.h>
+
+#include "./LaAllocator.h"
+#include "./LaSquareMatrix.h"
+#include "./LaVector.h"
+
+/**
+  Lazily evaluated vector arithmetic.
+  <BR><BR>
+  The operators below do not compute anything, they only build a small expression tree on the
+  stack. laAssign() evaluates the tree component by component in one loop, so
+  p = a*x + b*y - M*z needs neither temporary vectors nor a pass over memory per operation.
+  A matrix-vector product materializes its (usually element-wise) argument once before the loop
+  and forms the dot product of a matrix row in the loop, therefore the target may also appear
+  on the right hand side. Such buffers come from the arena of the thread (LaArena::local()) and
+  are given back when laAssign() returns.
+  <BR><BR>
+  Example:
+  <PRE>
+    laAssign(pvector, (1. - theta) * laVector(q, n) + theta * laVector(qn, n) - (*mmatrix) * (c2 * laVector(u2, n) - c0 * laVector(u0, n)));
+  </PRE>
+*/
+template <typename E>
+class LaVectorExpression
+{
+public:
+    const E &self() const { return static_cast<const E &>(*this); }
+};
+
+/*======================================================================*/
+/**
+  Leaf of an expression: components of an existing array, not copied.
+*/
+class LaVectorReference : public LaVectorExpression<LaVectorReference>
+{
+public:
+    LaVectorReference(const double *values, int size) : values(values), n(size) {}
+
+    int size() const { return this->n; }
+    double operator[](int i) const { return this->values[i]; }
+    void prepare() const {}
+
+private:
+    const double *values;
+    int n;
+};
+
+inline LaVectorReference laVector(const double *values, int size)
+{
+    return LaVectorReference(values, size);
+}
+inline LaVectorReference laVector(const std::vector<double> &values)
+{
+    return LaVectorReference(values.data(), (int)values.size());
+}
+inline LaVectorReference laVector(const LaVector &vector)
+{
+    return LaVectorReference(vector.data(), vector.getDimension());
+}
+inline LaVectorReference laVector(LaVector *vector)
+{
+    return LaVectorReference(vector->data(), vector->getDimension());
+}
+
+/*======================================================================*/
+/**
+  factor * expression
+*/
+template <typename E>
+class LaVectorScaled : public LaVectorExpression<LaVectorScaled<E> >
+{
+public:
+    LaVectorScaled(double factor, const E &expression) : factor(factor), expression(expression) {}
+
+    int size() const { return this->expression.size(); }
+    double operator[](int i) const { return this->factor * this->expression[i]; }
+    void prepare() const { this->expression.prepare(); }
+
+private:
+    double factor;
+    E expression;
+};
+
+/*======================================================================*/
+/**
+  left + right
+*/
+template <typename L, typename R>
+class LaVectorSum : public LaVectorExpression<LaVectorSum<L, R> >
+{
+public:
+    LaVectorSum(const L &left, const R &right) : left(left), right(right) {}
+
+    int size() const { return this->left.size(); }
+    double operator[](int i) const { return this->left[i] + this->right[i]; }
+    void prepare() const
+    {
+        if (this->left.size() != this->right.size())
+            throw TmcException(UB_EXARGS, "LaVectorSum - dimensions differ");
+        this->left.prepare();
+        this->right.prepare();
+    }
+
+private:
+    L left;
+    R right;
+};
+
+/*======================================================================*/
+/**
+  left - right
+*/
+template <typename L, typename R>
+class LaVectorDifference : public LaVectorExpression<LaVectorDifference<L, R> >
+{
+public:
+    LaVectorDifference(const L &left, const R &right) : left(left), right(right) {}
+
+    int size() const { return this->left.size(); }
+    double operator[](int i) const { return this->left[i] - this->right[i]; }
+    void prepare() const
+    {
+        if (this->left.size() != this->right.size())
+            throw TmcException(UB_EXARGS, "LaVectorDifference - dimensions differ");
+        this->left.prepare();
+        this->right.prepare();
+    }
+
+private:
+    L left;
+    R right;
+};
+
+/*======================================================================*/
+/**
+  matrix * expression
+  <BR>
+  prepare() evaluates the argument into a buffer of the thread arena, operator[] is the dot
+  product of one matrix row with this buffer. The buffer lives until the enclosing laAssign()
+  returns. A zero matrix (e.g. no damping) costs nothing, the argument is not even evaluated,
+  a scaled identity scales the argument without buffer and dot products.
+*/
+template <typename E>
+class LaMatrixVectorProduct : public LaVectorExpression<LaMatrixVectorProduct<E> >
+{
+public:
+    LaMatrixVectorProduct(LaSquareMatrix &matrix, const E &expression) : matrix(&matrix), expression(expression), argument(NULL), scaled(false), scale(0.0) {}
+
+    int size() const { return this->matrix->getRowNumber(); }
+    double operator[](int i) const
+    {
+        if (this->scaled)
+            return this->scale == 0.0 ? 0.0 : this->scale * this->expression[i];
+        const double *row = this->matrix->getRow(i);
+        const double *x = this->argument;
+        const int n = this->expression.size();
+        double sum = 0.0;
+        for (int j = 0; j < n; j++)
+            sum += row[j] * x[j];
+        return sum;
+    }
+    void prepare() const
+    {
+        const int n = this->expression.size();
+        if (this->matrix->getColumnNumber() != n)
+            throw TmcException(UB_EXARGS, "LaMatrixVectorProduct - dimensions do not fit");
+        this->scaled = this->matrix->isScaledIdentityMatrix(&this->scale);
+        if (this->scaled && this->scale == 0.0)
+            return;
+        this->expression.prepare();
+        if (this->scaled)
+            return;
+        this->argument = LaArena::local().allocate<double>(n);
+        for (int j = 0; j < n; j++)
+            this->argument[j] = this->expression[j];
+    }
+
+private:
+    LaSquareMatrix *matrix;
+    E expression;
+    mutable double *argument;
+    mutable bool scaled;
+    mutable double scale;
+};
+
+/*======================================================================*/
+/*  Operators                                                           */
+/*                                                                      */
+template <typename E>
+inline LaVectorScaled<E> operator*(double factor, const LaVectorExpression<E> &expression)
+{
+    return LaVectorScaled<E>(factor, expression.self());
+}
+template <typename E>
+inline LaVectorScaled<E> operator*(const LaVectorExpression<E> &expression, double factor)
+{
+    return LaVectorScaled<E>(factor, expression.self());
+}
+template <typename E>
+inline LaVectorScaled<E> operator-(const LaVectorExpression<E> &expression)
+{
+    return LaVectorScaled<E>(-1.0, expression.self());
+}
+template <typename L, typename R>
+inline LaVectorSum<L, R> operator+(const LaVectorExpression<L> &left, const LaVectorExpression<R> &right)
+{
+    return LaVectorSum<L, R>(left.self(), right.self());
+}
+template <typename L, typename R>
+inline LaVectorDifference<L, R> operator-(const LaVectorExpression<L> &left, const LaVectorExpression<R> &right)
+{
+    return LaVectorDifference<L, R>(left.self(), right.self());
+}
+template <typename E>
+inline LaMatrixVectorProduct<E> operator*(LaSquareMatrix &matrix, const LaVectorExpression<E> &expression)
+{
+    return LaMatrixVectorProduct<E>(matrix, expression.self());
+}
+
+/*======================================================================*/
+/*  Evaluation                                                          */
+/*                                                                      */
+/**
+  target[i] = expression[i] for all components, one loop.
+  @exception TmcException if the dimensions do not fit
+*/
+template <typename E>
+inline void laAssign(double *target, int size, const LaVectorExpression<E> &expression)
+{
+    const E &e = expression.self();
+    if (e.size() != size)
+        throw TmcException(UB_EXARGS, "laAssign - dimensions differ");
+    LaArenaScope scope;
+    e.prepare();
+    for (int i = 0; i < size; i++)
+        target[i] = e[i];
+}
+template <typename E>
+inline void laAssign(LaVector &target, const LaVectorExpression<E> &expression)
+{
+    laAssign(target.data(), target.getDimension(), expression);
+}
+template <typename E>
+inline void laAssign(LaVector *target, const LaVectorExpression<E> &expression)
+{
+    laAssign(target->data(), target->getDimension(), expression);
+}
+
+#endif
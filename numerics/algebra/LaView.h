@@ -0,0 +1,233 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    non-owning strided and gathered views on vectors and matrices
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LAVIEW_H
+#define LAVIEW_H
+
+#include <cstddef>
+
+/**
+  Non-owning views on vector and matrix storage.
+  <BR><BR>
+  A view is a pointer, a size and a stride, optionally an index array which gathers the
+  entries (entry i is values[index[i] * stride]). Views are copied by value and never copy,
+  allocate or free the values, so rows, columns, sub-blocks and index-selected parts of a
+  matrix can be handed to kernels and solvers without temporaries. A view is only valid as
+  long as the storage (and the index array) it refers to.
+  <BR><BR>
+  LaVectorView and LaMatrixView write through, LaConstVectorView and LaConstMatrixView are
+  read only.
+  <BR><BR>
+  Example:
+  <PRE>
+    LaConstMatrixView known = matrix.view().select(left.data(), (int)left.size(), left.data(), (int)left.size());
+    LaConstVectorView column = matrix.view().column(3);
+    double sum = known.row(0).dot(vector.view().gather(left.data(), (int)left.size()));
+  </PRE>
+*/
+template <typename T>
+class LaVectorSpan
+{
+public:
+    LaVectorSpan() : values(NULL), size(0), stride(1), index(NULL) {}
+    LaVectorSpan(T *values, int size, int stride = 1) : values(values), size(size), stride(stride), index(NULL) {}
+    LaVectorSpan(T *values, const int *index, int size, int stride = 1) : values(values), size(size), stride(stride), index(index) {}
+    /** a writable view converts to a read-only view */
+    template <typename S>
+    LaVectorSpan(const LaVectorSpan<S> &view) : values(view.getValues()), size(view.getDimension()), stride(view.getStride()), index(view.getIndex()) {}
+
+    int getDimension() const { return this->size; }
+    int getStride() const { return this->stride; }
+    T *getValues() const { return this->values; }
+    const int *getIndex() const { return this->index; }
+    /** true if the entries follow each other in memory */
+    bool isContiguous() const { return this->index == NULL && this->stride == 1; }
+
+    T &operator[](int i) const { return this->values[(this->index ? this->index[i] : i) * this->stride]; }
+
+    /**
+      The entries start, start + step, ..., start + (length - 1) * step of this view.
+      A step other than 1 is only possible for views which are not gathered.
+    */
+    LaVectorSpan sub(int start, int length, int step = 1) const
+    {
+        if (this->index)
+            return LaVectorSpan(this->values, this->index + start, length, this->stride);
+        return LaVectorSpan(this->values + (size_t)start * this->stride, length, this->stride * step);
+    }
+    /**
+      The entries index[0], ..., index[length - 1] of this view, the view must not be gathered itself.
+    */
+    LaVectorSpan gather(const int *index, int length) const { return LaVectorSpan(this->values, index, length, this->stride); }
+
+    template <typename S>
+    double dot(const LaVectorSpan<S> &other) const
+    {
+        double sum = 0.0;
+        for (int i = 0; i < this->size; i++)
+            sum += (*this)[i] * other[i];
+        return sum;
+    }
+    template <typename S>
+    void assign(const LaVectorSpan<S> &other) const
+    {
+        for (int i = 0; i < this->size; i++)
+            (*this)[i] = other[i];
+    }
+    void fill(double value) const
+    {
+        for (int i = 0; i < this->size; i++)
+            (*this)[i] = value;
+    }
+    /** copies the entries into a contiguous array */
+    void copyTo(double *target) const
+    {
+        for (int i = 0; i < this->size; i++)
+            target[i] = (*this)[i];
+    }
+
+private:
+    T *values;
+    int size;
+    int stride;
+    const int *index;
+};
+
+typedef LaVectorSpan<double> LaVectorView;
+typedef LaVectorSpan<const double> LaConstVectorView;
+
+/*======================================================================*/
+/**
+  Row-major matrix view, element (i,j) is values[row(i) * leadingDimension + column(j)] where
+  row() and column() are the identity or an index array.
+*/
+template <typename T>
+class LaMatrixSpan
+{
+public:
+    LaMatrixSpan() : values(NULL), rows(0), columns(0), leadingDimension(0), rowIndex(NULL), columnIndex(NULL) {}
+    LaMatrixSpan(T *values, int rows, int columns, int leadingDimension, const int *rowIndex = NULL, const int *columnIndex = NULL)
+        : values(values), rows(rows), columns(columns), leadingDimension(leadingDimension), rowIndex(rowIndex), columnIndex(columnIndex)
+    {
+    }
+    template <typename S>
+    LaMatrixSpan(const LaMatrixSpan<S> &view)
+        : values(view.getValues()), rows(view.getRowNumber()), columns(view.getColumnNumber()), leadingDimension(view.getLeadingDimension()),
+          rowIndex(view.getRowIndex()), columnIndex(view.getColumnIndex())
+    {
+    }
+
+    int getRowNumber() const { return this->rows; }
+    int getColumnNumber() const { return this->columns; }
+    int getLeadingDimension() const { return this->leadingDimension; }
+    T *getValues() const { return this->values; }
+    const int *getRowIndex() const { return this->rowIndex; }
+    const int *getColumnIndex() const { return this->columnIndex; }
+
+    T &operator()(int i, int j) const { return this->values[this->rowOffset(i) + (this->columnIndex ? this->columnIndex[j] : j)]; }
+
+    LaVectorSpan<T> row(int i) const
+    {
+        if (this->columnIndex)
+            return LaVectorSpan<T>(this->values + this->rowOffset(i), this->columnIndex, this->columns);
+        return LaVectorSpan<T>(this->values + this->rowOffset(i), this->columns);
+    }
+    LaVectorSpan<T> column(int j) const
+    {
+        T *start = this->values + (this->columnIndex ? this->columnIndex[j] : j);
+        if (this->rowIndex)
+            return LaVectorSpan<T>(start, this->rowIndex, this->rows, this->leadingDimension);
+        return LaVectorSpan<T>(start, this->rows, this->leadingDimension);
+    }
+    /**
+      The rows row, ..., row + rowCount - 1 and columns column, ..., column + columnCount - 1.
+    */
+    LaMatrixSpan block(int row, int column, int rowCount, int columnCount) const
+    {
+        T *start = this->values;
+        const int *ri = this->rowIndex;
+        const int *ci = this->columnIndex;
+        if (ri)
+            ri += row;
+        else
+            start += (size_t)row * this->leadingDimension;
+        if (ci)
+            ci += column;
+        else
+            start += column;
+        return LaMatrixSpan(start, rowCount, columnCount, this->leadingDimension, ri, ci);
+    }
+    /**
+      The rows rowIndex[0..rowCount) and columns columnIndex[0..columnCount), the view must not be gathered itself.
+      A NULL index keeps all rows or columns.
+    */
+    LaMatrixSpan select(const int *rowIndex, int rowCount, const int *columnIndex, int columnCount) const
+    {
+        return LaMatrixSpan(this->values, rowIndex ? rowCount : this->rows, columnIndex ? columnCount : this->columns, this->leadingDimension, rowIndex, columnIndex);
+    }
+
+    /**
+      target += factor * this * vector
+    */
+    template <typename S>
+    void multiplyAdd(const LaVectorSpan<S> &vector, const LaVectorSpan<double> &target, double factor = 1.0) const
+    {
+        for (int i = 0; i < this->rows; i++)
+            target[i] += factor * this->row(i).dot(vector);
+    }
+    /** copies the elements into a row-major array with rows of length targetStride */
+    void copyTo(double *target, int targetStride) const
+    {
+        for (int i = 0; i < this->rows; i++)
+            this->row(i).copyTo(target + (size_t)i * targetStride);
+    }
+
+private:
+    size_t rowOffset(int i) const { return (size_t)(this->rowIndex ? this->rowIndex[i] : i) * this->leadingDimension; }
+
+    T *values;
+    int rows;
+    int columns;
+    int leadingDimension;
+    const int *rowIndex;
+    const int *columnIndex;
+};
+
+typedef LaMatrixSpan<double> LaMatrixView;
+typedef LaMatrixSpan<const double> LaConstMatrixView;
+
+#endif
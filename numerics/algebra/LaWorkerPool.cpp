@@ -0,0 +1,131 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    threads which are kept for repeated parallel work
+
+\*---------------------------------------------------------------------------*/
+
+#include "./LaWorkerPool.h"
+
+using namespace std;
+
+/*======================================================================*/
+LaWorkerPool::LaWorkerPool()
+    : task(NULL), threads(0), running(0), generation(0), stop(false)
+{
+}
+/*======================================================================*/
+LaWorkerPool::~LaWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mtx);
+        this->stop = true;
+    }
+    this->wake.notify_all();
+    for (size_t t = 0; t < this->workers.size(); t++)
+        this->workers[t].join();
+}
+/*======================================================================*/
+void LaWorkerPool::run(int threads, const Task &task)
+{
+    if (threads <= 1)
+    {
+        task(0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> runLock(this->runMutex);
+    {
+        std::lock_guard<std::mutex> lock(this->mtx);
+        while ((int)this->workers.size() < threads - 1)
+            this->workers.push_back(std::thread(&LaWorkerPool::work, this, (int)this->workers.size() + 1, this->generation));
+        this->task = &task;
+        this->threads = threads;
+        this->running = threads - 1;
+        this->failure = nullptr;
+        this->generation++;
+    }
+    this->wake.notify_all();
+
+    try
+    {
+        task(0);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(this->mtx);
+        if (!this->failure)
+            this->failure = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(this->mtx);
+    this->finished.wait(lock, [this]() { return this->running == 0; });
+    this->task = NULL;
+    if (this->failure)
+    {
+        std::exception_ptr failure = this->failure;
+        this->failure = nullptr;
+        std::rethrow_exception(failure);
+    }
+}
+/*======================================================================*/
+void LaWorkerPool::work(int thread, long generation)
+{
+    std::unique_lock<std::mutex> lock(this->mtx);
+    for (;;)
+    {
+        this->wake.wait(lock, [&]() { return this->stop || this->generation != generation; });
+        if (this->stop)
+            return;
+        generation = this->generation;
+        if (thread >= this->threads)
+            continue; //< not needed in this run
+
+        const Task &task = *this->task;
+        lock.unlock();
+        try
+        {
+            task(thread);
+        }
+        catch (...)
+        {
+            lock.lock();
+            if (!this->failure)
+                this->failure = std::current_exception();
+            lock.unlock();
+        }
+        lock.lock();
+        if (--this->running == 0)
+            this->finished.notify_one();
+    }
+}
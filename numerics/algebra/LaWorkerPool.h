@@ -0,0 +1,99 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    threads which are kept for repeated parallel work
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef LAWORKERPOOL_H
+#define LAWORKERPOOL_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <TmcMacroFile.h>
+
+/**
+  Threads which are started once and wait for the next parallel section, for work which is
+  repeated often, e.g. the factorization and solve of every time step. Starting and joining
+  new threads for every call would cost more than small sections save.
+  <BR><BR>
+  run() calls the task on the calling thread and on the workers and returns when all have
+  finished. The workers are started with the first run() which needs them. An exception of a
+  task is thrown again by run() once all threads have finished.
+  <BR><BR>
+  Example:
+  <PRE>
+    LaWorkerPool pool;
+    pool.run(4, [&](int thread) { work(thread); }); //thread 0 is the calling thread
+  </PRE>
+*/
+class TMC_DLL_EXPORT LaWorkerPool
+{
+public:
+    typedef std::function<void(int thread)> Task;
+
+public:
+    LaWorkerPool();
+    /** stops and joins the workers */
+    ~LaWorkerPool();
+
+    /** calls task(thread) for thread = 0 ... threads - 1, thread 0 on the calling thread */
+    void run(int threads, const Task &task);
+
+    int getWorkerNumber() const { return (int)this->workers.size(); }
+
+private:
+    LaWorkerPool(const LaWorkerPool &);
+    LaWorkerPool &operator=(const LaWorkerPool &);
+
+    void work(int thread, long generation);
+
+    std::vector<std::thread> workers;
+    std::mutex runMutex; //< one run() at a time
+    std::mutex mtx;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const Task *task;
+    int threads;     //< threads of the current run
+    int running;     //< workers of the current run which are still busy
+    long generation; //< number of the current run
+    bool stop;
+    std::exception_ptr failure;
+};
+
+#endif
@@ -4,6 +4,16 @@ set(ALGEBRA_SOURCES
   ${SOURCE_ROOT}/numerics/algebra/LaVector.cpp
   ${SOURCE_ROOT}/numerics/algebra/LaSquareMatrix.cpp
   ${SOURCE_ROOT}/numerics/algebra/LaLinearEquation.cpp
+  ${SOURCE_ROOT}/numerics/algebra/LaBinaryFormat.cpp
+  ${SOURCE_ROOT}/numerics/algebra/LaAllocator.cpp
+  ${SOURCE_ROOT}/numerics/algebra/LaMatrixStructure.cpp
+  ${SOURCE_ROOT}/numerics/algebra/LaPermutation.cpp
+  ${SOURCE_ROOT}/numerics/algebra/LaSparseMatrix.cpp
+  ${SOURCE_ROOT}/numerics/algebra/LaSparseCholesky.cpp
+  ${SOURCE_ROOT}/numerics/algebra/LaLinearOperator.cpp
+  ${SOURCE_ROOT}/numerics/algebra/LaConjugateGradient.cpp
+  ${SOURCE_ROOT}/numerics/algebra/LaAssembler.cpp
+  ${SOURCE_ROOT}/numerics/algebra/LaWorkerPool.cpp
 )
 
 
@@ -1,8 +1,11 @@
 
 set(SOURCES
+  ${SOURCE_ROOT}/numerics/structuralsolver/TmcAdaptiveTimeStepper.cpp
   ${SOURCE_ROOT}/numerics/structuralsolver/TmcInitialValueSolver.cpp
   ${SOURCE_ROOT}/numerics/structuralsolver/TmcInitialValue3rdOrderSolver.cpp
+  ${SOURCE_ROOT}/numerics/structuralsolver/TmcProbe.cpp
   ${SOURCE_ROOT}/numerics/structuralsolver/beam/TmcBeam.cpp
+  ${SOURCE_ROOT}/numerics/structuralsolver/beam/TmcBeamOperator.cpp
   ${SOURCE_ROOT}/numerics/structuralsolver/beam/TmcBeamSystem.cpp
   ${SOURCE_ROOT}/numerics/structuralsolver/massoscillator/TmcMassOscillator.cpp
 )
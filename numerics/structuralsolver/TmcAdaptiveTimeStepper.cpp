@@ -0,0 +1,335 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    adaptive time step control for the initial value solvers
+
+\*---------------------------------------------------------------------------*/
+
+#include "./TmcAdaptiveTimeStepper.h"
+#include "./TmcInitialValueSolver.h"
+
+#include <common/utilities/TmcException.h>
+#include <common/utilities/TmcSystem.h>
+#include <common/utilities/TmcTrace.h>
+
+#include <algorithm>
+#include <cmath>
+
+/*============================================================*/
+TmcAdaptiveTimeStepper::TmcAdaptiveTimeStepper(TmcInitialValueSolver *solver, const Load &load)
+    : solver(solver), load(load), relativeTolerance(1e-4), absoluteTolerance(1e-8), bucketsPerOctave(2), lastError(1.0),
+      stepStart(0.0), stepEnd(0.0), outputInterval(0.0), outputTime(0.0), acceptedSteps(0), rejectedSteps(0)
+{
+    if (solver == NULL)
+        throw TmcException(UB_EXARGS, "TmcAdaptiveTimeStepper - no solver");
+
+    const int n = solver->getDegreeOfFreedom();
+    this->loadvector = LaVector(n, "Load");
+    this->deltaT0 = solver->getDeltaT();
+    this->minimumDeltaT = this->deltaT0 / 1024.0;
+    this->maximumDeltaT = this->deltaT0 * 64.0;
+    this->proposedDeltaT = this->deltaT0;
+    this->startU.assign(n, 0.0);
+    this->startV.assign(n, 0.0);
+    this->startA.assign(n, 0.0);
+    this->stateU.assign(n, 0.0);
+    this->stateV.assign(n, 0.0);
+    this->scale.assign(n, 0.0);
+    this->state.push_back(this->stateU.data());
+    this->state.push_back(this->stateV.data());
+
+    // the step widths alternate between a few buckets
+    this->solver->setStepMatrixCacheSize(std::max(this->solver->getStepMatrixCacheSize(), 4));
+}
+/*============================================================*/
+void TmcAdaptiveTimeStepper::setTolerance(double relative, double absolute)
+{
+    if (relative < 0.0 || absolute < 0.0 || relative + absolute <= 0.0)
+        throw TmcException(UB_EXARGS, "TmcAdaptiveTimeStepper - invalid tolerances");
+    this->relativeTolerance = relative;
+    this->absoluteTolerance = absolute;
+}
+/*============================================================*/
+void TmcAdaptiveTimeStepper::setDeltaTLimits(double minimum, double maximum)
+{
+    if (minimum <= 0.0 || maximum < minimum)
+        throw TmcException(UB_EXARGS, "TmcAdaptiveTimeStepper - invalid step width limits");
+    this->minimumDeltaT = minimum;
+    this->maximumDeltaT = maximum;
+}
+/*============================================================*/
+void TmcAdaptiveTimeStepper::setBucketsPerOctave(int buckets)
+{
+    this->bucketsPerOctave = std::max(buckets, 1);
+}
+/*============================================================*/
+void TmcAdaptiveTimeStepper::setOutput(double interval, const Output &output)
+{
+    if (interval <= 0.0)
+        throw TmcException(UB_EXARGS, "TmcAdaptiveTimeStepper - invalid output interval");
+    this->outputInterval = interval;
+    this->outputTime = this->solver->getTime();
+    this->output = output;
+}
+/*============================================================*/
+int TmcAdaptiveTimeStepper::addEvent(const EventFunction &function, int direction, bool terminal)
+{
+    EventFunctionEntry entry;
+    entry.function = function;
+    entry.direction = direction;
+    entry.terminal = terminal;
+    entry.value = 0.0;
+    this->eventFunctions.push_back(entry);
+    return (int)this->eventFunctions.size() - 1;
+}
+/*============================================================*/
+double TmcAdaptiveTimeStepper::integrate(double endTime)
+{
+    TMC_TRACE_SCOPE("adaptive time integration", "solver");
+    TmcInitialValueSolver &s = *this->solver;
+    if (s.getTheta() != 1.0)
+        throw TmcException(UB_EXARGS, "TmcAdaptiveTimeStepper - only for theta = 1");
+    const double errorFactor = std::fabs(s.getBeta() - 1.0 / 6.0);
+    if (errorFactor < 1e-10)
+        throw TmcException(UB_EXARGS, "TmcAdaptiveTimeStepper - no error estimate for beta = 1/6");
+
+    double time = s.getTime();
+    const double timeEpsilon = 1e-12 * std::max(std::fabs(endTime), this->deltaT0);
+
+    // the start state, nothing to interpolate yet
+    s.getDisplacement().copyTo(this->startU.data());
+    s.getVelocity().copyTo(this->startV.data());
+    s.getAcceleration().copyTo(this->startA.data());
+    this->stepStart = this->stepEnd = time;
+    for (int i = 0; i < (int)this->scale.size(); i++)
+        this->scale[i] = std::max(this->scale[i], std::fabs(this->startU[i]));
+    for (int e = 0; e < (int)this->eventFunctions.size(); e++)
+        this->eventFunctions[e].value = this->evaluateEvent(e, time);
+
+    bool stop = false;
+    while (!stop && time < endTime - timeEpsilon)
+    {
+        TMC_TRACE_SCOPE("adaptive time step", "solver");
+        double deltaT = this->getBucket(this->proposedDeltaT);
+        // the last steps end exactly at endTime without a tiny rest and without growing,
+        // their step widths lie between the buckets and stay out of the step matrix cache
+        const double rest = endTime - time;
+        bool bucket = true;
+        if (rest <= deltaT)
+        {
+            bucket = rest == deltaT;
+            deltaT = rest;
+        }
+        else if (rest < 1.5 * deltaT)
+        {
+            bucket = false;
+            deltaT = 0.5 * rest;
+        }
+
+        s.setDeltaT(deltaT, bucket);
+        this->loadvector.setValues(0.0);
+        this->load(time + deltaT, this->loadvector);
+        s.getCalculatedNextTimeStepSolution(&this->loadvector, false);
+
+        const double error = this->getErrorNorm(errorFactor * deltaT * deltaT);
+        if (error > 1.0 && deltaT > this->minimumDeltaT)
+        {
+            // repeated, the local error is O(dT^3)
+            this->rejectedSteps++;
+            this->proposedDeltaT = std::max(deltaT * std::max(0.2, 0.9 * std::pow(error, -1.0 / 3.0)), this->minimumDeltaT);
+            continue;
+        }
+
+        // PI controller (Gustafsson)
+        const double boundedError = std::max(error, 1e-10);
+        double factor = 0.9 * std::pow(boundedError, -0.7 / 3.0) * std::pow(this->lastError, 0.4 / 3.0);
+        factor = std::min(std::max(factor, 0.2), 5.0);
+        if (error > 1.0)
+            factor = std::min(factor, 1.0);
+        this->lastError = std::max(error, 1e-4);
+
+        // the interpolation runs from the solver state to the trial state
+        s.getDisplacement().copyTo(this->startU.data());
+        s.getVelocity().copyTo(this->startV.data());
+        s.getAcceleration().copyTo(this->startA.data());
+        this->stepStart = time;
+        this->stepEnd = time + deltaT;
+
+        // events, the earliest terminal one ends the integration
+        double terminalTime = this->stepEnd;
+        int terminalEvent = -1;
+        std::vector<Event> found;
+        for (int e = 0; e < (int)this->eventFunctions.size(); e++)
+        {
+            EventFunctionEntry &entry = this->eventFunctions[e];
+            const double g0 = entry.value;
+            const double g1 = this->evaluateEvent(e, this->stepEnd);
+            const bool rising = g0 < 0.0 && g1 >= 0.0;
+            const bool falling = g0 > 0.0 && g1 <= 0.0;
+            if ((rising && entry.direction >= 0) || (falling && entry.direction <= 0))
+            {
+                Event event;
+                event.index = e;
+                event.time = this->locateEvent(e, g0, g1);
+                found.push_back(event);
+                if (entry.terminal && event.time < terminalTime)
+                {
+                    terminalTime = event.time;
+                    terminalEvent = e;
+                }
+            }
+            entry.value = g1;
+        }
+        std::sort(found.begin(), found.end(), [](const Event &a, const Event &b) { return a.time < b.time; });
+        for (int e = 0; e < (int)found.size(); e++)
+            if (found[e].time <= terminalTime)
+                this->events.push_back(found[e]);
+
+        // output of the interpolated state up to the end of the step (or the terminal event)
+        while (this->output && this->outputTime <= terminalTime + timeEpsilon && !stop)
+        {
+            this->interpolate(this->outputTime, this->stateU.data(), this->stateV.data());
+            stop = !this->output(this->outputTime, this->state);
+            this->outputTime += this->outputInterval;
+        }
+
+        if (terminalEvent >= 0)
+        {
+            // the step onto the zero is not part of the step width control
+            this->stepEnd = terminalTime;
+            s.setDeltaT(terminalTime - time, false);
+            this->loadvector.setValues(0.0);
+            this->load(terminalTime, this->loadvector);
+            s.getCalculatedNextTimeStepSolution(&this->loadvector, false);
+            stop = true;
+        }
+
+        s.acceptNextTimeStep();
+        this->acceptedSteps++;
+        const LaConstVectorView u = s.getDisplacement();
+        for (int i = 0; i < (int)this->scale.size(); i++)
+            this->scale[i] = std::max(this->scale[i], std::fabs(u[i]));
+        time = this->stepEnd;
+        // an accepted step width is kept unless it can grow by a bucket at least,
+        // small changes would switch between two step matrices
+        if (error > 1.0 || factor > 1.5)
+            this->proposedDeltaT = std::min(std::max(deltaT * factor, this->minimumDeltaT), this->maximumDeltaT);
+        else
+            this->proposedDeltaT = deltaT;
+    }
+    // the solver time is summed up step by step
+    return time;
+}
+/*============================================================*/
+// cubic Hermite polynomials of u (with v) and of v (with a) between the start state and the end
+// state of the last step, the end state is the last trial state of the solver
+void TmcAdaptiveTimeStepper::interpolate(double time, double *displacement, double *velocity) const
+{
+    const int n = this->solver->getDegreeOfFreedom();
+    const double h = this->stepEnd - this->stepStart;
+    if (h <= 0.0)
+    {
+        std::copy(this->startU.begin(), this->startU.end(), displacement);
+        std::copy(this->startV.begin(), this->startV.end(), velocity);
+        return;
+    }
+    const LaConstVectorView u1 = this->solver->getNextDisplacement();
+    const LaConstVectorView v1 = this->solver->getNextVelocity();
+    const LaConstVectorView a1 = this->solver->getNextAcceleration();
+
+    const double s = std::min(std::max((time - this->stepStart) / h, 0.0), 1.0);
+    const double h00 = (2.0 * s - 3.0) * s * s + 1.0;
+    const double h10 = ((s - 2.0) * s + 1.0) * s * h;
+    const double h01 = (3.0 - 2.0 * s) * s * s;
+    const double h11 = (s - 1.0) * s * s * h;
+    for (int i = 0; i < n; i++)
+    {
+        displacement[i] = h00 * this->startU[i] + h10 * this->startV[i] + h01 * u1[i] + h11 * v1[i];
+        velocity[i] = h00 * this->startV[i] + h10 * this->startA[i] + h01 * v1[i] + h11 * a1[i];
+    }
+}
+/*============================================================*/
+double TmcAdaptiveTimeStepper::getBucket(double deltaT) const
+{
+    deltaT = std::min(std::max(deltaT, this->minimumDeltaT), this->maximumDeltaT);
+    const double k = std::floor(this->bucketsPerOctave * std::log2(deltaT / this->deltaT0) + 1e-9);
+    const double bucket = this->deltaT0 * std::pow(2.0, k / this->bucketsPerOctave);
+    return std::min(std::max(bucket, this->minimumDeltaT), this->maximumDeltaT);
+}
+/*============================================================*/
+// weighted root mean square of factor (a(n+1) - a(n))
+double TmcAdaptiveTimeStepper::getErrorNorm(double factor) const
+{
+    const LaConstVectorView u0 = this->solver->getDisplacement();
+    const LaConstVectorView u1 = this->solver->getNextDisplacement();
+    const LaConstVectorView a0 = this->solver->getAcceleration();
+    const LaConstVectorView a1 = this->solver->getNextAcceleration();
+    const int n = u0.getDimension();
+    double sum = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        const double error = factor * (a1[i] - a0[i]);
+        const double weight = this->absoluteTolerance + this->relativeTolerance * std::max(this->scale[i], std::fabs(u1[i]));
+        sum += (error / weight) * (error / weight);
+    }
+    return n > 0 ? std::sqrt(sum / n) : 0.0;
+}
+/*============================================================*/
+double TmcAdaptiveTimeStepper::evaluateEvent(int index, double time)
+{
+    this->interpolate(time, this->stateU.data(), this->stateV.data());
+    return this->eventFunctions[index].function(time, this->state);
+}
+/*============================================================*/
+// Illinois variant of the regula falsi in the interpolated state
+double TmcAdaptiveTimeStepper::locateEvent(int index, double g0, double g1)
+{
+    double a = this->stepStart, b = this->stepEnd;
+    double ga = g0, gb = g1;
+    const double tolerance = 1e-12 * std::max(std::fabs(b), b - a);
+    for (int iteration = 0; iteration < 100 && gb != 0.0 && std::fabs(b - a) > tolerance; iteration++)
+    {
+        const double c = b - gb * (b - a) / (gb - ga);
+        const double gc = this->evaluateEvent(index, c);
+        if (gc * gb < 0.0)
+        {
+            a = b;
+            ga = gb;
+        }
+        else
+            ga *= 0.5;
+        b = c;
+        gb = gc;
+    }
+    return b;
+}
@@ -0,0 +1,180 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    adaptive time step control for the initial value solvers
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TMCADAPTIVETIMESTEPPER_H
+#define TMCADAPTIVETIMESTEPPER_H
+
+#include <functional>
+#include <vector>
+
+#include <TmcMacroFile.h>
+
+#include <numerics/algebra/LaVector.h>
+
+class TmcInitialValueSolver;
+
+/**
+  Adaptive time step control for TmcInitialValueSolver (Newmark or generalized alpha, theta = 1).
+  <BR><BR>
+  Every step is calculated as trial first. The local error of the displacements is estimated
+  from the change of the acceleration, e = |beta - 1/6| dT^2 (a(n+1) - a(n)) (Zienkiewicz, Xie),
+  and measured in the root mean square norm weighted with absolute + relative max |u|, the
+  largest displacement so far (zero crossings don't shrink the step width). A step with
+  a norm above 1 is repeated with a smaller step width, the width of the next step follows a
+  PI controller. The step widths are rounded down to the buckets dT0 2^(k / bucketsPerOctave)
+  of the start step width dT0, so only a few distinct step matrices occur and the solver keeps
+  their factorizations (TmcInitialValueSolver::setStepMatrixCacheSize). The steps onto the end
+  time and onto a terminal event lie between the buckets and stay out of this cache.
+  <BR><BR>
+  The step width control pays off for responses with quiet phases, e.g. a load pulse followed
+  by a decaying vibration. A steadily forced oscillation needs about the same number of steps
+  as a fixed step width of the same accuracy, there fixed steps are cheaper.
+  <BR><BR>
+  Between two accepted steps the state is interpolated with cubic Hermite polynomials (dense
+  output). The interpolation gives the output at equidistant times and locates the zeros of
+  event functions, a terminal event ends the integration with a step onto the zero.
+  <BR><BR>
+  Example:
+  <PRE>
+    TmcAdaptiveTimeStepper stepper(&solver, [&](double time, LaVector &load) { load.setValue(tip, force(time)); });
+    stepper.setTolerance(1e-4, 1e-8);
+    stepper.setOutput(0.01, [&](double time, const std::vector<double *> &state) { ...; return true; });
+    solver.getCalculatedStartSolution(&startLoad);
+    stepper.integrate(10.0);
+  </PRE>
+*/
+class TMC_DLL_EXPORT TmcAdaptiveTimeStepper
+{
+public:
+    /** sets the load vector of the given time, the vector is zero before the call */
+    typedef std::function<void(double time, LaVector &load)> Load;
+    /** gets the interpolated state, [0] displacements, [1] velocities */
+    typedef std::function<double(double time, const std::vector<double *> &state)> EventFunction;
+    /** gets the interpolated state, return false to stop the integration after the current step */
+    typedef std::function<bool(double time, const std::vector<double *> &state)> Output;
+
+    struct Event
+    {
+        int index;
+        double time;
+    };
+
+public:
+    /**
+      The solver is referenced, it keeps at least 4 factorized step matrices from now on.
+      The start step width is the step width of the solver.
+    */
+    TmcAdaptiveTimeStepper(TmcInitialValueSolver *solver, const Load &load);
+
+    /** default relative 1e-4 (of the largest displacement so far), absolute 1e-8 */
+    void setTolerance(double relative, double absolute);
+    /** default dT0 / 1024 and 64 dT0 */
+    void setDeltaTLimits(double minimum, double maximum);
+    /** default 2, more buckets follow the error closer but need more factorizations */
+    void setBucketsPerOctave(int buckets);
+    /** output every interval, starting at the current time of the solver */
+    void setOutput(double interval, const Output &output);
+    /**
+      The zeros of the function in the interpolated state are recorded, see getEvents().
+      @param direction 1 only rising, -1 only falling, 0 both
+      @param terminal true -> the integration ends at the zero
+      @return index of the event
+    */
+    int addEvent(const EventFunction &function, int direction = 0, bool terminal = false);
+
+    /**
+      Integrates from the time of the solver to endTime, the start solution has to be calculated.
+      @return the reached time, before endTime after a terminal event or a stop of the output
+      @exception TmcException if the solver is no theta = 1 method or beta = 1/6 (no error estimate)
+    */
+    double integrate(double endTime);
+
+    /** interpolated state within the last accepted step, the arrays have the size of the system */
+    void interpolate(double time, double *displacement, double *velocity) const;
+
+    const std::vector<Event> &getEvents() const { return this->events; }
+    int getAcceptedSteps() const { return this->acceptedSteps; }
+    int getRejectedSteps() const { return this->rejectedSteps; }
+    /** error norm of the last accepted step, 1 is the tolerance */
+    double getLastError() const { return this->lastError; }
+
+private:
+    double getBucket(double deltaT) const;
+    double getErrorNorm(double factor) const;
+    double evaluateEvent(int index, double time);
+    double locateEvent(int index, double g0, double g1);
+
+    TmcInitialValueSolver *solver;
+    Load load;
+    LaVector loadvector;
+
+    double relativeTolerance;
+    double absoluteTolerance;
+    double deltaT0;
+    double minimumDeltaT;
+    double maximumDeltaT;
+    int bucketsPerOctave;
+    double proposedDeltaT;
+    double lastError;
+
+    // last accepted step: the start state is copied, the end state is the solver state
+    double stepStart;
+    double stepEnd;
+    std::vector<double> startU, startV, startA;
+    std::vector<double> stateU, stateV;
+    std::vector<double> scale; // largest displacements so far, reference of the relative tolerance
+    std::vector<double *> state;
+
+    double outputInterval;
+    double outputTime;
+    Output output;
+
+    struct EventFunctionEntry
+    {
+        EventFunction function;
+        int direction;
+        bool terminal;
+        double value;
+    };
+    std::vector<EventFunctionEntry> eventFunctions;
+    std::vector<Event> events;
+
+    int acceptedSteps;
+    int rejectedSteps;
+};
+
+#endif
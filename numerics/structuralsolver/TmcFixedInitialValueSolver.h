@@ -0,0 +1,256 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    standard initial value solver for a fixed number of degrees of freedom
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TMCFIXEDINITIALVALUESOLVER_H
+#define TMCFIXEDINITIALVALUESOLVER_H
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <common/utilities/TmcException.h>
+
+#include <numerics/algebra/LaFixedMatrix.h>
+#include <numerics/algebra/LaFixedVector.h>
+#include <numerics/structuralsolver/TmcThetaMethod.h>
+
+/**
+  TmcInitialValueSolver for systems with N degrees of freedom known at compile time
+  (single mass oscillator, small models).
+  <BR><BR>
+  Same theta method (Newmark, Wilson, generalized alpha) with the same coefficients
+  (TmcThetaMethod), but the matrices and the
+  state live on the stack and the effective matrix is factorized once in
+  getCalculatedStartSolution(), a time step does not allocate.
+*/
+template <int N>
+class TmcFixedInitialValueSolver
+{
+public:
+    TmcFixedInitialValueSolver(const LaFixedMatrix<N> &kMatrix, const LaFixedMatrix<N> &mMatrix, const LaFixedMatrix<N> &dMatrix, double deltaT)
+        : amatrix(LaFixedMatrix<N>::identity())
+    {
+        this->init(kMatrix, mMatrix, dMatrix, deltaT);
+    }
+
+    void init(const LaFixedMatrix<N> &kMatrix, const LaFixedMatrix<N> &mMatrix, const LaFixedMatrix<N> &dMatrix, double deltaT)
+    {
+        this->dT = deltaT;
+        this->time = 0.0;
+        // Newmark
+        this->theta = 1.0;
+        this->alpha = 0.5;
+        this->beta = 0.25;
+        this->alphaM = 0.0;
+        this->alphaF = 0.0;
+        this->fixedIndices.clear();
+        this->setMatrices(kMatrix, mMatrix, dMatrix);
+        this->u0.setValues(0.0);
+        this->u1.setValues(0.0);
+        this->u2.setValues(0.0);
+        this->q.setValues(0.0);
+    }
+    /**
+      Takes effect with the next getCalculatedStartSolution().
+    */
+    void setMatrices(const LaFixedMatrix<N> &kMatrix, const LaFixedMatrix<N> &mMatrix, const LaFixedMatrix<N> &dMatrix)
+    {
+        this->kmatrix = kMatrix;
+        this->mmatrix = mMatrix;
+        this->dmatrix = dMatrix;
+        for (int i = 0; i < (int)this->fixedIndices.size(); i++)
+            this->fixRow(this->fixedIndices[i]);
+    }
+
+    void setFixedIndex(int index)
+    {
+        this->fixedIndices.push_back(index);
+        this->fixRow(index);
+    }
+    void setDisplacement(int index, double value) { this->u0.value[index] = value; }
+
+    // Newmark: theta = 1.0;  alpha = 0.5; beta  = 0.25;
+    // Wilson:  theta = 1.37; alpha = 0.5; beta  = 1.0/6.0;
+    void setAlphaBetaThetaDeltaT(double alpha, double beta, double theta, double deltaT)
+    {
+        this->theta = theta;
+        this->alpha = alpha;
+        this->beta = beta;
+        this->alphaM = 0.0;
+        this->alphaF = 0.0;
+        this->dT = deltaT;
+    }
+    /**
+      Generalized alpha method, see TmcInitialValueSolver::setGeneralizedAlphaDeltaT.
+      @exception TmcException if alphaM or alphaF is not below 1
+    */
+    void setGeneralizedAlphaDeltaT(double alphaM, double alphaF, double alpha, double beta, double deltaT)
+    {
+        if (alphaF >= 1.0 || alphaM >= 1.0)
+            throw TmcException(UB_EXARGS, "TmcFixedInitialValueSolver - alphaM and alphaF must be below 1");
+        this->theta = 1.0;
+        this->alpha = alpha;
+        this->beta = beta;
+        this->alphaM = alphaM;
+        this->alphaF = alphaF;
+        this->dT = deltaT;
+    }
+
+    /*=====================================================*/
+    void getCalculatedStartSolution(const LaFixedVector<N> &load)
+    {
+        // k*u = f
+        this->u0 = this->kmatrix.solveLinearEquation(load);
+        this->u1.setValues(0.0);
+        this->q = load;
+
+        // m*a = -k*u - d*v
+        LaFixedVector<N> rhs = this->kmatrix.multiply(this->u0);
+        rhs.add(this->dmatrix.multiply(this->u1));
+        rhs.multiplyValue(-1.0);
+        this->u2 = this->mmatrix.solveLinearEquation(rhs);
+
+        const TmcThetaMethod method(this->alpha, this->beta, this->theta, this->alphaM, this->alphaF, this->dT);
+        LaFixedMatrix<N> a = this->kmatrix;
+        a.add(this->dmatrix, method.dFactor);
+        a.add(this->mmatrix, method.mFactor);
+        for (int i = 0; i < (int)this->fixedIndices.size(); i++)
+        {
+            const int index = this->fixedIndices[i];
+            for (int j = 0; j < N; j++)
+                a.setValue(index, j, 0.0);
+            a.setValue(index, index, 1.0);
+        }
+        this->amatrix = LaFixedLU<N>(a);
+        this->time = 0.0;
+    }
+
+    /*=====================================================*/
+    void getCalculatedNextTimeStepSolution(const LaFixedVector<N> &load, bool okForNextTimeStep)
+    {
+        const TmcThetaMethod method(this->alpha, this->beta, this->theta, this->alphaM, this->alphaF, this->dT);
+
+        LaFixedVector<N> pvector, mvector, dvector, kvector;
+        for (int j = 0; j < N; j++)
+        {
+            pvector.value[j] = method.loadOld * this->q.value[j] + method.loadNew * load.value[j];
+            mvector.value[j] = method.m2 * this->u2.value[j] - method.m1 * this->u1.value[j] - method.m0 * this->u0.value[j];
+            dvector.value[j] = method.d2 * this->u2.value[j] + method.d1 * this->u1.value[j] - method.d0 * this->u0.value[j];
+            kvector.value[j] = method.kU * this->u0.value[j];
+        }
+        pvector.add(this->mmatrix.multiply(mvector), -1.0);
+        pvector.add(this->dmatrix.multiply(dvector), -1.0);
+        if (method.kU != 0.0)
+            pvector.add(this->kmatrix.multiply(kvector), -1.0);
+        for (int i = 0; i < (int)this->fixedIndices.size(); i++)
+            pvector.value[this->fixedIndices[i]] = 0.0;
+
+        const LaFixedVector<N> ut = this->amatrix.solve(pvector);
+
+        for (int j = 0; j < N; j++)
+        {
+            const double u0 = this->u0.value[j];
+            const double u1 = this->u1.value[j];
+            const double u2 = this->u2.value[j];
+            this->u0n.value[j] = u0 + method.uT * (ut.value[j] - u0) + method.uV * u1 + method.uA * u2;
+            this->u1n.value[j] = method.vT * (ut.value[j] - u0) + method.vV * u1 + method.vA * u2;
+            this->u2n.value[j] = method.aT * (ut.value[j] - u0) + method.aV * u1 + method.aA * u2;
+        }
+
+        if (okForNextTimeStep)
+        {
+            this->q = load;
+            this->u0 = this->u0n;
+            this->u1 = this->u1n;
+            this->u2 = this->u2n;
+            this->time += this->dT;
+        }
+    }
+
+    /*=====================================================*/
+    const LaFixedVector<N> &getDisplacement() const { return this->u0; }
+    const LaFixedVector<N> &getVelocity() const { return this->u1; }
+    const LaFixedVector<N> &getAcceleration() const { return this->u2; }
+    /** state of the last time step, also if it was not accepted */
+    const LaFixedVector<N> &getTrialDisplacement() const { return this->u0n; }
+
+    int getDegreeOfFreedom() const { return N; }
+    double getDeltaT() const { return this->dT; }
+    double getTime() const { return this->time; }
+
+    std::string toString() const
+    {
+        std::stringstream ss;
+        ss << "TmcFixedInitialValueSolver<" << N << ">[theta=" << this->theta << ", alpha=" << this->alpha << ", beta=" << this->beta;
+        if (this->alphaM != 0.0 || this->alphaF != 0.0)
+            ss << ", alphaM=" << this->alphaM << ", alphaF=" << this->alphaF;
+        ss << ", dT=" << this->dT << "]";
+        return ss.str();
+    }
+
+private:
+    void fixRow(int index)
+    {
+        for (int j = 0; j < N; j++)
+        {
+            this->kmatrix.setValue(index, j, 0.0);
+            this->dmatrix.setValue(index, j, 0.0);
+            this->mmatrix.setValue(index, j, 0.0);
+        }
+        this->kmatrix.setValue(index, index, 1.0);
+        this->dmatrix.setValue(index, index, 1.0);
+        this->mmatrix.setValue(index, index, 1.0);
+    }
+
+    std::vector<int> fixedIndices;
+    LaFixedMatrix<N> kmatrix;
+    LaFixedMatrix<N> mmatrix;
+    LaFixedMatrix<N> dmatrix;
+    LaFixedLU<N> amatrix;
+    LaFixedVector<N> u0, u0n;
+    LaFixedVector<N> u1, u1n;
+    LaFixedVector<N> u2, u2n;
+    LaFixedVector<N> q;
+    double dT;
+    double time;
+    double theta;
+    double alpha;
+    double beta;
+    double alphaM;
+    double alphaF;
+};
+#endif
@@ -41,9 +41,11 @@
 #include <numerics/algebra/LaLinearEquation.h>
 #include <numerics/algebra/LaSquareMatrix.h>
 #include <numerics/algebra/LaVector.h>
+#include <numerics/algebra/LaVectorExpression.h>
 
 #include <common/utilities/TmcFileInput.h>
 #include <common/utilities/TmcFileOutput.h>
+#include <common/utilities/TmcTrace.h>
 #include <common/math/TmcMath.h>
 
 /*============================================================*/
@@ -55,6 +57,7 @@ TmcInitialValue3rdOrderSolver::TmcInitialValue3rdOrderSolver(int degreeOfFreedom
 void TmcInitialValue3rdOrderSolver::init(int degreeOfFreedom, LaSquareMatrix *gMatrix, LaSquareMatrix *mMatrix, LaSquareMatrix *dMatrix, LaSquareMatrix *kMatrix, double deltaT)
 {
     this->dT = deltaT;
+    this->time = 0.0;
 
     this->degreeOfFreedom = degreeOfFreedom;
 
@@ -63,43 +66,29 @@ void TmcInitialValue3rdOrderSolver::init(int degreeOfFreedom, LaSquareMatrix *gM
     this->dmatrix = dMatrix;
     this->kmatrix = kMatrix;
 
-    this->xmatrix = new LaSquareMatrix(degreeOfFreedom);
+    this->xmatrix = LaSquareMatrix(degreeOfFreedom, "X-Matrix");
 
     this->theta = 1.0;      // 1.37;		//Wilson
     this->alpha = 0.5;      // 0.5;
     this->beta = 1.0 / 6.0; // 0.25//1.0/6.0;
     this->gamma = 1.0 / 24.0;
 
-    q = new double[degreeOfFreedom];
-    qn = new double[degreeOfFreedom];
-    ut = new double[degreeOfFreedom];
-    u0 = new double[degreeOfFreedom];
-    u1 = new double[degreeOfFreedom];
-    u2 = new double[degreeOfFreedom];
-    u3 = new double[degreeOfFreedom];
-    u0n = new double[degreeOfFreedom];
-    u1n = new double[degreeOfFreedom];
-    u2n = new double[degreeOfFreedom];
-    u3n = new double[degreeOfFreedom];
-    for (int i = 0; i < degreeOfFreedom; i++)
-    {
-        u0[i] = 0.0;
-        u1[i] = 0.0;
-        u2[i] = 0.0;
-        u3[i] = 0.0;
-        u0n[i] = 0.0;
-        u1n[i] = 0.0;
-        u2n[i] = 0.0;
-        u3n[i] = 0.0;
-        q[i] = 0.0;
-        qn[i] = 0.0;
-        ut[i] = 0.0;
-    }
-    this->pvector = new LaVector(degreeOfFreedom, "P-Vector");
-    this->gvector = new LaVector(degreeOfFreedom, "G-Vector");
-    this->mvector = new LaVector(degreeOfFreedom, "M-Vector");
-    this->dvector = new LaVector(degreeOfFreedom, "D-Vector");
-    this->kvector = new LaVector(degreeOfFreedom, "K-Vector");
+    this->q.assign(degreeOfFreedom, 0.0);
+    this->qn.assign(degreeOfFreedom, 0.0);
+    this->ut.assign(degreeOfFreedom, 0.0);
+    this->u0.assign(degreeOfFreedom, 0.0);
+    this->u1.assign(degreeOfFreedom, 0.0);
+    this->u2.assign(degreeOfFreedom, 0.0);
+    this->u3.assign(degreeOfFreedom, 0.0);
+    this->u0n.assign(degreeOfFreedom, 0.0);
+    this->u1n.assign(degreeOfFreedom, 0.0);
+    this->u2n.assign(degreeOfFreedom, 0.0);
+    this->u3n.assign(degreeOfFreedom, 0.0);
+    this->pvector = LaVector(degreeOfFreedom, "P-Vector");
+    this->gvector = LaVector(degreeOfFreedom, "G-Vector");
+    this->mvector = LaVector(degreeOfFreedom, "M-Vector");
+    this->dvector = LaVector(degreeOfFreedom, "D-Vector");
+    this->kvector = LaVector(degreeOfFreedom, "K-Vector");
 }
 /*=====================================================*/
 void TmcInitialValue3rdOrderSolver::setDisplacement(int index, double value)
@@ -138,23 +127,36 @@ void TmcInitialValue3rdOrderSolver::setAlphaBetaGammaThetaDeltaT(double alpha, d
 void TmcInitialValue3rdOrderSolver::setFixedIndex(int index) // from 0 to ...
 {
     this->fixedIndices.push_back(index);
+    // zero damping and jerk matrices stay zero, so their products are skipped
+    const bool damped = !dmatrix->isZeroMatrix();
+    const bool jerk = !gmatrix->isZeroMatrix();
     for (int u = 0; u < this->degreeOfFreedom; u++)
     {
         kmatrix->setValue(index, u, 0.0);
-        dmatrix->setValue(index, u, 0.0);
+        if (damped)
+            dmatrix->setValue(index, u, 0.0);
         mmatrix->setValue(index, u, 0.0);
-        gmatrix->setValue(index, u, 0.0);
+        if (jerk)
+            gmatrix->setValue(index, u, 0.0);
     }
     kmatrix->setValue(index, index, 1.0);
-    dmatrix->setValue(index, index, 1.0);
+    if (damped)
+        dmatrix->setValue(index, index, 1.0);
     mmatrix->setValue(index, index, 1.0);
-    gmatrix->setValue(index, index, 1.0);
+    if (jerk)
+        gmatrix->setValue(index, index, 1.0);
+
+    // a support added during the time integration changes one row of the step matrix, a dense
+    // LU factorization is updated with the Woodbury formula, a structured one is computed again
+    for (int u = 0; u < this->degreeOfFreedom; u++)
+        xmatrix.setValue(index, u, u == index ? 1.0 : 0.0);
 }
 
 /*=====================================================*/
 
 std::vector<double *> TmcInitialValue3rdOrderSolver::getCalculatedStartSolution(LaVector *loadvector)
 {
+    TMC_TRACE_SCOPE("start solution", "solver");
     // std::cout<<"gmatrix:"<<gmatrix->getValue(0, 0)<<std::endl;
     // std::cout<<"mmatrix:"<<mmatrix->getValue(0, 0)<<std::endl;
     // std::cout<<"dmatrix:"<<dmatrix->getValue(0, 0)<<std::endl;
@@ -165,15 +167,16 @@ std::vector<double *> TmcInitialValue3rdOrderSolver::getCalculatedStartSolution(
     for (int j = 0; j < degreeOfFreedom; j++)
     {
         q[j] = loadvector->getValue(j);
-        pvector->setValue(j, loadvector->getValue(j));
+        pvector.setValue(j, loadvector->getValue(j));
     };
 
-    LaLinearEquation *equationsystem = new LaLinearEquation(kmatrix, pvector);
-    LaVector *solutionDisplacementVector = equationsystem->solve();
+    LaLinearEquation equationsystem(kmatrix, &pvector);
+    LaVector solutionDisplacementVector(degreeOfFreedom);
+    equationsystem.solve(solutionDisplacementVector);
 
     for (int j = 0; j < this->degreeOfFreedom; j++)
     {
-        u0[j] = solutionDisplacementVector->getValue(j);
+        u0[j] = solutionDisplacementVector.getValue(j);
         u1[j] = 0.0;
         u2[j] = 0.0;
         u3[j] = 0.0;
@@ -190,15 +193,23 @@ std::vector<double *> TmcInitialValue3rdOrderSolver::getCalculatedStartSolution(
 
     for (int j = 0; j < degreeOfFreedom; j++)
     {
-        this->kvector->setValue(j, u0[j]);
-        this->dvector->setValue(j, u1[j]);
-        this->mvector->setValue(j, u2[j]);
-        this->gvector->setValue(j, u3[j]);
+        this->kvector.setValue(j, u0[j]);
+        this->dvector.setValue(j, u1[j]);
+        this->mvector.setValue(j, u2[j]);
+        this->gvector.setValue(j, u3[j]);
     }
 
-    this->gvector = this->gmatrix->multiply(this->gvector);
+    const bool damped = !dmatrix->isZeroMatrix();
+    const bool jerk = !gmatrix->isZeroMatrix();
+    if (jerk)
+        this->gvector = this->gmatrix->multiply(this->gvector);
+    else
+        this->gvector.setValues(0.0);
     this->mvector = this->mmatrix->multiply(this->mvector);
-    this->dvector = this->dmatrix->multiply(this->dvector);
+    if (damped)
+        this->dvector = this->dmatrix->multiply(this->dvector);
+    else
+        this->dvector.setValues(0.0);
     this->kvector = this->kmatrix->multiply(this->kvector);
 
     double thetaDT = theta * dT;
@@ -206,13 +217,16 @@ std::vector<double *> TmcInitialValue3rdOrderSolver::getCalculatedStartSolution(
     {
         for (int j = 0; j < degreeOfFreedom; j++)
         {
-            xmatrix->setValue(i, j,
-                              (kmatrix->getValue(i, j) +
-                               (beta / (gamma * thetaDT)) * dmatrix->getValue(i, j) +
-                               (alpha / (gamma * thetaDT * thetaDT)) * mmatrix->getValue(i, j) +
-                               (1.0 / (gamma * thetaDT * thetaDT * thetaDT)) * gmatrix->getValue(i, j)));
-
-            std::cout << "xMatrix:" << i << ", " << j << " - " << xmatrix->getValue(i, j);
+            // zero terms are left out, the sum keeps the order of the full expression
+            double x = kmatrix->getValue(i, j);
+            if (damped)
+                x += (beta / (gamma * thetaDT)) * dmatrix->getValue(i, j);
+            x += (alpha / (gamma * thetaDT * thetaDT)) * mmatrix->getValue(i, j);
+            if (jerk)
+                x += (1.0 / (gamma * thetaDT * thetaDT * thetaDT)) * gmatrix->getValue(i, j);
+            xmatrix.setValue(i, j, x);
+
+            std::cout << "xMatrix:" << i << ", " << j << " - " << xmatrix.getValue(i, j);
         }
     }
     for (int a = 0; a < (int)fixedIndices.size(); a++)
@@ -220,9 +234,9 @@ std::vector<double *> TmcInitialValue3rdOrderSolver::getCalculatedStartSolution(
         int index = fixedIndices[a];
         for (int u = 0; u < this->degreeOfFreedom; u++)
         {
-            xmatrix->setValue(index, u, 0.0);
+            xmatrix.setValue(index, u, 0.0);
         }
-        xmatrix->setValue(index, index, 1.0);
+        xmatrix.setValue(index, index, 1.0);
     }
 
     // compute acceleration
@@ -232,23 +246,23 @@ std::vector<double *> TmcInitialValue3rdOrderSolver::getCalculatedStartSolution(
     {
         for (int j = 0; j < degreeOfFreedom; j++)
         {
-            // pvector->setValue(j, -loadvector->getValue(j)-kvector->getValue(j) -dvector->getValue(j));
-            pvector->setValue(j, kvector->getValue(j));
+            // pvector.setValue(j, -loadvector->getValue(j)-kvector.getValue(j) -dvector.getValue(j));
+            pvector.setValue(j, kvector.getValue(j));
         }
-        equationsystem->setMatrix(mmatrix);
-        equationsystem->setVector(pvector);
-        LaVector *solutionAccelerationVector = equationsystem->solve();
+        equationsystem.setMatrix(mmatrix);
+        equationsystem.setVector(&pvector);
+        LaVector solutionAccelerationVector(degreeOfFreedom);
+        equationsystem.solve(solutionAccelerationVector);
         std::cout << "##############################################" << std::endl;
-        std::cout << "pvector:" << pvector->getValue(0) << std::endl;
+        std::cout << "pvector:" << pvector.getValue(0) << std::endl;
         std::cout << "mmatrix:" << mmatrix->getValue(0, 0) << std::endl;
-        std::cout << "acceleration:" << solutionAccelerationVector->getValue(0) << std::endl;
+        std::cout << "acceleration:" << solutionAccelerationVector.getValue(0) << std::endl;
         std::cout << "##############################################" << std::endl;
         for (int j = 0; j < degreeOfFreedom; j++)
         {
-            u2[j] = solutionAccelerationVector->getValue(j);
-            this->mvector->setValue(j, u2[j]);
+            u2[j] = solutionAccelerationVector.getValue(j);
+            this->mvector.setValue(j, u2[j]);
         }
-        delete solutionAccelerationVector;
         this->mvector = this->mmatrix->multiply(this->mvector);
 
         for (int j = 0; j < this->degreeOfFreedom; j++)
@@ -263,108 +277,79 @@ std::vector<double *> TmcInitialValue3rdOrderSolver::getCalculatedStartSolution(
     {
         for (int j = 0; j < degreeOfFreedom; j++)
         {
-            pvector->setValue(j, -loadvector->getValue(j) - dvector->getValue(j) - mvector->getValue(j) - gvector->getValue(j));
+            pvector.setValue(j, -loadvector->getValue(j) - dvector.getValue(j) - mvector.getValue(j) - gvector.getValue(j));
         }
         if (debug)
             std::cout << "gmatrix:" << gmatrix->toString() << std::endl;
         if (debug)
-            std::cout << "pvector:" << pvector->toString() << std::endl;
-        equationsystem->setMatrix(gmatrix);
-        equationsystem->setVector(pvector);
+            std::cout << "pvector:" << pvector.toString() << std::endl;
+        equationsystem.setMatrix(gmatrix);
+        equationsystem.setVector(&pvector);
 
-        LaVector *solutionJerkVector = equationsystem->solve();
+        LaVector solutionJerkVector(degreeOfFreedom);
+        equationsystem.solve(solutionJerkVector);
         for (int j = 0; j < degreeOfFreedom; j++)
         {
-            u3[j] = solutionJerkVector->getValue(j);
-            this->gvector->setValue(j, u3[j]);
+            u3[j] = solutionJerkVector.getValue(j);
+            this->gvector.setValue(j, u3[j]);
         }
-        delete solutionJerkVector;
     }
 
-    delete equationsystem;
-
     for (int j = 0; j < this->degreeOfFreedom; j++)
     {
         std::cout << "with jerk Time 0 - u:" << u0[j] << ", v:" << u1[j] << ", a:" << u2[j] << ", j:" << u3[j] << " ,p:" << q[j] << std::endl;
     }
 
     std::vector<double *> result;
-    result.push_back(u0);
-    result.push_back(u1);
-    result.push_back(u2);
-    result.push_back(u3);
+    result.push_back(u0.data());
+    result.push_back(u1.data());
+    result.push_back(u2.data());
+    result.push_back(u3.data());
+
+    this->time = 0.0;
+    this->evaluateProbes();
     return result;
 }
 
 /*=====================================================*/
 std::vector<double *> TmcInitialValue3rdOrderSolver::getCalculatedNextTimeStepSolution(LaVector *loadvector, bool okForNextTimeStep)
 {
+    TMC_TRACE_SCOPE("time step", "solver");
 
     for (int j = 0; j < degreeOfFreedom; j++)
         qn[j] = loadvector->getValue(j);
 
-    double thetaDT = theta * dT;
-    for (int j = 0; j < degreeOfFreedom; j++)
-    {
-
-        pvector->setValue(j, (q[j] * (1. - theta) + qn[j] * theta));
-
-        gvector->setValue(j, ((1.0 - 1.0 / (6.0 * gamma)) * u3[j] -
-                              (1.0 / (2.0 * gamma * thetaDT)) * u2[j] -
-                              (1.0 / (gamma * thetaDT * thetaDT)) * u1[j] -
-                              (1.0 / (gamma * thetaDT * thetaDT * thetaDT)) * u0[j]));
-
-        mvector->setValue(j, ((1.0 - alpha / (6.0 * gamma)) * thetaDT * u3[j] +
-                              (1. - alpha / (2.0 * gamma)) * u2[j] -
-                              (alpha / (gamma * thetaDT)) * u1[j] -
-                              (alpha / (gamma * thetaDT * thetaDT)) * u0[j]));
-
-        dvector->setValue(j, (((0.5 - beta / (6. * gamma)) * thetaDT * thetaDT) * u3[j] +
-                              ((1.0 - beta / (2.0 * gamma)) * thetaDT) * u2[j] +
-                              (1.0 - beta / gamma) * u1[j] -
-                              beta / (gamma * thetaDT) * u0[j]));
-    }
-
-    LaVector *dummy3 = gmatrix->multiply(gvector);
-    for (int j = 0; j < degreeOfFreedom; j++)
-        gvector->setValue(j, dummy3->getValue(j));
-    delete dummy3;
-
-    LaVector *dummy2 = mmatrix->multiply(mvector);
-    for (int j = 0; j < degreeOfFreedom; j++)
-        mvector->setValue(j, dummy2->getValue(j));
-    delete dummy2;
-
-    LaVector *dummy1 = dmatrix->multiply(dvector);
-    for (int j = 0; j < degreeOfFreedom; j++)
-        dvector->setValue(j, dummy1->getValue(j));
-    delete dummy1;
-
-    for (int j = 0; j < degreeOfFreedom; j++)
-    {
-        pvector->setValue(j, pvector->getValue(j) - dvector->getValue(j) - mvector->getValue(j) - gvector->getValue(j));
-    }
+    /* right vector, one pass: p = (1-theta) q + theta qn - G g - M m - D d    */
+    const double thetaDT = theta * dT;
+    laAssign(pvector, (1. - theta) * laVector(q) + theta * laVector(qn) -
+                          (*gmatrix) * ((1.0 - 1.0 / (6.0 * gamma)) * laVector(u3) -
+                                        (1.0 / (2.0 * gamma * thetaDT)) * laVector(u2) -
+                                        (1.0 / (gamma * thetaDT * thetaDT)) * laVector(u1) -
+                                        (1.0 / (gamma * thetaDT * thetaDT * thetaDT)) * laVector(u0)) -
+                          (*mmatrix) * ((1.0 - alpha / (6.0 * gamma)) * thetaDT * laVector(u3) +
+                                        (1. - alpha / (2.0 * gamma)) * laVector(u2) -
+                                        (alpha / (gamma * thetaDT)) * laVector(u1) -
+                                        (alpha / (gamma * thetaDT * thetaDT)) * laVector(u0)) -
+                          (*dmatrix) * (((0.5 - beta / (6. * gamma)) * thetaDT * thetaDT) * laVector(u3) +
+                                        ((1.0 - beta / (2.0 * gamma)) * thetaDT) * laVector(u2) +
+                                        (1.0 - beta / gamma) * laVector(u1) -
+                                        beta / (gamma * thetaDT) * laVector(u0)));
     /* boundary condition */
     for (int u = 0; u < (int)fixedIndices.size(); u++)
     {
-        pvector->setValue(fixedIndices[u], 0.);
+        pvector.setValue(fixedIndices[u], 0.);
     }
 
-    // std::cout<<"xMatrix:"<<xmatrix->getValue(0,0)<<std::endl;
-    // std::cout<<"pVector:"<<pvector->getValue(0)<<std::endl;
-    // std::cout<<"gVector:"<<gvector->getValue(0)<<std::endl;
-    // std::cout<<"mVector:"<<mvector->getValue(0)<<std::endl;
-    // std::cout<<"dVector:"<<dvector->getValue(0)<<std::endl;
+    // std::cout<<"xMatrix:"<<xmatrix.getValue(0,0)<<std::endl;
+    // std::cout<<"pVector:"<<pvector.getValue(0)<<std::endl;
+    // std::cout<<"gVector:"<<gvector.getValue(0)<<std::endl;
+    // std::cout<<"mVector:"<<mvector.getValue(0)<<std::endl;
+    // std::cout<<"dVector:"<<dvector.getValue(0)<<std::endl;
     /* solution                                                                */
-    LaLinearEquation *system = new LaLinearEquation(xmatrix, pvector);
-    LaVector *dummy = system->solve();
+    LaLinearEquation system(&xmatrix, &pvector);
+    system.solve(pvector);
     for (int j = 0; j < degreeOfFreedom; j++)
-    {
-        ut[j] = dummy->getValue(j);
-        pvector->setValue(j, ut[j]);
-    }
-    delete dummy;
-    delete system;
+        ut[j] = pvector.getValue(j);
 
     /* new state variables                                                     */
     for (int j = 0; j < degreeOfFreedom; j++)
@@ -387,13 +372,34 @@ std::vector<double *> TmcInitialValue3rdOrderSolver::getCalculatedNextTimeStepSo
         }
     }
     std::vector<double *> result;
-    result.push_back(u0);
-    result.push_back(u1);
-    result.push_back(u2);
-    result.push_back(u3);
+    result.push_back(u0.data());
+    result.push_back(u1.data());
+    result.push_back(u2.data());
+    result.push_back(u3.data());
+
+    if (okForNextTimeStep)
+    {
+        this->time += this->dT;
+        this->evaluateProbes();
+    }
     return result;
 }
 /*=====================================================*/
+void TmcInitialValue3rdOrderSolver::evaluateProbes()
+{
+    if (this->probes.empty())
+        return;
+    // the views are set again, the state vectors may have been resized
+    std::vector<LaConstVectorView> &state = this->probeState;
+    if (state.size() != 4)
+        state.assign(4, this->getDisplacement());
+    state[0] = this->getDisplacement();
+    state[1] = this->getVelocity();
+    state[2] = this->getAcceleration();
+    state[3] = this->getJerk();
+    this->probes.evaluate(this->time, state);
+}
+/*=====================================================*/
 void TmcInitialValue3rdOrderSolver::read(TmcFileInput *input)
 {
     // cout<<input->readString()<<endl;
@@ -414,13 +420,13 @@ void TmcInitialValue3rdOrderSolver::read(TmcFileInput *input)
 
     // input->readLine();
     // this->mvector = new LaVector();
-    // mvector->read(input);   input->readLine();
+    // mvector.read(input);   input->readLine();
     // this->dvector = new LaVector();
-    // dvector->read(input);   input->readLine();
+    // dvector.read(input);   input->readLine();
     // this->kvector = new LaVector();
-    // kvector->read(input);   input->readLine();
+    // kvector.read(input);   input->readLine();
     // this->pvector = new LaVector();
-    // pvector->read(input);    input->readLine();
+    // pvector.read(input);    input->readLine();
     // this->amatrix = new LaSquareMatrix();
     // amatrix->read(input);    input->readLine();
     // this->mmatrix = new LaSquareMatrix();
@@ -453,10 +459,10 @@ void TmcInitialValue3rdOrderSolver::write(TmcFileOutput *output)
     // output->writeDouble(this->theta);
     // output->writeDouble(this->linienlast);
     // output->writeLine();
-    // this->mvector->write(output);
-    // this->dvector->write(output);
-    // this->kvector->write(output);
-    // this->pvector->write(output);
+    // this->mvector.write(output);
+    // this->dvector.write(output);
+    // this->kvector.write(output);
+    // this->pvector.write(output);
     // this->amatrix->write(output);
     // this->mmatrix->write(output);
     // this->dmatrix->write(output);
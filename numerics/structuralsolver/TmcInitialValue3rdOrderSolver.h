@@ -47,9 +47,11 @@
 
 #include <TmcMacroFile.h>
 
-class LaLinearEquation;
-class LaSquareMatrix;
-class LaVector;
+#include <numerics/algebra/LaSquareMatrix.h>
+#include <numerics/algebra/LaVector.h>
+
+#include "./TmcProbe.h"
+
 class TmcFileInput;
 class TmcFileOutput;
 
@@ -70,8 +72,20 @@ public:
     std::vector<double *> getCalculatedStartSolution(LaVector *lastvector);
     std::vector<double *> getCalculatedNextTimeStepSolution(LaVector *lastvector, bool okForNextTimeStep);
 
+    /** views on the state of the last solution, valid until the solver is destroyed */
+    LaConstVectorView getDisplacement() const { return LaConstVectorView(this->u0.data(), (int)this->u0.size()); }
+    LaConstVectorView getVelocity() const { return LaConstVectorView(this->u1.data(), (int)this->u1.size()); }
+    LaConstVectorView getAcceleration() const { return LaConstVectorView(this->u2.data(), (int)this->u2.size()); }
+    LaConstVectorView getJerk() const { return LaConstVectorView(this->u3.data(), (int)this->u3.size()); }
+
     int getDegreeOfFreedom() { return this->degreeOfFreedom; }
     double getDeltaT() { return this->dT; }
+    double getTime() { return this->time; }
+
+    /** the probes are evaluated after the start solution and after every accepted time step */
+    int addProbe(const TmcProbe &probe) { return this->probes.add(probe, this->degreeOfFreedom, 4); }
+    TmcProbe &getProbe(int index) { return this->probes.get(index); }
+    TmcProbeSet &getProbes() { return this->probes; }
 
     void setAlphaBetaGammaThetaDeltaT(double alpha, double beta, double gamma, double theta, double deltaT);
 
@@ -83,24 +97,29 @@ public:
     LaSquareMatrix *getMMatrix() { return this->mmatrix; }
 
 private:
+    void evaluateProbes();
+
     std::vector<int> fixedIndices;
     LaSquareMatrix *kmatrix;
     LaSquareMatrix *dmatrix;
     LaSquareMatrix *mmatrix;
     LaSquareMatrix *gmatrix;
-    LaSquareMatrix *xmatrix;
-    double *u0, *u0n;
-    double *u1, *u1n;
-    double *u2, *u2n;
-    double *u3, *u3n;
-    double *ut;
-    double *q, *qn;
-    LaVector *pvector;
-    LaVector *gvector;
-    LaVector *mvector;
-    LaVector *dvector;
-    LaVector *kvector;
+    LaSquareMatrix xmatrix;
+    std::vector<double> u0, u0n;
+    std::vector<double> u1, u1n;
+    std::vector<double> u2, u2n;
+    std::vector<double> u3, u3n;
+    std::vector<double> ut;
+    std::vector<double> q, qn;
+    LaVector pvector;
+    LaVector gvector;
+    LaVector mvector;
+    LaVector dvector;
+    LaVector kvector;
     double dT;
+    double time;
+    TmcProbeSet probes;
+    std::vector<LaConstVectorView> probeState; //< views on the state, reused by evaluateProbes()
     double theta;
     double alpha;
     double beta;
@@ -43,9 +43,16 @@
 #include <numerics/algebra/LaLinearEquation.h>
 #include <numerics/algebra/LaSquareMatrix.h>
 #include <numerics/algebra/LaVector.h>
+#include <numerics/algebra/LaVectorExpression.h>
+#include <numerics/structuralsolver/TmcThetaMethod.h>
 
+#include <common/utilities/TmcException.h>
 #include <common/utilities/TmcFileInput.h>
 #include <common/utilities/TmcFileOutput.h>
+#include <common/utilities/TmcSystem.h>
+#include <common/utilities/TmcTrace.h>
+
+#include <algorithm>
 
 /*============================================================*/
 TmcInitialValueSolver::TmcInitialValueSolver(int degreeOfFreedom, LaSquareMatrix *kMatrix, LaSquareMatrix *mMatrix, LaSquareMatrix *dMatrix, double deltaT)
@@ -53,55 +60,94 @@ TmcInitialValueSolver::TmcInitialValueSolver(int degreeOfFreedom, LaSquareMatrix
     this->init(degreeOfFreedom, kMatrix, mMatrix, dMatrix, deltaT);
 }
 /*============================================================*/
+TmcInitialValueSolver::TmcInitialValueSolver(int degreeOfFreedom, LaSquareMatrix *kMatrix, LaSquareMatrix *mMatrix, const TmcRayleighDamping &damping, double deltaT)
+{
+    this->init(degreeOfFreedom, kMatrix, mMatrix, (LaSquareMatrix *)NULL, deltaT);
+    this->setRayleighDamping(damping);
+}
+/*============================================================*/
+TmcInitialValueSolver::TmcInitialValueSolver(int degreeOfFreedom, const LaLinearOperator *kOperator, const LaLinearOperator *mOperator, const LaLinearOperator *dOperator, double deltaT)
+{
+    this->init(degreeOfFreedom, kOperator, mOperator, dOperator, deltaT);
+}
+/*============================================================*/
+TmcInitialValueSolver::TmcInitialValueSolver(int degreeOfFreedom, const LaLinearOperator *kOperator, const LaLinearOperator *mOperator, const TmcRayleighDamping &damping, double deltaT)
+{
+    this->init(degreeOfFreedom, kOperator, mOperator, (const LaLinearOperator *)NULL, deltaT);
+    this->setRayleighDamping(damping);
+}
+/*============================================================*/
 void TmcInitialValueSolver::init(int degreeOfFreedom, LaSquareMatrix *kMatrix, LaSquareMatrix *mMatrix, LaSquareMatrix *dMatrix, double deltaT)
 {
-    this->dT = deltaT;
-
-    this->degreeOfFreedom = degreeOfFreedom;
-
     this->kmatrix = kMatrix;
     this->mmatrix = mMatrix;
     this->dmatrix = dMatrix;
+    this->koperator = NULL;
+    this->moperator = NULL;
+    this->doperator = NULL;
+    this->initState(degreeOfFreedom, deltaT);
+}
+/*============================================================*/
+void TmcInitialValueSolver::init(int degreeOfFreedom, const LaLinearOperator *kOperator, const LaLinearOperator *mOperator, const LaLinearOperator *dOperator, double deltaT)
+{
+    if (kOperator->getDimension() != degreeOfFreedom || mOperator->getDimension() != degreeOfFreedom || (dOperator && dOperator->getDimension() != degreeOfFreedom))
+        throw TmcException(UB_EXARGS, "TmcInitialValueSolver - the dimension of the operators does not fit");
+    this->kmatrix = NULL;
+    this->mmatrix = NULL;
+    this->dmatrix = NULL;
+    this->koperator = kOperator;
+    this->moperator = mOperator;
+    this->doperator = dOperator;
+    this->initState(degreeOfFreedom, deltaT);
+
+    this->cg.setTolerance(1e-10);
+    // the static start solution of slender structures is badly conditioned
+    this->cg.setMaxIterations(50 * degreeOfFreedom);
+    this->mwork.assign(degreeOfFreedom, 0.0);
+    this->dwork.assign(degreeOfFreedom, 0.0);
+    this->rhs.assign(degreeOfFreedom, 0.0);
+}
+/*============================================================*/
+void TmcInitialValueSolver::initState(int degreeOfFreedom, double deltaT)
+{
+    this->dT = deltaT;
+    this->time = 0.0;
+
+    this->degreeOfFreedom = degreeOfFreedom;
+    this->aoperator = LaOperatorSum();
+    this->stepMatrices.clear();
+    this->stepMatrixCacheSize = 0;
+    this->stepMatrixAssemblies = 0;
+    this->stepMatrixCached = true;
+    this->rayleigh = false;
+    this->damping = TmcRayleighDamping();
 
     // Newmark
     this->theta = 1.0; // 1.37;		//Wilson
     this->alpha = 0.5; // 0.5;
     this->beta = 0.25; // 1.0/6.0;
+    this->alphaM = 0.0;
+    this->alphaF = 0.0;
 
     // Wilson
     // this->theta = 1.37;
     // this->alpha = 0.5;
     // this->beta  = 1.0/6.0;
 
-    u = new double[degreeOfFreedom];
-    p = new double[degreeOfFreedom];
-    q = new double[degreeOfFreedom];
-    qn = new double[degreeOfFreedom];
-    ut = new double[degreeOfFreedom];
-    u0 = new double[degreeOfFreedom];
-    u1 = new double[degreeOfFreedom];
-    u2 = new double[degreeOfFreedom];
-    u0n = new double[degreeOfFreedom];
-    u1n = new double[degreeOfFreedom];
-    u2n = new double[degreeOfFreedom];
-    for (int i = 0; i < degreeOfFreedom; i++)
-    {
-        u[i] = 0.0;
-        p[i] = 0.0;
-        ut[i] = 0.0;
-        u0[i] = 0.0;
-        u1[i] = 0.0;
-        u2[i] = 0.0;
-        u0n[i] = 0.0;
-        u1n[i] = 0.0;
-        u2n[i] = 0.0;
-    }
+    this->u0.assign(degreeOfFreedom, 0.0);
+    this->u1.assign(degreeOfFreedom, 0.0);
+    this->u2.assign(degreeOfFreedom, 0.0);
+    this->u0n.assign(degreeOfFreedom, 0.0);
+    this->u1n.assign(degreeOfFreedom, 0.0);
+    this->u2n.assign(degreeOfFreedom, 0.0);
+    this->ut.assign(degreeOfFreedom, 0.0);
+    this->q.assign(degreeOfFreedom, 0.0);
+    this->qn.assign(degreeOfFreedom, 0.0);
     /* vector                                                                  */
-    this->hvector = new LaVector(degreeOfFreedom, "H-Vector");
-    this->pvector = new LaVector(degreeOfFreedom, "P-Vector");
-    this->kvector = new LaVector(degreeOfFreedom, "K-Vector");
-    this->mvector = new LaVector(degreeOfFreedom, "M-Vector");
-    this->dvector = new LaVector(degreeOfFreedom, "D-Vector");
+    this->hvector = LaVector(degreeOfFreedom);
+    this->hvector.setName("H-Vector");
+    this->pvector = LaVector(degreeOfFreedom);
+    this->pvector.setName("P-Vector");
 }
 /*=====================================================*/
 void TmcInitialValueSolver::setDisplacement(int index, double value)
@@ -117,167 +163,418 @@ void TmcInitialValueSolver::setAlphaBetaThetaDeltaT(double alpha, double beta, d
     this->theta = theta;
     this->alpha = alpha;
     this->beta = beta;
+    this->alphaM = 0.0;
+    this->alphaF = 0.0;
     this->dT = deltaT;
+    this->clearStepMatrixCache();
+
+    // during the time integration the step matrix follows the new coefficients
+    if (this->amatrix.getRowNumber() == this->degreeOfFreedom || this->aoperator.getDimension() == this->degreeOfFreedom)
+        this->assembleStepMatrix();
 }
 /*=====================================================*/
-void TmcInitialValueSolver::setFixedIndex(int index)
+void TmcInitialValueSolver::setGeneralizedAlphaDeltaT(double alphaM, double alphaF, double alpha, double beta, double deltaT)
 {
-    this->fixedIndices.push_back(index);
-    for (int u = 0; u < this->degreeOfFreedom; u++)
-    {
-        kmatrix->setValue(index, u, 0.0);
-        dmatrix->setValue(index, u, 0.0);
-        mmatrix->setValue(index, u, 0.0);
-    }
-    kmatrix->setValue(index, index, 1.0);
-    dmatrix->setValue(index, index, 1.0);
-    mmatrix->setValue(index, index, 1.0);
+    if (alphaF >= 1.0 || alphaM >= 1.0)
+        throw TmcException(UB_EXARGS, "TmcInitialValueSolver - alphaM and alphaF must be below 1");
+
+    this->theta = 1.0;
+    this->alpha = alpha;
+    this->beta = beta;
+    this->alphaM = alphaM;
+    this->alphaF = alphaF;
+    this->dT = deltaT;
+    this->clearStepMatrixCache();
+
+    if (this->amatrix.getRowNumber() == this->degreeOfFreedom || this->aoperator.getDimension() == this->degreeOfFreedom)
+        this->assembleStepMatrix();
 }
+/*=====================================================*/
+// Chung, Hulbert: alphaM = (2 rho - 1)/(rho + 1), alphaF = rho/(rho + 1),
+// alpha = 1/2 - alphaM + alphaF, beta = (1 - alphaM + alphaF)^2 / 4
+void TmcInitialValueSolver::setSpectralRadiusDeltaT(double spectralRadius, double deltaT)
+{
+    if (spectralRadius < 0.0 || spectralRadius > 1.0)
+        throw TmcException(UB_EXARGS, "TmcInitialValueSolver - spectral radius " + TmcSystem::toString(spectralRadius) + " not in [0,1]");
 
+    const double alphaM = (2.0 * spectralRadius - 1.0) / (spectralRadius + 1.0);
+    const double alphaF = spectralRadius / (spectralRadius + 1.0);
+    const double shift = 1.0 - alphaM + alphaF;
+    this->setGeneralizedAlphaDeltaT(alphaM, alphaF, 0.5 - alphaM + alphaF, 0.25 * shift * shift, deltaT);
+}
 /*=====================================================*/
-std::vector<double *> TmcInitialValueSolver::getCalculatedStartSolution(LaVector *lastvector)
+// Hilber, Hughes, Taylor: alpha = 1/2 + alphaF, beta = (1 + alphaF)^2 / 4
+void TmcInitialValueSolver::setHHTAlphaDeltaT(double alphaF, double deltaT)
 {
-    // create equation system and solve
-    // k*u = f
-    LaLinearEquation *equationsystem = new LaLinearEquation(kmatrix, lastvector);
-    LaVector *lhvector = equationsystem->solve();
+    if (alphaF < 0.0 || alphaF > 1.0 / 3.0)
+        throw TmcException(UB_EXARGS, "TmcInitialValueSolver - HHT alpha " + TmcSystem::toString(alphaF) + " not in [0,1/3]");
 
-    for (int j = 0; j < this->degreeOfFreedom; j++)
+    this->setGeneralizedAlphaDeltaT(0.0, alphaF, 0.5 + alphaF, 0.25 * (1.0 + alphaF) * (1.0 + alphaF), deltaT);
+}
+/*=====================================================*/
+void TmcInitialValueSolver::setRayleighDamping(const TmcRayleighDamping &damping)
+{
+    this->rayleigh = true;
+    this->damping = damping;
+    this->clearStepMatrixCache();
+    if (this->amatrix.getRowNumber() == this->degreeOfFreedom || this->aoperator.getDimension() == this->degreeOfFreedom)
+        this->assembleStepMatrix();
+}
+/*=====================================================*/
+void TmcInitialValueSolver::setDeltaT(double deltaT, bool cached)
+{
+    if (deltaT == this->dT)
     {
-        u0[j] = lhvector->getValue(j);
-        u1[j] = 0.;
+        this->stepMatrixCached = this->stepMatrixCached || cached;
+        return;
     }
-    for (int j = 0; j < degreeOfFreedom; j++)
-        q[j] = lhvector->getValue(j);
-
-    for (int j = 0; j < degreeOfFreedom; j++)
+    if (this->amatrix.getRowNumber() != this->degreeOfFreedom)
     {
-        kvector->setValue(j, u0[j]);
-        dvector->setValue(j, u1[j]);
+        // matrix-free or not started: nothing is factorized
+        this->dT = deltaT;
+        this->stepMatrixCached = cached;
+        if (this->aoperator.getDimension() == this->degreeOfFreedom)
+            this->assembleStepMatrix();
+        return;
     }
-    dvector = dmatrix->multiply(dvector);
-    kvector = kmatrix->multiply(kvector);
-    for (int j = 0; j < degreeOfFreedom; j++)
+    if (this->stepMatrixCacheSize > 0)
     {
-        lhvector->setValue(j, -kvector->getValue(j) - dvector->getValue(j));
+        // a matrix which isn't cached is overwritten
+        if (this->stepMatrixCached)
+        {
+            this->stepMatrices.push_front(std::make_pair(this->dT, LaSquareMatrix()));
+            this->stepMatrices.front().second.swap(this->amatrix);
+        }
+        this->dT = deltaT;
+        for (std::list<std::pair<double, LaSquareMatrix>>::iterator it = this->stepMatrices.begin(); it != this->stepMatrices.end(); ++it)
+        {
+            if (it->first == deltaT)
+            {
+                this->amatrix.swap(it->second);
+                this->stepMatrices.erase(it);
+                this->stepMatrixCached = true;
+                return;
+            }
+        }
+        // the least recently used matrices are dropped, a step width which isn't cached keeps them
+        while (cached && (int)this->stepMatrices.size() > this->stepMatrixCacheSize)
+        {
+            if (this->amatrix.getRowNumber() != this->degreeOfFreedom)
+                this->amatrix.swap(this->stepMatrices.back().second);
+            this->stepMatrices.pop_back();
+        }
+    }
+    this->dT = deltaT;
+    this->stepMatrixCached = cached;
+    this->assembleStepMatrix();
+}
+/*=====================================================*/
+void TmcInitialValueSolver::setStepMatrixCacheSize(int size)
+{
+    this->stepMatrixCacheSize = size;
+    while ((int)this->stepMatrices.size() > size)
+        this->stepMatrices.pop_back();
+}
+/*=====================================================*/
+// A = K + alpha/(beta theta dT) D + 1/(beta (theta dT)^2) M
+// with Rayleigh damping A = (1 + b dFactor) K + (mFactor + a dFactor) M
+// generalized alpha: the equation is divided by 1 - alphaF, the mass factor gets (1 - alphaM)/(1 - alphaF)
+// rows and columns of the fixed unknowns are those of the identity, the prescribed displacements
+// are zero, so A keeps the symmetry of K, D and M. The matrix is overwritten in place, a sparse
+// factorization keeps its symbolic analysis and only repeats the numeric part
+void TmcInitialValueSolver::assembleStepMatrix()
+{
+    TMC_TRACE_SCOPE("step matrix", "solver");
+    this->stepMatrixAssemblies++;
+    const TmcThetaMethod method(alpha, beta, theta, alphaM, alphaF, dT);
+    const double dFactor = method.dFactor;
+    const double mFactor = method.mFactor;
+    if (this->isMatrixFree())
+    {
+        // only the factors of the sum change, nothing is assembled
+        this->aoperator = LaOperatorSum(this->degreeOfFreedom);
+        if (this->rayleigh)
+        {
+            this->aoperator.add(1.0 + dFactor * this->damping.getStiffnessFactor(), this->koperator);
+            this->aoperator.add(mFactor + dFactor * this->damping.getMassFactor(), this->moperator);
+        }
+        else
+        {
+            this->aoperator.add(1.0, this->koperator);
+            if (this->doperator)
+                this->aoperator.add(dFactor, this->doperator);
+            this->aoperator.add(mFactor, this->moperator);
+        }
+        this->aoperator.setFixed(this->fixedIndices);
+        return;
     }
 
-    equationsystem->setMatrix(mmatrix);
-    equationsystem->setVector(lhvector);
-    hvector = equationsystem->solve();
-    delete lhvector;
-    for (int j = 0; j < degreeOfFreedom; j++)
-        u2[j] = hvector->getValue(j);
+    if (this->amatrix.getRowNumber() != this->degreeOfFreedom)
+        this->amatrix = LaSquareMatrix(this->degreeOfFreedom, "A-Matrix");
 
-    this->amatrix = new LaSquareMatrix(this->degreeOfFreedom);
+    std::vector<bool> fixed(this->degreeOfFreedom, false);
+    for (int a = 0; a < (int)fixedIndices.size(); a++)
+        fixed[fixedIndices[a]] = true;
+
+    const bool damped = !this->rayleigh && dmatrix && !dmatrix->isZeroMatrix();
+    const double kFactor = this->rayleigh ? 1.0 + dFactor * this->damping.getStiffnessFactor() : 1.0;
+    const double kmFactor = this->rayleigh ? mFactor + dFactor * this->damping.getMassFactor() : mFactor;
     for (int i = 0; i < degreeOfFreedom; i++)
     {
         for (int j = 0; j < degreeOfFreedom; j++)
         {
-            amatrix->setValue(i, j,
-                              kmatrix->getValue(i, j) +
-                                  alpha / (beta * theta * dT) * dmatrix->getValue(i, j) +
-                                  1. / (beta * (theta * dT) * (theta * dT)) * mmatrix->getValue(i, j));
+            if (fixed[i] || fixed[j])
+                amatrix.setValue(i, j, i == j ? 1.0 : 0.0);
+            else if (this->rayleigh)
+                amatrix.setValue(i, j, kFactor * kmatrix->getValue(i, j) + kmFactor * mmatrix->getValue(i, j));
+            else if (damped)
+                amatrix.setValue(i, j, kmatrix->getValue(i, j) + dFactor * dmatrix->getValue(i, j) + mFactor * mmatrix->getValue(i, j));
+            else
+                amatrix.setValue(i, j, kmatrix->getValue(i, j) + mFactor * mmatrix->getValue(i, j));
         }
     }
+}
+/*=====================================================*/
+void TmcInitialValueSolver::setFixedIndex(int index)
+{
+    this->fixedIndices.push_back(index);
+    this->clearStepMatrixCache();
+    if (this->isMatrixFree())
+    {
+        // the operators stay untouched, the fixed unknowns are eliminated in the systems
+        if (this->aoperator.getDimension() == this->degreeOfFreedom)
+            this->aoperator.setFixed(this->fixedIndices);
+        return;
+    }
+    // a zero damping matrix stays zero, so its products are skipped, the rows of the
+    // fixed unknowns are replaced by the boundary condition anyway
+    const bool damped = dmatrix && !dmatrix->isZeroMatrix();
+    for (int u = 0; u < this->degreeOfFreedom; u++)
+    {
+        kmatrix->setValue(index, u, 0.0);
+        if (damped)
+            dmatrix->setValue(index, u, 0.0);
+        mmatrix->setValue(index, u, 0.0);
+    }
+    kmatrix->setValue(index, index, 1.0);
+    if (damped)
+        dmatrix->setValue(index, index, 1.0);
+    mmatrix->setValue(index, index, 1.0);
 
-    for (int a = 0; a < (int)fixedIndices.size(); a++)
+    // a support added during the time integration replaces the row and the column of the
+    // step matrix like assembleStepMatrix(), so it stays symmetric and keeps its structured
+    // solver, the right hand side of a fixed unknown is zero; the next solve factorizes again
+    if (this->amatrix.getRowNumber() == this->degreeOfFreedom)
     {
-        int index = fixedIndices[a];
         for (int u = 0; u < this->degreeOfFreedom; u++)
         {
-            amatrix->setValue(index, u, 0.0);
+            amatrix.setValue(index, u, u == index ? 1.0 : 0.0);
+            amatrix.setValue(u, index, u == index ? 1.0 : 0.0);
+        }
+    }
+}
+
+/*=====================================================*/
+std::vector<double *> TmcInitialValueSolver::getCalculatedStartSolution(LaVector *lastvector)
+{
+    TMC_TRACE_SCOPE("start solution", "solver");
+    if (this->isMatrixFree())
+    {
+        // k*u = f, the prescribed displacements of the fixed unknowns are f
+        LaOperatorSum ksystem(this->degreeOfFreedom);
+        ksystem.add(1.0, this->koperator);
+        ksystem.setFixed(this->fixedIndices);
+        ksystem.eliminate(lastvector->data(), this->rhs.data());
+        this->solveIterative(ksystem, this->rhs.data(), this->u0.data());
+        std::fill(this->u1.begin(), this->u1.end(), 0.0);
+        for (int j = 0; j < degreeOfFreedom; j++)
+            q[j] = lastvector->getValue(j);
+
+        // m*a = -k*u - d*v, the supports don't accelerate
+        this->koperator->apply(this->u0.data(), this->rhs.data());
+        for (int j = 0; j < degreeOfFreedom; j++)
+            this->rhs[j] = -this->rhs[j];
+        for (int a = 0; a < (int)fixedIndices.size(); a++)
+            this->rhs[fixedIndices[a]] = 0.0;
+        LaOperatorSum msystem(this->degreeOfFreedom);
+        msystem.add(1.0, this->moperator);
+        msystem.setFixed(this->fixedIndices);
+        std::fill(this->u2.begin(), this->u2.end(), 0.0);
+        this->solveIterative(msystem, this->rhs.data(), this->u2.data());
+    }
+    else
+    {
+        // create equation system and solve
+        // k*u = f
+        LaLinearEquation displacementsystem(kmatrix, lastvector);
+        displacementsystem.solve(this->hvector);
+
+        for (int j = 0; j < this->degreeOfFreedom; j++)
+        {
+            u0[j] = hvector.getValue(j);
+            u1[j] = 0.;
         }
-        amatrix->setValue(index, index, 1.0);
+        for (int j = 0; j < degreeOfFreedom; j++)
+            q[j] = lastvector->getValue(j);
+
+        // m*a = -k*u - d*v
+        // the start velocity is zero, so Rayleigh damping doesn't contribute
+        if (this->rayleigh || !dmatrix)
+            laAssign(this->pvector, -((*kmatrix) * laVector(u0)));
+        else
+            laAssign(this->pvector, -((*kmatrix) * laVector(u0)) - (*dmatrix) * laVector(u1));
+        LaLinearEquation accelerationsystem(mmatrix, &this->pvector);
+        accelerationsystem.solve(this->hvector);
+        for (int j = 0; j < degreeOfFreedom; j++)
+            u2[j] = hvector.getValue(j);
     }
 
-    delete equationsystem;
+    this->assembleStepMatrix();
 
     std::vector<double *> result;
-    result.push_back(u0);
-    result.push_back(u1);
-    result.push_back(u2);
+    result.push_back(u0.data());
+    result.push_back(u1.data());
+    result.push_back(u2.data());
+
+    this->time = 0.0;
+    this->evaluateProbes();
     return result;
 }
 
 /*=====================================================*/
 std::vector<double *> TmcInitialValueSolver::getCalculatedNextTimeStepSolution(LaVector *lastvector, bool okForNextTimeStep)
 {
+    TMC_TRACE_SCOPE("time step", "solver");
     for (int j = 0; j < degreeOfFreedom; j++)
         qn[j] = lastvector->getValue(j);
 
     /* equation system                                                         */
     /* matrix                                                                  */
 
-    /* right vector                                                            */
-    for (int j = 0; j < degreeOfFreedom; j++)
+    /* right vector, one pass: p = (1-theta) q + theta qn - M m - D d          */
+    /* generalized alpha (theta = 1), divided by 1 - alphaF:                   */
+    /* p = qn + aF q - M (cM m + aM u2) - D (d + aF u1) - K (aF u0)            */
+    /* with aF = alphaF/(1-alphaF), aM = alphaM/(1-alphaF), cM = (1-alphaM)/(1-alphaF) */
+    const TmcThetaMethod method(alpha, beta, theta, alphaM, alphaF, dT);
+    const double aF = method.kU;
+    const double m2 = method.m2, m1 = method.m1, m0 = method.m0;
+    const double d2 = method.d2, d1 = method.d1, d0 = method.d0;
+    if (this->isMatrixFree())
     {
-        pvector->setValue(j, (q[j] * (1. - theta) + qn[j] * theta));
-        mvector->setValue(j, ((1. - 1. / (2. * beta)) * u2[j] -
-                              1. / (beta * (theta * dT)) * u1[j] -
-                              1. / (beta * (theta * dT) * (theta * dT)) * u0[j]));
-        dvector->setValue(j, (((1. - alpha / (2. * beta)) * (theta * dT)) * u2[j] +
-                              (1. - alpha / beta) * u1[j] -
-                              alpha / (beta * (theta * dT)) * u0[j]));
-    }
-    LaVector *dummy1 = mmatrix->multiply(mvector);
-    for (int j = 0; j < degreeOfFreedom; j++)
-        mvector->setValue(j, dummy1->getValue(j));
-    delete dummy1;
-
-    LaVector *dummy2 = dmatrix->multiply(dvector);
-    for (int j = 0; j < degreeOfFreedom; j++)
-        dvector->setValue(j, dummy2->getValue(j));
-    delete dummy2;
+        // Rayleigh damping: M m + D d = M (m + a d) + K (b d)
+        const double a = this->rayleigh ? this->damping.getMassFactor() : 0.0;
+        const double b = this->rayleigh ? this->damping.getStiffnessFactor() : 0.0;
+        const bool damped = this->rayleigh ? !this->damping.isZero() : this->doperator && !this->doperator->isZero();
+        for (int j = 0; j < degreeOfFreedom; j++)
+        {
+            rhs[j] = method.loadOld * q[j] + method.loadNew * qn[j];
+            mwork[j] = m2 * u2[j] - m1 * u1[j] - m0 * u0[j];
+            if (damped)
+                dwork[j] = d2 * u2[j] + d1 * u1[j] - d0 * u0[j];
+            if (a != 0.0)
+                mwork[j] += a * dwork[j];
+        }
+        this->moperator->applyAdd(-1.0, mwork.data(), rhs.data());
+        if (damped && !this->rayleigh)
+            this->doperator->applyAdd(-1.0, dwork.data(), rhs.data());
+        if (b != 0.0 || aF != 0.0)
+        {
+            // dwork becomes the vector of K
+            for (int j = 0; j < degreeOfFreedom; j++)
+                dwork[j] = (b != 0.0 ? b * dwork[j] : 0.0) + aF * u0[j];
+            this->koperator->applyAdd(-1.0, dwork.data(), rhs.data());
+        }
+        for (int u = 0; u < (int)fixedIndices.size(); u++)
+            rhs[fixedIndices[u]] = 0.;
 
-    for (int j = 0; j < degreeOfFreedom; j++)
-    {
-        pvector->setValue(j, pvector->getValue(j) - dvector->getValue(j) - mvector->getValue(j));
+        // ut of the last step is the start vector
+        this->solveIterative(this->aoperator, rhs.data(), ut.data());
     }
-    /* boundary condition */
-    for (int u = 0; u < (int)fixedIndices.size(); u++)
+    else
     {
-        pvector->setValue(fixedIndices[u], 0.);
-    }
+        const auto load = method.loadOld * laVector(q) + method.loadNew * laVector(qn);
+        const auto m = m2 * laVector(u2) - m1 * laVector(u1) - m0 * laVector(u0);
+        const auto d = d2 * laVector(u2) + d1 * laVector(u1) - d0 * laVector(u0);
+        // without damping matrix the Rayleigh coefficients are zero
+        const double a = this->damping.getMassFactor(), b = this->damping.getStiffnessFactor();
+        const bool dampingMatrix = !this->rayleigh && dmatrix;
+        if (dampingMatrix && aF == 0.0)
+            laAssign(pvector, load - (*mmatrix) * m - (*dmatrix) * d);
+        else if (dampingMatrix)
+            laAssign(pvector, load - (*mmatrix) * m - (*dmatrix) * d - (*kmatrix) * (aF * laVector(u0)));
+        else if (a == 0.0 && b == 0.0 && aF == 0.0)
+            laAssign(pvector, load - (*mmatrix) * m);
+        else if (b == 0.0 && aF == 0.0)
+            laAssign(pvector, load - (*mmatrix) * (m + a * d));
+        else // M m + D d = M (m + a d) + K (b d)
+            laAssign(pvector, load - (*mmatrix) * (m + a * d) - (*kmatrix) * (b * d + aF * laVector(u0)));
+
+        /* boundary condition */
+        for (int u = 0; u < (int)fixedIndices.size(); u++)
+        {
+            pvector.setValue(fixedIndices[u], 0.);
+        }
 
-    /* solution                                                                */
-    LaLinearEquation *system = new LaLinearEquation(amatrix, pvector);
-    LaVector *dummy = system->solve();
-    for (int j = 0; j < degreeOfFreedom; j++)
-    {
-        ut[j] = dummy->getValue(j);
-        pvector->setValue(j, ut[j]);
+        /* solution                                                                */
+        LaLinearEquation system(&amatrix, &pvector);
+        system.solve(pvector);
+        for (int j = 0; j < degreeOfFreedom; j++)
+            ut[j] = pvector.getValue(j);
     }
-    delete dummy;
-    delete system;
 
     /* new state variables                                                     */
     for (int j = 0; j < degreeOfFreedom; j++)
     {
-        u0n[j] = u0[j] + 1. / (theta * theta * theta) * (ut[j] - u0[j]) + (1. - 1. / (theta * theta)) * dT * u1[j] + 0.5 * (1. - 1. / (theta)) * dT * dT * u2[j];
-        u1n[j] = alpha / (beta * theta * theta * theta * dT) * (ut[j] - u0[j]) + (1. - alpha / (beta * theta * theta)) * u1[j] + (1. - alpha / (2. * beta * theta)) * dT * u2[j];
-        u2n[j] = 1. / (beta * theta * theta * theta * dT * dT) * (ut[j] - u0[j]) - (1. / (beta * theta * theta * dT)) * u1[j] + (1. - 1. / (2. * beta * theta)) * u2[j];
+        u0n[j] = u0[j] + method.uT * (ut[j] - u0[j]) + method.uV * u1[j] + method.uA * u2[j];
+        u1n[j] = method.vT * (ut[j] - u0[j]) + method.vV * u1[j] + method.vA * u2[j];
+        u2n[j] = method.aT * (ut[j] - u0[j]) + method.aV * u1[j] + method.aA * u2[j];
     }
     /* prepare for next time step	*/
 
     if (okForNextTimeStep)
-    {
-        for (int j = 0; j < degreeOfFreedom; j++)
-        {
-            q[j] = qn[j];
-            u0[j] = u0n[j];
-            u1[j] = u1n[j];
-            u2[j] = u2n[j];
-        }
-    }
+        this->acceptNextTimeStep();
 
     std::vector<double *> result;
-    result.push_back(u0);
-    result.push_back(u1);
-    result.push_back(u2);
+    result.push_back(u0.data());
+    result.push_back(u1.data());
+    result.push_back(u2.data());
     return result;
 }
 /*=====================================================*/
+void TmcInitialValueSolver::acceptNextTimeStep()
+{
+    for (int j = 0; j < degreeOfFreedom; j++)
+    {
+        q[j] = qn[j];
+        u0[j] = u0n[j];
+        u1[j] = u1n[j];
+        u2[j] = u2n[j];
+    }
+    this->time += this->dT;
+    this->evaluateProbes();
+}
+/*=====================================================*/
+void TmcInitialValueSolver::evaluateProbes()
+{
+    if (this->probes.empty())
+        return;
+    // the views are set again, the state vectors may have been resized
+    std::vector<LaConstVectorView> &state = this->probeState;
+    if (state.size() != 3)
+        state.assign(3, this->getDisplacement());
+    state[0] = this->getDisplacement();
+    state[1] = this->getVelocity();
+    state[2] = this->getAcceleration();
+    this->probes.evaluate(this->time, state);
+}
+/*=====================================================*/
+void TmcInitialValueSolver::solveIterative(const LaLinearOperator &matrix, const double *b, double *x)
+{
+    if (!this->cg.solve(matrix, b, x))
+        throw TmcException(UB_EXARGS, "TmcInitialValueSolver - no convergence after " + TmcSystem::toString(this->cg.getIterations()) +
+                                          " iterations, residual " + TmcSystem::toString(this->cg.getResidual()));
+}
+/*=====================================================*/
 void TmcInitialValueSolver::read(TmcFileInput *input)
 {
     // cout<<input->readString()<<endl;
@@ -43,35 +43,132 @@
 
 #include <iostream>
 #include <cmath>
+#include <list>
 #include <vector>
 #include <sstream>
 
 #include <TmcMacroFile.h>
 
-class LaLinearEquation;
-class LaSquareMatrix;
-class LaVector;
+#include <numerics/algebra/LaConjugateGradient.h>
+#include <numerics/algebra/LaLinearOperator.h>
+#include <numerics/algebra/LaSquareMatrix.h>
+#include <numerics/algebra/LaVector.h>
+
+#include "./TmcProbe.h"
+#include "./TmcRayleighDamping.h"
+
 class TmcFileInput;
 class TmcFileOutput;
 
+/**
+  Implicit time integration (Newmark, Wilson theta) of M a + D v + K u = q.
+  <BR><BR>
+  The matrices are either stored (LaSquareMatrix, the step matrix is factorized) or only applied
+  (LaLinearOperator, e.g. TmcBeamOperator). In the matrix-free mode no matrix of the size of the
+  system is built, every system is solved with the conjugate gradient method of
+  getIterativeSolver(), started from the solution of the previous step. The step matrix is well
+  conditioned, the static start solution of a slender structure needs many more iterations.
+  <BR><BR>
+  With Rayleigh damping D = a M + b K there is no damping matrix: its coefficients are folded into
+  the step matrix and D v is computed with the products of M and K (TmcRayleighDamping).
+  A NULL damping matrix or operator is an undamped system.
+  <BR><BR>
+  The generalized alpha method (Chung, Hulbert) evaluates the equation of motion between the
+  time steps, M a(n+1-alphaM) + D v(n+1-alphaF) + K u(n+1-alphaF) = q(n+1-alphaF), with the
+  Newmark updates of u and v. It is second order accurate and damps the high frequencies, the
+  spectral radius for an infinite step width controls the dissipation. The step matrix has the
+  form of the Newmark step matrix with a scaled mass factor, it is assembled and factorized once.
+  HHT alpha is the special case alphaM = 0.
+*/
 class TMC_DLL_EXPORT TmcInitialValueSolver
 {
 public:
     TmcInitialValueSolver(int degreeOfFreedom, LaSquareMatrix *kMatrix, LaSquareMatrix *mMatrix, LaSquareMatrix *dMatrix, double deltaT);
+    TmcInitialValueSolver(int degreeOfFreedom, LaSquareMatrix *kMatrix, LaSquareMatrix *mMatrix, const TmcRayleighDamping &damping, double deltaT);
+    /** matrix-free mode, the operators are referenced, not copied */
+    TmcInitialValueSolver(int degreeOfFreedom, const LaLinearOperator *kOperator, const LaLinearOperator *mOperator, const LaLinearOperator *dOperator, double deltaT);
+    TmcInitialValueSolver(int degreeOfFreedom, const LaLinearOperator *kOperator, const LaLinearOperator *mOperator, const TmcRayleighDamping &damping, double deltaT);
     ~TmcInitialValueSolver(){};
 
     void init(int degreeOfFreedom, LaSquareMatrix *kMatrix, LaSquareMatrix *mMatrix, LaSquareMatrix *dMatrix, double deltaT);
+    void init(int degreeOfFreedom, const LaLinearOperator *kOperator, const LaLinearOperator *mOperator, const LaLinearOperator *dOperator, double deltaT);
+
+    bool isMatrixFree() const { return this->kmatrix == NULL; }
+    /** solver of the matrix-free mode, e.g. to change the tolerance */
+    LaConjugateGradient &getIterativeSolver() { return this->cg; }
 
     void setFixedIndex(int index);
     void setDisplacement(int index, double value);
 
     std::vector<double *> getCalculatedStartSolution(LaVector *lastvector);
+    /**
+      Calculates the state at getTime() + getDeltaT(). With okForNextTimeStep == false the state
+      is only a trial (getNextDisplacement() ...), it becomes the state of the solver with
+      acceptNextTimeStep() or is discarded by the next call.
+    */
     std::vector<double *> getCalculatedNextTimeStepSolution(LaVector *lastvector, bool okForNextTimeStep);
+    void acceptNextTimeStep();
+
+    /** views on the state of the last solution, valid until the solver is destroyed */
+    LaConstVectorView getDisplacement() const { return LaConstVectorView(this->u0.data(), (int)this->u0.size()); }
+    LaConstVectorView getVelocity() const { return LaConstVectorView(this->u1.data(), (int)this->u1.size()); }
+    LaConstVectorView getAcceleration() const { return LaConstVectorView(this->u2.data(), (int)this->u2.size()); }
+    /** views on the trial state of the last time step which wasn't accepted yet */
+    LaConstVectorView getNextDisplacement() const { return LaConstVectorView(this->u0n.data(), (int)this->u0n.size()); }
+    LaConstVectorView getNextVelocity() const { return LaConstVectorView(this->u1n.data(), (int)this->u1n.size()); }
+    LaConstVectorView getNextAcceleration() const { return LaConstVectorView(this->u2n.data(), (int)this->u2n.size()); }
 
     int getDegreeOfFreedom() { return this->degreeOfFreedom; }
     double getDeltaT() { return this->dT; }
-
+    double getTime() { return this->time; }
+    double getAlpha() const { return this->alpha; }
+    double getBeta() const { return this->beta; }
+    double getTheta() const { return this->theta; }
+
+    /**
+      Changes the step width and keeps the integration method. The factorized step matrices of
+      the last getStepMatrixCacheSize() step widths are kept, returning to one of them needs no
+      new factorization (adaptive time stepping with a few distinct step widths).
+      @param cached false for a step width which is used once (e.g. the last step onto an end
+      time), its step matrix is dropped afterwards and pushes no cached one out
+    */
+    void setDeltaT(double deltaT, bool cached = true);
+    /** number of cached step matrices besides the current one, 0 (default) keeps none */
+    void setStepMatrixCacheSize(int size);
+    int getStepMatrixCacheSize() const { return this->stepMatrixCacheSize; }
+    /** number of assembled (and therefore factorized) step matrices */
+    int getStepMatrixAssemblies() const { return this->stepMatrixAssemblies; }
+
+    /** the probes are evaluated after the start solution and after every accepted time step */
+    int addProbe(const TmcProbe &probe) { return this->probes.add(probe, this->degreeOfFreedom, 3); }
+    TmcProbe &getProbe(int index) { return this->probes.get(index); }
+    TmcProbeSet &getProbes() { return this->probes; }
+
+    /** Newmark (theta = 1) or Wilson theta, resets the generalized alpha parameters */
     void setAlphaBetaThetaDeltaT(double alpha, double beta, double theta, double deltaT);
+    /**
+      generalized alpha method with the Newmark parameters alpha (gamma) and beta
+      @exception TmcException if alphaF is not below 1
+    */
+    void setGeneralizedAlphaDeltaT(double alphaM, double alphaF, double alpha, double beta, double deltaT);
+    /**
+      generalized alpha method with optimal dissipation for the spectral radius at infinite step width,
+      1 is the undamped trapezoidal rule, 0 removes the highest frequencies within one step
+      @exception TmcException if the spectral radius is not in [0,1]
+    */
+    void setSpectralRadiusDeltaT(double spectralRadius, double deltaT);
+    /**
+      HHT alpha method (alphaM = 0), alphaF in [0,1/3], 0 is the trapezoidal rule
+      @exception TmcException if alphaF is not in [0,1/3]
+    */
+    void setHHTAlphaDeltaT(double alphaF, double deltaT);
+    double getAlphaM() const { return this->alphaM; }
+    double getAlphaF() const { return this->alphaF; }
+
+    /** replaces the damping matrix (operator) by D = a M + b K */
+    void setRayleighDamping(const TmcRayleighDamping &damping);
+    bool hasRayleighDamping() const { return this->rayleigh; }
+    const TmcRayleighDamping &getRayleighDamping() const { return this->damping; }
 
     std::string toString();
     void read(TmcFileInput *input);
@@ -81,26 +178,45 @@ public:
     LaSquareMatrix *getMMatrix() { return this->mmatrix; }
 
 private:
+    void initState(int degreeOfFreedom, double deltaT);
+    void assembleStepMatrix();
+    void clearStepMatrixCache() { this->stepMatrices.clear(); }
+    void evaluateProbes();
+    void solveIterative(const LaLinearOperator &matrix, const double *b, double *x);
+
     std::vector<int> fixedIndices;
     LaSquareMatrix *kmatrix;
     LaSquareMatrix *mmatrix;
     LaSquareMatrix *dmatrix;
-    LaSquareMatrix *amatrix;
-    double *u;
-    double *u0, *u0n;
-    double *u1, *u1n;
-    double *u2, *u2n;
-    double *p, *ut;
-    double *q, *qn;
-    LaVector *pvector;
-    LaVector *mvector;
-    LaVector *dvector;
-    LaVector *kvector;
-    LaVector *hvector;
+    LaSquareMatrix amatrix;
+    std::list<std::pair<double, LaSquareMatrix>> stepMatrices; // step width, factorized step matrix, most recent first
+    int stepMatrixCacheSize;
+    int stepMatrixAssemblies;
+    bool stepMatrixCached; //< amatrix goes into stepMatrices when the step width changes
+    const LaLinearOperator *koperator;
+    const LaLinearOperator *moperator;
+    const LaLinearOperator *doperator;
+    LaOperatorSum aoperator;
+    LaConjugateGradient cg;
+    std::vector<double> mwork, dwork, rhs;
+    bool rayleigh;
+    TmcRayleighDamping damping;
+    std::vector<double> u0, u0n;
+    std::vector<double> u1, u1n;
+    std::vector<double> u2, u2n;
+    std::vector<double> ut;
+    std::vector<double> q, qn;
+    LaVector pvector;
+    LaVector hvector;
     double dT;
+    double time;
+    TmcProbeSet probes;
+    std::vector<LaConstVectorView> probeState; //< views on the state, reused by evaluateProbes()
     double theta;
     double alpha;
     double beta;
+    double alphaM;
+    double alphaF;
 
     int degreeOfFreedom; // degree of freedom
 };
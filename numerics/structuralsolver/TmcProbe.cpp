@@ -0,0 +1,176 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    probes for the output of solver runs
+
+\*---------------------------------------------------------------------------*/
+
+#include "./TmcProbe.h"
+
+#include <common/utilities/TmcAsyncResultWriter.h>
+#include <common/utilities/TmcException.h>
+#include <common/utilities/TmcSystem.h>
+
+#include <algorithm>
+#include <cmath>
+
+/*============================================================*/
+TmcProbe::TmcProbe(const std::string &name, int degreeOfFreedom, QUANTITY quantity, int stride, REDUCTION reduction)
+    : name(name), degreeOfFreedom(degreeOfFreedom), quantity(quantity), stride(std::max(stride, 1)), reduction(reduction),
+      writer(NULL), keepInMemory(true)
+{
+    if (degreeOfFreedom < 0)
+        throw TmcException(UB_EXARGS, "probe " + name + ": invalid degree of freedom");
+    this->reset();
+}
+/*============================================================*/
+TmcProbe::TmcProbe(const std::string &name, Function function, int stride, REDUCTION reduction)
+    : name(name), degreeOfFreedom(-1), quantity(DISPLACEMENT), function(function), stride(std::max(stride, 1)), reduction(reduction),
+      writer(NULL), keepInMemory(true)
+{
+    if (!function)
+        throw TmcException(UB_EXARGS, "probe " + name + ": no function");
+    this->reset();
+}
+/*============================================================*/
+void TmcProbe::setWriter(TmcAsyncResultWriter *writer, bool keepInMemory)
+{
+    this->writer = writer;
+    this->keepInMemory = keepInMemory || writer == NULL;
+}
+/*============================================================*/
+void TmcProbe::reset()
+{
+    this->data.clear();
+    this->counter = 0;
+    this->windowSize = 0;
+    this->lastTime = 0.0;
+    this->minimum = 0.0;
+    this->maximum = 0.0;
+    this->sumOfSquares = 0.0;
+    this->value = 0.0;
+}
+/*============================================================*/
+void TmcProbe::check(int dimension, int quantities) const
+{
+    if (this->function)
+        return;
+    if ((int)this->quantity >= quantities)
+        throw TmcException(UB_EXARGS, "probe " + this->name + ": quantity is not provided by the solver");
+    if (this->degreeOfFreedom >= dimension)
+        throw TmcException(UB_EXARGS, "probe " + this->name + ": degree of freedom " + TmcSystem::toString(this->degreeOfFreedom) +
+                                          " exceeds the system size " + TmcSystem::toString(dimension));
+}
+/*============================================================*/
+void TmcProbe::evaluate(double time, const std::vector<LaConstVectorView> &state)
+{
+    if (this->function)
+        this->value = this->function(state);
+    else
+        this->value = state[this->quantity][this->degreeOfFreedom];
+    this->lastTime = time;
+
+    if (this->reduction == SAMPLE)
+    {
+        if (this->counter % this->stride == 0)
+            this->writeRow(time);
+    }
+    else
+    {
+        if (this->windowSize == 0)
+        {
+            this->minimum = this->value;
+            this->maximum = this->value;
+            this->sumOfSquares = 0.0;
+        }
+        this->minimum = std::min(this->minimum, this->value);
+        this->maximum = std::max(this->maximum, this->value);
+        this->sumOfSquares += this->value * this->value;
+        this->windowSize++;
+        if (this->windowSize == this->stride)
+            this->writeRow(time);
+    }
+    this->counter++;
+}
+/*============================================================*/
+void TmcProbe::finish()
+{
+    if (this->reduction != SAMPLE && this->windowSize > 0)
+        this->writeRow(this->lastTime);
+}
+/*============================================================*/
+void TmcProbe::writeRow(double time)
+{
+    double row[3];
+    int columns = 2;
+    row[0] = time;
+    if (this->reduction == SAMPLE)
+        row[1] = this->value;
+    else if (this->reduction == RMS)
+        row[1] = std::sqrt(this->sumOfSquares / this->windowSize);
+    else
+    {
+        row[1] = this->minimum;
+        row[2] = this->maximum;
+        columns = 3;
+    }
+    this->windowSize = 0;
+
+    if (this->keepInMemory)
+        this->data.insert(this->data.end(), row, row + columns);
+    if (this->writer)
+        this->writer->push(row, columns);
+}
+
+/*============================================================*/
+/*  TmcProbeSet                                               */
+/*                                                            */
+/*============================================================*/
+int TmcProbeSet::add(const TmcProbe &probe, int dimension, int quantities)
+{
+    probe.check(dimension, quantities);
+    this->probes.push_back(probe);
+    return (int)this->probes.size() - 1;
+}
+/*============================================================*/
+void TmcProbeSet::evaluate(double time, const std::vector<LaConstVectorView> &state)
+{
+    for (size_t i = 0; i < this->probes.size(); i++)
+        this->probes[i].evaluate(time, state);
+}
+/*============================================================*/
+void TmcProbeSet::finish()
+{
+    for (size_t i = 0; i < this->probes.size(); i++)
+        this->probes[i].finish();
+}
@@ -0,0 +1,162 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    probes for the output of solver runs
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TMCPROBE_H
+#define TMCPROBE_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <TmcMacroFile.h>
+
+#include <numerics/algebra/LaView.h>
+
+class TmcAsyncResultWriter;
+
+/**
+  Records one quantity of a solver run, e.g. the displacement of a degree of freedom.
+  <BR><BR>
+  The probe is evaluated by the solver after every accepted time step, it reads the value
+  through views on the state of the solver (u, v, a[, j]), nothing is copied. Every stride evaluations
+  one output row is produced:
+  SAMPLE:   time, value of the current step
+  ENVELOPE: time, minimum, maximum of the values since the last row
+  RMS:      time, root mean square of the values since the last row
+  The rows are kept in memory (getData) and/or pushed into a TmcAsyncResultWriter.
+  Derived quantities (e.g. the difference of two nodes) are defined by a function of the state.
+*/
+class TMC_DLL_EXPORT TmcProbe
+{
+public:
+    enum QUANTITY
+    {
+        DISPLACEMENT = 0,
+        VELOCITY = 1,
+        ACCELERATION = 2,
+        JERK = 3
+    };
+    enum REDUCTION
+    {
+        SAMPLE,
+        ENVELOPE,
+        RMS
+    };
+    /** gets the views on the state of the solver, [0] displacements, [1] velocities, ... */
+    typedef std::function<double(const std::vector<LaConstVectorView> &state)> Function;
+
+public:
+    TmcProbe(const std::string &name, int degreeOfFreedom, QUANTITY quantity = DISPLACEMENT, int stride = 1, REDUCTION reduction = SAMPLE);
+    TmcProbe(const std::string &name, Function function, int stride = 1, REDUCTION reduction = SAMPLE);
+
+    /**
+      @param writer receives the rows, one writer per probe
+      @param keepInMemory false -> getData() stays empty
+    */
+    void setWriter(TmcAsyncResultWriter *writer, bool keepInMemory = false);
+
+    /**
+      Checks the degree of freedom and the quantity against the solver, evaluate() doesn't.
+      @exception TmcException if the probe reads beyond the state of the solver
+    */
+    void check(int dimension, int quantities) const;
+    void evaluate(double time, const std::vector<LaConstVectorView> &state);
+    /** writes the row of an incomplete ENVELOPE/RMS window */
+    void finish();
+    void reset();
+
+    std::string getName() { return this->name; }
+    REDUCTION getReduction() { return this->reduction; }
+    /** time + one value (SAMPLE, RMS) or time + two values (ENVELOPE) */
+    int getNumberOfColumns() { return this->reduction == ENVELOPE ? 3 : 2; }
+    int getNumberOfRows() { return (int)(this->data.size() / this->getNumberOfColumns()); }
+    /** rows one after the other */
+    const std::vector<double> &getData() { return this->data; }
+    double getValue(int row, int column) { return this->data[row * this->getNumberOfColumns() + column]; }
+
+private:
+    void writeRow(double time);
+
+    std::string name;
+    int degreeOfFreedom;
+    QUANTITY quantity;
+    Function function;
+    int stride;
+    REDUCTION reduction;
+
+    TmcAsyncResultWriter *writer;
+    bool keepInMemory;
+    std::vector<double> data;
+
+    int counter;
+    int windowSize;
+    double lastTime;
+    double minimum;
+    double maximum;
+    double sumOfSquares;
+    double value;
+};
+
+/**
+  The probes of a solver, see TmcInitialValueSolver::addProbe.
+*/
+class TMC_DLL_EXPORT TmcProbeSet
+{
+public:
+    /**
+      @param dimension, quantities size of the state of the solver, see TmcProbe::check
+      @return index of the probe
+    */
+    int add(const TmcProbe &probe, int dimension, int quantities);
+    TmcProbe &get(int index) { return this->probes[index]; }
+    int size() { return (int)this->probes.size(); }
+    bool empty() { return this->probes.empty(); }
+    void clear() { this->probes.clear(); }
+
+    /**
+      Checks the degree of freedom and the quantity against the solver, evaluate() doesn't.
+      @exception TmcException if the probe reads beyond the state of the solver
+    */
+    void check(int dimension, int quantities) const;
+    void evaluate(double time, const std::vector<LaConstVectorView> &state);
+    void finish();
+
+private:
+    std::vector<TmcProbe> probes;
+};
+
+#endif
@@ -0,0 +1,90 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    Rayleigh damping
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TMCRAYLEIGHDAMPING_H
+#define TMCRAYLEIGHDAMPING_H
+
+#include <cmath>
+
+#include <TmcMacroFile.h>
+
+#include <common/utilities/TmcException.h>
+
+/**
+  Rayleigh damping D = a M + b K.
+  <BR><BR>
+  The initial value solvers do not store D: the coefficients are folded into the factors of M
+  and K in the step matrix, D v is computed with the products M v and K v of the right hand side.
+  The damping ratio of a mode with circular frequency omega is a / (2 omega) + b omega / 2.
+  <BR><BR>
+  Example:
+  <PRE>
+    //2 % damping at 5 Hz and 50 Hz
+    TmcRayleighDamping damping = TmcRayleighDamping::fromModalDamping(2 * PI * 5, 0.02, 2 * PI * 50, 0.02);
+    TmcInitialValueSolver solver(n, beam.getKMatrix(), beam.getMMatrix(), damping, deltaT);
+  </PRE>
+*/
+class TMC_DLL_EXPORT TmcRayleighDamping
+{
+public:
+    TmcRayleighDamping(double massFactor = 0.0, double stiffnessFactor = 0.0) : massFactor(massFactor), stiffnessFactor(stiffnessFactor) {}
+
+    /**
+      The coefficients which give the damping ratios zeta1 and zeta2 at the circular frequencies omega1 and omega2.
+      @exception TmcException if the frequencies are equal
+    */
+    static TmcRayleighDamping fromModalDamping(double omega1, double zeta1, double omega2, double zeta2)
+    {
+        const double denominator = omega2 * omega2 - omega1 * omega1;
+        if (std::fabs(denominator) <= 1e-12 * omega2 * omega2)
+            throw TmcException(UB_EXARGS, "TmcRayleighDamping - the frequencies must differ");
+        return TmcRayleighDamping(2.0 * omega1 * omega2 * (zeta1 * omega2 - zeta2 * omega1) / denominator,
+                                  2.0 * (zeta2 * omega2 - zeta1 * omega1) / denominator);
+    }
+
+    double getMassFactor() const { return this->massFactor; }
+    double getStiffnessFactor() const { return this->stiffnessFactor; }
+    bool isZero() const { return this->massFactor == 0.0 && this->stiffnessFactor == 0.0; }
+    /** damping ratio of a mode with the circular frequency omega */
+    double getDampingRatio(double omega) const { return 0.5 * (this->massFactor / omega + this->stiffnessFactor * omega); }
+
+private:
+    double massFactor;
+    double stiffnessFactor;
+};
+
+#endif
@@ -0,0 +1,100 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    coefficients of the theta method
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TMCTHETAMETHOD_H
+#define TMCTHETAMETHOD_H
+
+/**
+  Coefficients of the theta method (Newmark, Wilson theta) with the generalized alpha extension,
+  shared by TmcInitialValueSolver and TmcFixedInitialValueSolver.
+  <BR><BR>
+  A time step solves A ut = p for the displacements ut at the time t + theta dT with
+  <PRE>
+    A = K + dFactor D + mFactor M
+    p = loadOld q + loadNew qn - M (m2 a - m1 v - m0 u) - D (d2 a + d1 v - d0 u) - K (kU u)
+  </PRE>
+  where u, v, a are the state and q the load of the last step and qn the new load. The new state
+  follows from ut with
+  <PRE>
+    u(n+1) = u + uT (ut - u) + uV v + uA a
+    v(n+1) =     vT (ut - u) + vV v + vA a
+    a(n+1) =     aT (ut - u) + aV v + aA a
+  </PRE>
+  Without generalized alpha (alphaM = alphaF = 0) the coefficients are those of the plain theta method.
+*/
+struct TmcThetaMethod
+{
+    TmcThetaMethod(double alpha, double beta, double theta, double alphaM, double alphaF, double dT)
+    {
+        // the generalized alpha equation is divided by 1 - alphaF
+        const double thetaDT = theta * dT;
+        const double aM = alphaM / (1. - alphaF);
+        const double cM = (1. - alphaM) / (1. - alphaF);
+
+        this->dFactor = alpha / (beta * theta * dT);
+        this->mFactor = (1. - alphaM) / ((1. - alphaF) * beta * thetaDT * thetaDT);
+
+        this->kU = alphaF / (1. - alphaF);
+        this->loadOld = 1. - theta + this->kU;
+        this->loadNew = theta;
+        this->m2 = cM * (1. - 1. / (2. * beta)) + aM;
+        this->m1 = cM / (beta * thetaDT);
+        this->m0 = cM / (beta * thetaDT * thetaDT);
+        this->d2 = (1. - alpha / (2. * beta)) * thetaDT;
+        this->d1 = (1. - alpha / beta) + this->kU;
+        this->d0 = alpha / (beta * thetaDT);
+
+        this->uT = 1. / (theta * theta * theta);
+        this->uV = (1. - 1. / (theta * theta)) * dT;
+        this->uA = 0.5 * (1. - 1. / (theta)) * dT * dT;
+        this->vT = alpha / (beta * theta * theta * theta * dT);
+        this->vV = 1. - alpha / (beta * theta * theta);
+        this->vA = (1. - alpha / (2. * beta * theta)) * dT;
+        this->aT = 1. / (beta * theta * theta * theta * dT * dT);
+        this->aV = -(1. / (beta * theta * theta * dT));
+        this->aA = 1. - 1. / (2. * beta * theta);
+    }
+
+    /** step matrix */
+    double dFactor, mFactor;
+    /** right hand side */
+    double loadOld, loadNew, m2, m1, m0, d2, d1, d0, kU;
+    /** update of the state */
+    double uT, uV, uA, vT, vV, vA, aT, aV, aA;
+};
+
+#endif
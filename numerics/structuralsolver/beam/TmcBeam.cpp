@@ -57,6 +57,11 @@ TmcBeam::TmcBeam(int knotenanzahl, double E, double I, double length, double m,
     this->init(knotenanzahl, E, I, length, m, d); //, deltaT);
 }
 /*============================================================*/
+TmcBeam::TmcBeam(int knotenanzahl, double E, double I, double length, double m, const TmcRayleighDamping &damping)
+{
+    this->init(knotenanzahl, E, I, length, m, damping);
+}
+/*============================================================*/
 TmcBeam::~TmcBeam()
 {
     delete this->kmatrix;
@@ -65,13 +70,28 @@ TmcBeam::~TmcBeam()
 }
 /*============================================================*/
 void TmcBeam::init(int knotenanzahl, double E, double I, double length, double m, double d) //, double deltaT)
+{
+    // this->dT = deltaT;
+    this->initSystem(knotenanzahl, E, I, length, m);
+    this->d = d;
+    this->damping = TmcRayleighDamping();
+    this->dmatrix = TmcBeamSystem().getDMatrix(knotenanzahl, d);
+}
+/*============================================================*/
+void TmcBeam::init(int knotenanzahl, double E, double I, double length, double m, const TmcRayleighDamping &damping)
+{
+    this->initSystem(knotenanzahl, E, I, length, m);
+    this->d = 0.0;
+    this->damping = damping;
+    this->dmatrix = NULL;
+}
+/*============================================================*/
+void TmcBeam::initSystem(int knotenanzahl, double E, double I, double length, double m)
 {
     this->E = E;
     this->I = I;
     this->m = m;
-    this->d = d;
     this->length = length;
-    // this->dT = deltaT;
     this->linienlast = 0.0;
 
     this->knotenanzahl = knotenanzahl;
@@ -83,7 +103,6 @@ void TmcBeam::init(int knotenanzahl, double E, double I, double length, double m
 
     this->kmatrix = system.getKMatrix(knotenanzahl, E, I, elementlength);
     this->mmatrix = system.getMMatrix(knotenanzahl, m, elementlength);
-    this->dmatrix = system.getDMatrix(knotenanzahl, d);
 }
 /*=====================================================*/
 /*=====================================================*/
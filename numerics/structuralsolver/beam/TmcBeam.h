@@ -48,6 +48,8 @@
 
 #include <TmcMacroFile.h>
 
+#include <numerics/structuralsolver/TmcRayleighDamping.h>
+
 using namespace std;
 
 class LaLinearEquation;
@@ -62,9 +64,12 @@ class TMC_DLL_EXPORT TmcBeam
 public:
     TmcBeam();
     TmcBeam(int knotenanzahl, double E, double I, double length, double m, double d);
+    /** Rayleigh damping, no damping matrix is stored (getDMatrix() returns NULL) */
+    TmcBeam(int knotenanzahl, double E, double I, double length, double m, const TmcRayleighDamping &damping);
     ~TmcBeam();
 
     void init(int knotenanzahl, double E, double I, double length, double m, double d);
+    void init(int knotenanzahl, double E, double I, double length, double m, const TmcRayleighDamping &damping);
 
     int getDegreeOfFreedom() { return this->degreeOfFreedom; }
     int getElementAnzahl() { return this->elementanzahl; }
@@ -82,8 +87,13 @@ public:
     LaSquareMatrix *getKMatrix() { return this->kmatrix; }
     LaSquareMatrix *getMMatrix() { return this->mmatrix; }
     LaSquareMatrix *getDMatrix() { return this->dmatrix; }
+    bool hasRayleighDamping() { return this->dmatrix == NULL; }
+    const TmcRayleighDamping &getRayleighDamping() { return this->damping; }
 
 private:
+    /** everything apart from the damping */
+    void initSystem(int knotenanzahl, double E, double I, double length, double m);
+
     double linienlast;
 
     LaSquareMatrix *kmatrix;
@@ -94,6 +104,7 @@ private:
     double I; // Traegheitsmoment
     double m; // laengenbezogene masse
     double d;
+    TmcRayleighDamping damping;
     double length;
     int knotenanzahl;
     int elementanzahl;
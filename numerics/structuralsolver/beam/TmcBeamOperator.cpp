@@ -0,0 +1,93 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    matrix-free beam operator
+
+\*---------------------------------------------------------------------------*/
+
+#include "./TmcBeamOperator.h"
+
+#include <algorithm>
+
+/*=================================================*/
+TmcBeamOperator::TmcBeamOperator(int pointnumber, const LaFixedMatrix<4> &element)
+    : pointnumber(pointnumber), element(element), zero(true)
+{
+    for (int i = 0; i < 16; i++)
+        this->zero = this->zero && element.value[i] == 0.0;
+}
+/*=================================================*/
+void TmcBeamOperator::apply(const double *x, double *y) const
+{
+    std::fill(y, y + this->getDimension(), 0.0);
+    this->applyAdd(1.0, x, y);
+}
+/*=================================================*/
+// row 2p (w of point p) is row 2 of the left element and row 0 of the right element,
+// row 2p+1 (phi of point p) is row 3 of the left and row 1 of the right element
+void TmcBeamOperator::applyAdd(double factor, const double *x, double *y) const
+{
+    const int last = this->pointnumber - 1;
+    if (last < 1 || this->zero)
+        return;
+    LaFixedMatrix<4> a = this->element;
+    a.multiplyValue(factor);
+
+    // first point, right element only
+    y[0] += a(0, 0) * x[0] + a(0, 1) * x[1] + a(0, 2) * x[2] + a(0, 3) * x[3];
+    y[1] += a(1, 0) * x[0] + a(1, 1) * x[1] + a(1, 2) * x[2] + a(1, 3) * x[3];
+
+    // inner points, coefficients of the points p-1, p and p+1
+    const double w0 = a(2, 0), w1 = a(2, 1), w2 = a(2, 2) + a(0, 0), w3 = a(2, 3) + a(0, 1), w4 = a(0, 2), w5 = a(0, 3);
+    const double r0 = a(3, 0), r1 = a(3, 1), r2 = a(3, 2) + a(1, 0), r3 = a(3, 3) + a(1, 1), r4 = a(1, 2), r5 = a(1, 3);
+    for (int p = 1; p < last; p++)
+    {
+        const double *xp = x + 2 * p;
+        y[2 * p] += w0 * xp[-2] + w1 * xp[-1] + w2 * xp[0] + w3 * xp[1] + w4 * xp[2] + w5 * xp[3];
+        y[2 * p + 1] += r0 * xp[-2] + r1 * xp[-1] + r2 * xp[0] + r3 * xp[1] + r4 * xp[2] + r5 * xp[3];
+    }
+
+    // last point, left element only
+    const double *xl = x + 2 * last - 2;
+    y[2 * last] += a(2, 0) * xl[0] + a(2, 1) * xl[1] + a(2, 2) * xl[2] + a(2, 3) * xl[3];
+    y[2 * last + 1] += a(3, 0) * xl[0] + a(3, 1) * xl[1] + a(3, 2) * xl[2] + a(3, 3) * xl[3];
+}
+/*=================================================*/
+void TmcBeamOperator::getDiagonal(double *diagonal) const
+{
+    for (int p = 0; p < this->pointnumber; p++)
+    {
+        diagonal[2 * p] = (p > 0 ? this->element(2, 2) : 0.0) + (p < this->pointnumber - 1 ? this->element(0, 0) : 0.0);
+        diagonal[2 * p + 1] = (p > 0 ? this->element(3, 3) : 0.0) + (p < this->pointnumber - 1 ? this->element(1, 1) : 0.0);
+    }
+}
@@ -0,0 +1,83 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    matrix-free beam operator
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TMCBEAMOPERATOR_H
+#define TMCBEAMOPERATOR_H
+
+#include <TmcMacroFile.h>
+
+#include <numerics/algebra/LaFixedMatrix.h>
+#include <numerics/algebra/LaLinearOperator.h>
+
+/**
+  Matrix-free stiffness, mass or damping operator of a beam of equal elements.
+  <BR><BR>
+  The product y = A x is evaluated from the 4 x 4 element matrix without assembling A: every
+  point gathers the rows of its left and its right element, so the loop over the inner points
+  has no branches and no scatter and is vectorized by the compiler. Memory and work grow with the
+  number of points only, the dense LaSquareMatrix of TmcBeamSystem grows with its square.
+  Degrees of freedom as in TmcBeamSystem: w, phi of every point.
+  <BR><BR>
+  Example:
+  <PRE>
+    TmcBeamOperator *k = system.getKOperator(pointnumber, E, I, elementlength);
+    TmcBeamOperator *m = system.getMOperator(pointnumber, mass, elementlength);
+    TmcBeamOperator *d = system.getDOperator(pointnumber, damping);
+    TmcInitialValueSolver solver(2 * pointnumber, k, m, d, deltaT);
+  </PRE>
+*/
+class TMC_DLL_EXPORT TmcBeamOperator : public LaLinearOperator
+{
+public:
+    TmcBeamOperator(int pointnumber, const LaFixedMatrix<4> &element);
+
+    int getPointNumber() const { return this->pointnumber; }
+    const LaFixedMatrix<4> &getElementMatrix() const { return this->element; }
+
+    int getDimension() const { return 2 * this->pointnumber; }
+    void apply(const double *x, double *y) const;
+    void applyAdd(double factor, const double *x, double *y) const;
+    void getDiagonal(double *diagonal) const;
+    bool isZero() const { return this->zero; }
+
+private:
+    int pointnumber;
+    LaFixedMatrix<4> element;
+    bool zero;
+};
+
+#endif
@@ -40,94 +40,113 @@
 
 #include "./TmcBeamSystem.h"
 
+#include "./TmcBeamOperator.h"
+
+#include <numerics/algebra/LaAssembler.h>
+#include <numerics/algebra/LaFixedMatrix.h>
 #include <numerics/algebra/LaSquareMatrix.h>
 
-LaSquareMatrix *TmcBeamSystem::getKMatrix(int pointnumber, double E, double I, double elementlength)
+#include <algorithm>
+
+LaFixedMatrix<4> TmcBeamSystem::getElementKMatrix(double E, double I, double elementlength)
 {
-    int anzahl = pointnumber * 2;
-    LaSquareMatrix *kmatrix = new LaSquareMatrix(anzahl, "Stiffnessmatrix");
+    LaFixedMatrix<4> ke;
     double k = E * I / elementlength;
-    for (int i = 0; i < anzahl - 3; i += 2)
-    {
-        kmatrix->addValue(i, i, k * 12.0 / elementlength / elementlength);
-        kmatrix->addValue(i + 1, i, -k * 6.0 / elementlength);
-        kmatrix->addValue(i + 2, i, -k * 12.0 / elementlength / elementlength);
-        kmatrix->addValue(i + 3, i, -k * 6.0 / elementlength);
-
-        kmatrix->addValue(i, i + 1, -k * 6.0 / elementlength);
-        kmatrix->addValue(i + 1, i + 1, k * 4.0);
-        kmatrix->addValue(i + 2, i + 1, k * 6.0 / elementlength);
-        kmatrix->addValue(i + 3, i + 1, k * 2.0);
-
-        kmatrix->addValue(i, i + 2, -k * 12.0 / elementlength / elementlength);
-        kmatrix->addValue(i + 1, i + 2, k * 6.0 / elementlength);
-        kmatrix->addValue(i + 2, i + 2, k * 12.0 / elementlength / elementlength);
-        kmatrix->addValue(i + 3, i + 2, k * 6.0 / elementlength);
-
-        kmatrix->addValue(i, i + 3, -k * 6.0 / elementlength);
-        kmatrix->addValue(i + 1, i + 3, k * 2.0);
-        kmatrix->addValue(i + 2, i + 3, k * 6.0 / elementlength);
-        kmatrix->addValue(i + 3, i + 3, k * 4.0);
-    }
+    ke(0, 0) = k * 12.0 / elementlength / elementlength;
+    ke(1, 0) = -k * 6.0 / elementlength;
+    ke(2, 0) = -k * 12.0 / elementlength / elementlength;
+    ke(3, 0) = -k * 6.0 / elementlength;
+    ke(0, 1) = -k * 6.0 / elementlength;
+    ke(1, 1) = k * 4.0;
+    ke(2, 1) = k * 6.0 / elementlength;
+    ke(3, 1) = k * 2.0;
+    ke(0, 2) = -k * 12.0 / elementlength / elementlength;
+    ke(1, 2) = k * 6.0 / elementlength;
+    ke(2, 2) = k * 12.0 / elementlength / elementlength;
+    ke(3, 2) = k * 6.0 / elementlength;
+    ke(0, 3) = -k * 6.0 / elementlength;
+    ke(1, 3) = k * 2.0;
+    ke(2, 3) = k * 6.0 / elementlength;
+    ke(3, 3) = k * 4.0;
+    return ke;
+}
+/*=================================================*/
+LaFixedMatrix<4> TmcBeamSystem::getElementMMatrix(double m, double length)
+{
+    LaFixedMatrix<4> me4;
+    double me = m * length; // m ...mas per length
+    me4(0, 0) = me * 13.0 / 35.0;
+    me4(1, 0) = me * 11.0 / 210.0 * length;
+    me4(2, 0) = me * 9.0 / 70.0;
+    me4(3, 0) = -me * 13.0 / 420.0 * length;
+    me4(0, 1) = me * 11.0 / 210.0 * length;
+    me4(1, 1) = me * 1.0 / 105.0 * length * length;
+    me4(2, 1) = me * 13.0 / 420.0 * length;
+    me4(3, 1) = -me * 1.0 / 140.0 * length * length;
+    me4(0, 2) = me * 9.0 / 70.0;
+    me4(1, 2) = me * 13.0 / 420.0 * length;
+    me4(2, 2) = me * 13.0 / 35.0;
+    me4(3, 2) = -me * 11.0 / 210.0 * length;
+    me4(0, 3) = -me * 13.0 / 420.0 * length;
+    me4(1, 3) = -me * 1.0 / 140.0 * length * length;
+    me4(2, 3) = -me * 11.0 / 210.0 * length;
+    me4(3, 3) = me * 1.0 / 105.0 * length * length;
+    return me4;
+}
+/*=================================================*/
+// no element damping yet
+LaFixedMatrix<4> TmcBeamSystem::getElementDMatrix(double d)
+{
+    return LaFixedMatrix<4>();
+}
+/*=================================================*/
+LaSquareMatrix *TmcBeamSystem::getKMatrix(int pointnumber, double E, double I, double elementlength)
+{
+    LaSquareMatrix *kmatrix = new LaSquareMatrix(pointnumber * 2, "Stiffnessmatrix");
+    const LaFixedMatrix<4> ke = this->getElementKMatrix(E, I, elementlength);
+    getAssembler(pointnumber).assemble(*kmatrix, [&](int, double *matrix) { std::copy(ke.value, ke.value + 16, matrix); });
     return (kmatrix);
 }
 /*=================================================*/
 LaSquareMatrix *TmcBeamSystem::getMMatrix(int pointnumber, double m, double length)
 {
-    int anzahl = pointnumber * 2;
-    LaSquareMatrix *mmatrix = new LaSquareMatrix(anzahl, "Massmatrix");
-    double me = m * length; // m ...mas per length
-    for (int i = 0; i < anzahl - 3; i += 2)
-    {
-        mmatrix->addValue(i, i, me * 13.0 / 35.0);
-        mmatrix->addValue(i + 1, i, me * 11.0 / 210.0 * length);
-        mmatrix->addValue(i + 2, i, me * 9.0 / 70.0);
-        mmatrix->addValue(i + 3, i, -me * 13.0 / 420.0 * length);
-
-        mmatrix->addValue(i, i + 1, me * 11.0 / 210.0 * length);
-        mmatrix->addValue(i + 1, i + 1, me * 1.0 / 105.0 * length * length);
-        mmatrix->addValue(i + 2, i + 1, me * 13.0 / 420.0 * length);
-        mmatrix->addValue(i + 3, i + 1, -me * 1.0 / 140.0 * length * length);
-
-        mmatrix->addValue(i, i + 2, me * 9.0 / 70.0);
-        mmatrix->addValue(i + 1, i + 2, me * 13.0 / 420.0 * length);
-        mmatrix->addValue(i + 2, i + 2, me * 13.0 / 35.0);
-        mmatrix->addValue(i + 3, i + 2, -me * 11.0 / 210.0 * length);
-
-        mmatrix->addValue(i, i + 3, -me * 13.0 / 420.0 * length);
-        mmatrix->addValue(i + 1, i + 3, -me * 1.0 / 140.0 * length * length);
-        mmatrix->addValue(i + 2, i + 3, -me * 11.0 / 210.0 * length);
-        mmatrix->addValue(i + 3, i + 3, me * 1.0 / 105.0 * length * length);
-    }
+    LaSquareMatrix *mmatrix = new LaSquareMatrix(pointnumber * 2, "Massmatrix");
+    const LaFixedMatrix<4> me = this->getElementMMatrix(m, length);
+    getAssembler(pointnumber).assemble(*mmatrix, [&](int, double *matrix) { std::copy(me.value, me.value + 16, matrix); });
     return (mmatrix);
 }
 /*=================================================*/
 LaSquareMatrix *TmcBeamSystem::getDMatrix(int pointnumber, double d)
 {
-    int anzahl = pointnumber * 2;
-    LaSquareMatrix *dmatrix = new LaSquareMatrix(anzahl, "Dampingmatrix");
-    for (int i = 0; i < anzahl - 3; i += 2)
+    LaSquareMatrix *dmatrix = new LaSquareMatrix(pointnumber * 2, "Dampingmatrix");
+    const LaFixedMatrix<4> de = this->getElementDMatrix(d);
+    getAssembler(pointnumber).assemble(*dmatrix, [&](int, double *matrix) { std::copy(de.value, de.value + 16, matrix); });
+    return (dmatrix);
+}
+/*=================================================*/
+TmcBeamOperator *TmcBeamSystem::getKOperator(int pointnumber, double E, double I, double elementlength)
+{
+    return new TmcBeamOperator(pointnumber, this->getElementKMatrix(E, I, elementlength));
+}
+/*=================================================*/
+TmcBeamOperator *TmcBeamSystem::getMOperator(int pointnumber, double m, double length)
+{
+    return new TmcBeamOperator(pointnumber, this->getElementMMatrix(m, length));
+}
+/*=================================================*/
+TmcBeamOperator *TmcBeamSystem::getDOperator(int pointnumber, double d)
+{
+    return new TmcBeamOperator(pointnumber, this->getElementDMatrix(d));
+}
+/*=================================================*/
+LaAssembler TmcBeamSystem::getAssembler(int pointnumber)
+{
+    LaAssembler assembler(pointnumber * 2);
+    for (int point = 0; point < pointnumber - 1; point++)
     {
-        dmatrix->addValue(i, i, 0.0);
-        dmatrix->addValue(i + 1, i, 0.0);
-        dmatrix->addValue(i + 2, i, 0.0);
-        dmatrix->addValue(i + 3, i, 0.0);
-
-        dmatrix->addValue(i, i + 1, 0.0);
-        dmatrix->addValue(i + 1, i + 1, 0.0);
-        dmatrix->addValue(i + 2, i + 1, 0.0);
-        dmatrix->addValue(i + 3, i + 1, 0.0);
-
-        dmatrix->addValue(i, i + 2, 0.0);
-        dmatrix->addValue(i + 1, i + 2, 0.0);
-        dmatrix->addValue(i + 2, i + 2, 0.0);
-        dmatrix->addValue(i + 3, i + 2, 0.0);
-
-        dmatrix->addValue(i, i + 3, 0.0);
-        dmatrix->addValue(i + 1, i + 3, 0.0);
-        dmatrix->addValue(i + 2, i + 3, 0.0);
-        dmatrix->addValue(i + 3, i + 3, 0.0);
+        const int indices[4] = {2 * point, 2 * point + 1, 2 * point + 2, 2 * point + 3};
+        assembler.addElement(indices, 4);
     }
-    return (dmatrix);
+    return assembler;
 }
 /*=================================================*/
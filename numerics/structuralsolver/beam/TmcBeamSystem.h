@@ -50,7 +50,11 @@
 
 using namespace std;
 
+class LaAssembler;
 class LaSquareMatrix;
+class TmcBeamOperator;
+template <int N>
+class LaFixedMatrix;
 
 class TMC_DLL_EXPORT TmcBeamSystem
 {
@@ -63,6 +67,19 @@ public:
     LaSquareMatrix *getMMatrix(int pointnumber, double m, double length);
     LaSquareMatrix *getDMatrix(int pointnumber, double d);
 
+    // matrices of one element, degrees of freedom: w, phi of the left and the right point
+    static LaFixedMatrix<4> getElementKMatrix(double E, double I, double elementlength);
+    static LaFixedMatrix<4> getElementMMatrix(double m, double length);
+    static LaFixedMatrix<4> getElementDMatrix(double d);
+
+    // matrix-free counterparts of the system matrices, see TmcBeamOperator
+    TmcBeamOperator *getKOperator(int pointnumber, double E, double I, double elementlength);
+    TmcBeamOperator *getMOperator(int pointnumber, double m, double length);
+    TmcBeamOperator *getDOperator(int pointnumber, double d);
+
+    // elements of a beam with pointnumber points, degrees of freedom 2 * point + (0: w, 1: phi)
+    static LaAssembler getAssembler(int pointnumber);
+
     /*====================================*/
 };
 #endif
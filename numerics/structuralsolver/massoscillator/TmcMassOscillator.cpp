@@ -39,12 +39,15 @@
 
 #include "./TmcMassOscillator.h"
 
+#include <numerics/algebra/LaFixedMatrix.h>
 #include <numerics/algebra/LaLinearEquation.h>
 #include <numerics/algebra/LaSquareMatrix.h>
 #include <numerics/algebra/LaVector.h>
-#include <numerics/structuralsolver/TmcInitialValueSolver.h>
+#include <numerics/structuralsolver/TmcFixedInitialValueSolver.h>
 #include <numerics/structuralsolver/TmcInitialValue3rdOrderSolver.h>
 
+#include <common/utilities/TmcTrace.h>
+
 /*============================================================*/
 TmcMassOscillator::TmcMassOscillator()
 {
@@ -56,6 +59,18 @@ TmcMassOscillator::TmcMassOscillator(double B, double M, double D, double K, dou
     this->init(B, M, D, K, load, deltaT, time);
 }
 /*============================================================*/
+TmcMassOscillator::~TmcMassOscillator()
+{
+    // the solvers refer to the matrices
+    delete this->solverNew;
+    delete this->solverStandard;
+    delete this->bMatrix;
+    delete this->mMatrix;
+    delete this->dMatrix;
+    delete this->kMatrix;
+    delete this->loadVector;
+}
+/*============================================================*/
 void TmcMassOscillator::init(double B, double M, double D, double K, double load, double deltaT, double time)
 {
     int degreeOfFreedom = 1;
@@ -76,7 +91,7 @@ void TmcMassOscillator::init(double B, double M, double D, double K, double load
 
     // theta = 1.0;  alpha = 0.5; beta  = 0.25;   //Newmark / 2nd order approach
     // theta = 1.37; alpha = 0.5; beta  = 1.0/6.0; //Wilson / 2nd order approach
-    this->solverStandard = new TmcInitialValueSolver(degreeOfFreedom, kMatrix, mMatrix, dMatrix, deltaT);
+    this->solverStandard = new TmcFixedInitialValueSolver<1>(LaFixedMatrix<1>(kMatrix), LaFixedMatrix<1>(mMatrix), LaFixedMatrix<1>(dMatrix), deltaT);
     this->solverNew = new TmcInitialValue3rdOrderSolver(degreeOfFreedom, bMatrix, mMatrix, dMatrix, kMatrix, deltaT);
 
     this->setValues(B, M, D, K, load, alpha, beta, gamma, theta, deltaT, time);
@@ -91,29 +106,47 @@ void TmcMassOscillator::setValues(double B, double M, double D, double K, double
     this->loadVector->setValue(0, load);
     this->deltaT = deltaT;
     this->time = time;
+    this->solverStandard->setMatrices(LaFixedMatrix<1>(this->kMatrix), LaFixedMatrix<1>(this->mMatrix), LaFixedMatrix<1>(this->dMatrix));
     this->solverStandard->setAlphaBetaThetaDeltaT(alpha, beta, theta, deltaT);
     this->solverNew->setAlphaBetaGammaThetaDeltaT(alpha, beta, gamma, theta, deltaT);
 }
 /*============================================================*/
 void TmcMassOscillator::compute(std::vector<std::tuple<double, double, double, double, double>> &data, bool standard)
 {
+    this->compute(standard, [&data](const std::tuple<double, double, double, double, double> &row)
+                  {
+                      data.push_back(row);
+                      return true;
+                  });
+}
+/*============================================================*/
+void TmcMassOscillator::compute(bool standard, StepCallback callback)
+{
+    TMC_TRACE_SCOPE("mass oscillator compute", "massoscillator");
+
     double valueU = 0.0;
     double valueV = 0.0;
     double valueA = 0.0;
     double valueJ = 0.0;
 
-    std::vector<double *> result;
-    if (standard)
-        result = solverStandard->getCalculatedStartSolution(this->loadVector);
-    else
-        result = solverNew->getCalculatedStartSolution(this->loadVector);
-    valueU = result[0][0];
-    valueV = result[1][0];
-    valueA = result[2][0];
+    // single degree of freedom: the standard solver works on the stack
+    const LaFixedVector<1> load(this->loadVector);
     if (standard)
+    {
+        solverStandard->getCalculatedStartSolution(load);
+        valueU = solverStandard->getDisplacement()[0];
+        valueV = solverStandard->getVelocity()[0];
+        valueA = solverStandard->getAcceleration()[0];
         valueJ = 0.0;
+    }
     else
-        valueJ = result[3][0];
+    {
+        solverNew->getCalculatedStartSolution(this->loadVector);
+        valueU = solverNew->getDisplacement()[0];
+        valueV = solverNew->getVelocity()[0];
+        valueA = solverNew->getAcceleration()[0];
+        valueJ = solverNew->getJerk()[0];
+    }
 
     std::cout << "START - u,v,a,j:" << valueU << " " << valueV << " " << valueA << " " << valueJ << std::endl;
     valueU = 0.0;
@@ -124,24 +157,31 @@ void TmcMassOscillator::compute(std::vector<std::tuple<double, double, double, d
         solverNew->setDisplacement(0, 0.0);
         solverNew->setJerk(0, 0.0);
     }
-    data.push_back(std::make_tuple(0.0, valueU, valueV, valueA, valueJ));
+    if (!callback(std::make_tuple(0.0, valueU, valueV, valueA, valueJ)))
+        return;
 
     int iterations = int(this->time / this->deltaT) + 1;
     std::cout << "Iterations:" << iterations << std::endl;
     for (int i = 1; i < iterations; i++)
     {
+        TMC_TRACE_SCOPE("mass oscillator step", "massoscillator");
         if (standard)
-            result = solverStandard->getCalculatedNextTimeStepSolution(this->loadVector, true);
-        else
-            result = solverNew->getCalculatedNextTimeStepSolution(this->loadVector, true);
-        valueU = result[0][0];
-        valueV = result[1][0];
-        valueA = result[2][0];
-        if (standard)
-            valueJ = 0.0;
+        {
+            solverStandard->getCalculatedNextTimeStepSolution(load, true);
+            valueU = solverStandard->getDisplacement()[0];
+            valueV = solverStandard->getVelocity()[0];
+            valueA = solverStandard->getAcceleration()[0];
+        }
         else
-            valueJ = result[3][0];
-        data.push_back(std::make_tuple((double)i * this->deltaT, valueU, valueV, valueA, valueJ));
+        {
+            solverNew->getCalculatedNextTimeStepSolution(this->loadVector, true);
+            valueU = solverNew->getDisplacement()[0];
+            valueV = solverNew->getVelocity()[0];
+            valueA = solverNew->getAcceleration()[0];
+            valueJ = solverNew->getJerk()[0];
+        }
+        if (!callback(std::make_tuple((double)i * this->deltaT, valueU, valueV, valueA, valueJ)))
+            return;
         // std::cout << "u,v,a,j:" << valueU << " " << valueV << " " << valueA << " " << valueJ << std::endl;
     }
     std::cout << "END time:" << time << " - u,v,a,j:" << valueU << " " << valueV << " " << valueA << " " << valueJ << std::endl;
@@ -42,6 +42,7 @@
 
 #include <iostream>
 #include <cmath>
+#include <functional>
 #include <vector>
 #include <sstream>
 #include <tuple>
@@ -52,24 +53,33 @@ class LaLinearEquation;
 class LaSquareMatrix;
 class LaVector;
 class TmcInitialValue3rdOrderSolver;
-class TmcInitialValueSolver;
+template <int N>
+class TmcFixedInitialValueSolver;
 
 class TMC_DLL_EXPORT TmcMassOscillator
 {
 public:
     TmcMassOscillator();
     TmcMassOscillator(double B, double M, double D, double K, double load, double dT, double time);
-    ~TmcMassOscillator(){};
+    ~TmcMassOscillator();
 
     void init(double B, double M, double D, double K, double load, double dT, double time);
 
     void setValues(double B, double M, double D, double K, double load, double alpha, double beta, double gamma, double theta, double deltaT, double time);
 
+    /** called with time, u, v, a, j after the start solution and every time step, return false to stop */
+    typedef std::function<bool(const std::tuple<double, double, double, double, double> &row)> StepCallback;
+
     void compute(std::vector<std::tuple<double, double, double, double, double>> &data, bool standard);
+    /** may be called from a worker thread, the oscillator must not be changed meanwhile */
+    void compute(bool standard, StepCallback callback);
 
     std::string toString();
 
 private:
+    TmcMassOscillator(const TmcMassOscillator &);
+    TmcMassOscillator &operator=(const TmcMassOscillator &);
+
     LaSquareMatrix *bMatrix;
     LaSquareMatrix *mMatrix;
     LaSquareMatrix *dMatrix;
@@ -78,6 +88,6 @@ private:
     double deltaT;
     double time;
     TmcInitialValue3rdOrderSolver *solverNew;
-    TmcInitialValueSolver *solverStandard;
+    TmcFixedInitialValueSolver<1> *solverStandard;
 };
 #endif
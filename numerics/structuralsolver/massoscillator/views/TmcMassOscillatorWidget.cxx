@@ -68,6 +68,7 @@
 #include <QSettings>
 #include <QMessageBox>
 #include <QInputDialog>
+#include <QTimer>
 
 #include <vtkTable.h>
 #include <vtkNew.h>
@@ -94,22 +95,27 @@
 #include <vtkColorSeries.h>
 #include <vtkNamedColors.h>
 
+#include <atomic>
 #include <cmath>
 #include <cstring>
 #include <sstream>
 #include <iostream>
+#include <thread>
 #include <tuple>
 
 #include <common/math/TmcMath.h>
+#include <common/utilities/TmcException.h>
+#include <common/utilities/TmcRingBuffer.h>
 #include <common/utilities/TmcSystem.h>
 #include <common/utilities/TmcTiming.h>
+#include <common/utilities/TmcTrace.h>
 
 #include <numerics/structuralsolver/massoscillator/TmcMassOscillator.h>
 #include <views/plot2d/TmcPlotWidget.h>
 
 struct TmcMassOscillatorWidgetPrivate
 {
-    TmcMassOscillatorWidgetPrivate() {}
+    TmcMassOscillatorWidgetPrivate() : results(1 << 16), computing(false), finished(false), cancelled(false) {}
 
     QGridLayout *gridLayoutOscillator;
     QLabel *labelB;
@@ -140,6 +146,17 @@ struct TmcMassOscillatorWidgetPrivate
 
     TmcMassOscillator *massOscillator;
     TmcPlotWidget *plotWidget;
+
+    // worker thread -> GUI thread, single producer and single consumer
+    TmcRingBuffer<std::tuple<double, double, double, double, double>> results;
+    std::vector<std::tuple<double, double, double, double, double>> chunk;
+    std::thread worker;
+    QTimer *drainTimer;
+    TmcTimer timer;
+    bool computing;
+    std::atomic<bool> finished;
+    std::atomic<bool> cancelled;
+    std::string error; //< written by the worker before finished
 };
 
 TmcMassOscillatorWidget::TmcMassOscillatorWidget(TmcPlotWidget *plotWidget, QWidget *parent) : QWidget(parent),
@@ -225,13 +242,21 @@ TmcMassOscillatorWidget::TmcMassOscillatorWidget(TmcPlotWidget *plotWidget, QWid
 
     this->setLayout(d_ptr->gridLayoutOscillator);
 
+    d_ptr->drainTimer = new QTimer(this);
+    d_ptr->drainTimer->setInterval(15);
+
     QObject::connect(d_ptr->pushButtonInitialValues, SIGNAL(clicked()), this, SLOT(on_pushButtonInitialValues_clicked()));
+    QObject::connect(d_ptr->drainTimer, SIGNAL(timeout()), this, SLOT(drainResults()));
     QObject::connect(d_ptr->pushButtonComputeNew, SIGNAL(clicked()), this, SLOT(on_pushButtonComputeNew_clicked()));
     QObject::connect(d_ptr->pushButtonComputeStandard, SIGNAL(clicked()), this, SLOT(on_pushButtonComputeStandard_clicked()));
 }
 
 TmcMassOscillatorWidget::~TmcMassOscillatorWidget()
 {
+    this->cancel();
+    if (d_ptr->worker.joinable())
+        d_ptr->worker.join();
+    delete d_ptr->massOscillator;
 }
 /*===========================================================*/
 void TmcMassOscillatorWidget::setInitialOscillatorDefaultValues()
@@ -269,16 +294,107 @@ void TmcMassOscillatorWidget::setValuesToMassOscillator()
 /*===========================================================*/
 void TmcMassOscillatorWidget::compute(bool standard)
 {
+    if (d_ptr->computing)
+        return;
+
     this->setValuesToMassOscillator();
     std::cout << "Solver:\n"
               << d_ptr->massOscillator->toString() << std::endl;
-    std::vector<std::tuple<double, double, double, double, double>> data;
-    TmcTimer timer;
-    timer.start();
-    d_ptr->massOscillator->compute(data, standard);
-    timer.stop();
-    std::cout << "Elapsed time: " << timer.getTotalTime() << " s" << std::endl;
-    d_ptr->plotWidget->updateData(data);
+
+    d_ptr->computing = true;
+    d_ptr->finished.store(false);
+    d_ptr->cancelled.store(false);
+    d_ptr->error.clear();
+    d_ptr->pushButtonInitialValues->setEnabled(false);
+    d_ptr->pushButtonComputeStandard->setEnabled(false);
+    d_ptr->pushButtonComputeNew->setEnabled(false);
+
+    d_ptr->plotWidget->beginStream();
+    d_ptr->timer.resetAndStart();
+
+    TmcMassOscillatorWidgetPrivate *p = d_ptr.data();
+    d_ptr->worker = std::thread([p, standard]()
+                                {
+                                    TmcTrace::setThreadName("mass oscillator");
+                                    // an exception must not leave the thread, the GUI thread reports it
+                                    try
+                                    {
+                                        p->massOscillator->compute(standard, [p](const std::tuple<double, double, double, double, double> &row)
+                                                                   {
+                                                                       // the solver waits if the GUI thread falls behind
+                                                                       while (!p->results.push(row))
+                                                                       {
+                                                                           if (p->cancelled.load(std::memory_order_relaxed))
+                                                                               return false;
+                                                                           std::this_thread::yield();
+                                                                       }
+                                                                       return !p->cancelled.load(std::memory_order_relaxed);
+                                                                   });
+                                    }
+                                    catch (TmcException &e)
+                                    {
+                                        p->error = e.toString();
+                                    }
+                                    catch (std::exception &e)
+                                    {
+                                        p->error = e.what();
+                                    }
+                                    catch (...)
+                                    {
+                                        p->error = "unknown error";
+                                    }
+                                    p->finished.store(true, std::memory_order_release);
+                                });
+    d_ptr->drainTimer->start();
+}
+/*===========================================================*/
+bool TmcMassOscillatorWidget::isComputing() const
+{
+    return d_ptr->computing;
+}
+/*===========================================================*/
+void TmcMassOscillatorWidget::cancel()
+{
+    d_ptr->cancelled.store(true);
+}
+/*===========================================================*/
+// GUI thread: moves the rows of the worker thread into the plot, the plot limits the redraws
+void TmcMassOscillatorWidget::drainResults()
+{
+    TMC_TRACE_SCOPE("mass oscillator drainResults", "gui");
+    // read before draining, all rows of a finished worker are in the buffer then
+    const bool done = d_ptr->finished.load(std::memory_order_acquire);
+
+    d_ptr->chunk.clear();
+    std::tuple<double, double, double, double, double> row;
+    while (d_ptr->results.pop(row))
+        d_ptr->chunk.push_back(row);
+    if (!d_ptr->chunk.empty())
+        d_ptr->plotWidget->appendData(d_ptr->chunk);
+
+    if (done)
+        this->finishCompute();
+}
+/*===========================================================*/
+void TmcMassOscillatorWidget::finishCompute()
+{
+    d_ptr->drainTimer->stop();
+    d_ptr->worker.join();
+    d_ptr->timer.stop();
+    std::cout << "Elapsed time: " << d_ptr->timer.getTotalTime() << " s" << std::endl;
+
+    d_ptr->plotWidget->endStream();
+    d_ptr->computing = false;
+    d_ptr->pushButtonInitialValues->setEnabled(true);
+    d_ptr->pushButtonComputeStandard->setEnabled(true);
+    d_ptr->pushButtonComputeNew->setEnabled(true);
+
+    if (!d_ptr->error.empty())
+    {
+        std::cout << "Computation failed:\n"
+                  << d_ptr->error << std::endl;
+        QMessageBox::warning(this, "Mass Oscillator", QString::fromStdString(d_ptr->error));
+    }
 }
 /*===========================================================*/
 void TmcMassOscillatorWidget::on_pushButtonInitialValues_clicked()
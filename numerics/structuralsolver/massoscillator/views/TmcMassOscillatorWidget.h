@@ -63,16 +63,23 @@ public:
 
     void setInitialOscillatorDefaultValues();
     void setValuesToMassOscillator();
+    // the solver runs on a worker thread, the results are streamed into the plot widget
     void compute(bool standard);
+    bool isComputing() const;
+    void cancel();
 
 protected slots:
     void on_pushButtonInitialValues_clicked();
     void on_pushButtonComputeStandard_clicked();
     void on_pushButtonComputeNew_clicked();
 
+    void drainResults();
+
 private:
     Q_DISABLE_COPY(TmcMassOscillatorWidget)
 
+    void finishCompute();
+
     QScopedPointer<TmcMassOscillatorWidgetPrivate> d_ptr;
 };
 
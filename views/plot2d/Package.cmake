@@ -7,10 +7,12 @@ include_directories(
 
 set(qt_HEADERS
     ${SOURCE_ROOT}/views/plot2d/TmcPlotWidget.h
+    ${SOURCE_ROOT}/views/plot2d/TmcPlotLod.h
     ${SOURCE_ROOT}/numerics/structuralsolver/massoscillator/views/TmcMassOscillatorWidget.h
     )
 set(qt_SOURCES
     ${SOURCE_ROOT}/views/plot2d/TmcPlotWidget.cxx
+    ${SOURCE_ROOT}/views/plot2d/TmcPlotLod.cpp
     ${SOURCE_ROOT}/numerics/structuralsolver/massoscillator/views/TmcMassOscillatorWidget.cxx
     )
 
@@ -0,0 +1,267 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    min/max pyramid for drawing long time histories
+
+\*---------------------------------------------------------------------------*/
+
+#include "TmcPlotLod.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*===========================================================*/
+TmcPlotLod::TmcPlotLod(int numberOfColumns, int bucketSize, int branching)
+    : columns(numberOfColumns), bucketSize((std::size_t)std::max(2, bucketSize)), branching((std::size_t)std::max(2, branching)), rows(0), ascending(true), lastX(0.0)
+{
+    this->reset(numberOfColumns);
+}
+/*===========================================================*/
+void TmcPlotLod::reset(int numberOfColumns)
+{
+    this->columns = std::max(0, numberOfColumns);
+    this->rows = 0;
+    this->ascending = true;
+    this->lastX = 0.0;
+    this->levels.clear();
+    this->addLevel();
+}
+/*===========================================================*/
+// the new level is filled from the current top level
+void TmcPlotLod::addLevel()
+{
+    Level level;
+    level.current = 0;
+    level.bucketSize = this->levels.empty() ? this->bucketSize : this->levels.back().bucketSize * this->branching;
+    if (!this->levels.empty() && this->columns > 0)
+    {
+        const Level &child = this->levels.back();
+        const std::size_t nc = (std::size_t)this->columns;
+        const std::size_t childBuckets = child.minValue.size() / nc;
+        for (std::size_t b = 0; b < childBuckets; b++)
+        {
+            const std::size_t parent = b / this->branching;
+            for (std::size_t c = 0; c < nc; c++)
+            {
+                const std::size_t from = b * nc + c;
+                if (b % this->branching == 0)
+                {
+                    level.minIndex.push_back(child.minIndex[from]);
+                    level.maxIndex.push_back(child.maxIndex[from]);
+                    level.minValue.push_back(child.minValue[from]);
+                    level.maxValue.push_back(child.maxValue[from]);
+                    continue;
+                }
+                const std::size_t to = parent * nc + c;
+                if (c == 0)
+                {
+                    level.maxIndex[to] = child.maxIndex[from];
+                    level.maxValue[to] = child.maxValue[from];
+                    continue;
+                }
+                const double minValue = child.minValue[from];
+                const double maxValue = child.maxValue[from];
+                if (!std::isnan(minValue) && (std::isnan(level.minValue[to]) || minValue < level.minValue[to]))
+                {
+                    level.minValue[to] = minValue;
+                    level.minIndex[to] = child.minIndex[from];
+                }
+                if (!std::isnan(maxValue) && (std::isnan(level.maxValue[to]) || maxValue > level.maxValue[to]))
+                {
+                    level.maxValue[to] = maxValue;
+                    level.maxIndex[to] = child.maxIndex[from];
+                }
+            }
+        }
+    }
+    if (!level.minValue.empty())
+        level.current = level.minValue.size() - (std::size_t)this->columns;
+    this->levels.push_back(level);
+}
+/*===========================================================*/
+void TmcPlotLod::append(const double *row)
+{
+    const std::size_t index = this->rows++;
+    const std::size_t nc = (std::size_t)this->columns;
+
+    if (nc > 0)
+    {
+        if (index > 0 && row[0] < this->lastX)
+            this->ascending = false;
+        this->lastX = row[0];
+    }
+
+    // a new bucket on level l+1 starts a new bucket on level l too
+    std::size_t l = 0;
+    for (; l < this->levels.size() && index % this->levels[l].bucketSize == 0; l++)
+    {
+        Level &level = this->levels[l];
+        level.current = level.minValue.size();
+        for (std::size_t c = 0; c < nc; c++)
+        {
+            level.minIndex.push_back(index);
+            level.maxIndex.push_back(index);
+            level.minValue.push_back(row[c]);
+            level.maxValue.push_back(row[c]);
+        }
+    }
+    const std::size_t firstUpdate = l;
+
+    // column 0 is the x-axis: first and last row of the bucket
+    if (nc > 0)
+    {
+        for (l = firstUpdate; l < this->levels.size(); l++)
+        {
+            Level &level = this->levels[l];
+            const std::size_t offset = level.current;
+            level.maxIndex[offset] = index;
+            level.maxValue[offset] = row[0];
+        }
+    }
+    // a value which is no new extreme of a bucket is no new extreme of the coarser buckets
+    for (std::size_t c = 1; c < nc; c++)
+    {
+        const double value = row[c];
+        if (std::isnan(value))
+            continue;
+        for (l = firstUpdate; l < this->levels.size(); l++)
+        {
+            Level &level = this->levels[l];
+            const std::size_t offset = level.current + c;
+            if (std::isnan(level.minValue[offset]) || value < level.minValue[offset])
+            {
+                level.minValue[offset] = value;
+                level.minIndex[offset] = index;
+            }
+            else
+                break;
+        }
+        for (l = firstUpdate; l < this->levels.size(); l++)
+        {
+            Level &level = this->levels[l];
+            const std::size_t offset = level.current + c;
+            if (std::isnan(level.maxValue[offset]) || value > level.maxValue[offset])
+            {
+                level.maxValue[offset] = value;
+                level.maxIndex[offset] = index;
+            }
+            else
+                break;
+        }
+    }
+
+    if (nc > 0 && this->levels.back().minValue.size() / nc > this->branching)
+        this->addLevel();
+}
+/*===========================================================*/
+void TmcPlotLod::select(std::size_t first, std::size_t last, int pixels, std::vector<std::size_t> &indices) const
+{
+    indices.clear();
+    last = std::min(last, this->rows);
+    if (first >= last)
+        return;
+
+    const std::size_t n = last - first;
+    const std::size_t width = (std::size_t)std::max(1, pixels);
+    if (n <= this->bucketSize * width || this->columns == 0)
+    {
+        indices.resize(n);
+        for (std::size_t i = 0; i < n; i++)
+            indices[i] = first + i;
+        return;
+    }
+
+    // coarsest level with at least one bucket per pixel
+    std::size_t l = 0;
+    while (l + 1 < this->levels.size() && n / this->levels[l + 1].bucketSize >= width)
+        l++;
+    indices.reserve(n / this->levels[l].bucketSize * 2 * (std::size_t)this->columns + 2 * this->bucketSize);
+    this->collect(l, first, last, indices);
+}
+/*===========================================================*/
+// buckets which are only partly inside [first, last) are refined on the finer levels
+void TmcPlotLod::collect(std::size_t l, std::size_t first, std::size_t last, std::vector<std::size_t> &indices) const
+{
+    if (first >= last)
+        return;
+
+    const Level &level = this->levels[l];
+    const std::size_t firstBucket = (first + level.bucketSize - 1) / level.bucketSize;
+    const std::size_t lastBucket = last / level.bucketSize;
+    if (firstBucket >= lastBucket)
+    {
+        if (l == 0)
+            for (std::size_t i = first; i < last; i++)
+                indices.push_back(i);
+        else
+            this->collect(l - 1, first, last, indices);
+        return;
+    }
+
+    if (l == 0)
+        for (std::size_t i = first; i < firstBucket * level.bucketSize; i++)
+            indices.push_back(i);
+    else
+        this->collect(l - 1, first, firstBucket * level.bucketSize, indices);
+
+    const std::size_t nc = (std::size_t)this->columns;
+    std::vector<std::size_t> bucketIndices(2 * nc);
+    for (std::size_t b = firstBucket; b < lastBucket; b++)
+    {
+        for (std::size_t c = 0; c < nc; c++)
+        {
+            bucketIndices[2 * c] = level.minIndex[b * nc + c];
+            bucketIndices[2 * c + 1] = level.maxIndex[b * nc + c];
+        }
+        std::sort(bucketIndices.begin(), bucketIndices.end());
+        for (std::size_t i = 0; i < bucketIndices.size(); i++)
+            if (indices.empty() || bucketIndices[i] > indices.back())
+                indices.push_back(bucketIndices[i]);
+    }
+
+    if (l == 0)
+        for (std::size_t i = lastBucket * level.bucketSize; i < last; i++)
+            indices.push_back(i);
+    else
+        this->collect(l - 1, lastBucket * level.bucketSize, last, indices);
+}
+/*===========================================================*/
+void TmcPlotLod::findRange(const double *x, std::size_t n, double xMin, double xMax, std::size_t &first, std::size_t &last)
+{
+    first = (std::size_t)(std::lower_bound(x, x + n, xMin) - x);
+    last = (std::size_t)(std::upper_bound(x, x + n, xMax) - x);
+    if (first > 0)
+        first--;
+    if (last < n)
+        last++;
+}
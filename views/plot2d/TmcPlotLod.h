@@ -0,0 +1,107 @@
+/*---------------------------------------------------------------------------*\
+
+        .----------------.  .----------------.  .----------------.
+       | .--------------. || .--------------. || .--------------. |
+       | |  _________   | || | ____    ____ | || |     ______   | |
+       | | |  _   _  |  | || ||_   \  /   _|| || |   .' ___  |  | |
+       | | |_/ | | \_|  | || |  |   \/   |  | || |  / .'   \_|  | |
+       | |     | |      | || |  | |\  /| |  | || |  | |         | |
+       | |    _| |_     | || | _| |_\/_| |_ | || |  \ `.___.'\  | |
+       | |   |_____|    | || ||_____||_____|| || |   `._____.'  | |
+       | |              | || |              | || |              | |
+       | '--------------' || '--------------' || '--------------' |
+        '----------------'  '----------------'  '----------------'
+ ------------------------------------------------------------------------------
+ Copyright (C) 2022-2023 Sebastian Geller
+
+ This software is distributed WITHOUT ANY WARRANTY.
+
+ License
+
+    TMC is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TMC is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+    for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with TMC (see LICENSE.txt). If not, see <http://www.gnu.org/licenses/>.
+
+ Description
+    min/max pyramid for drawing long time histories
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef TmcPlotLod_H
+#define TmcPlotLod_H
+
+#include <cstddef>
+#include <vector>
+
+#include <TmcMacroFile.h>
+
+//////////////////////////////////////////////////////////////////////////
+// TmcPlotLod
+// level of detail for long time histories
+// Functionality:
+// min/max pyramid over the rows of a table. Level 0 stores for every bucket of bucketSize rows
+// and every column the indices and values of the minimum and the maximum, level k+1 combines
+// branching buckets of level k. The pyramid only holds indices, the values stay in the table.
+// It is built incrementally with append(), the costs per row are O(columns * levels).
+// select() returns the rows needed to draw a range of rows on a given number of pixels: all rows
+// if there are few, otherwise the minima and maxima of the coarsest level with at least one
+// bucket per pixel, so peaks are never lost. The x column keeps the first and the last row of a
+// bucket. NaN values are ignored.
+//
+// Example:     TmcPlotLod lod(5);
+//              for each row: lod.append(row);
+//              lod.findRange(x, lod.size(), xMin, xMax, first, last);
+//              lod.select(first, last, 1000, indices);
+//////////////////////////////////////////////////////////////////////////
+class TMC_DLL_EXPORT TmcPlotLod
+{
+public:
+    explicit TmcPlotLod(int numberOfColumns = 0, int bucketSize = 16, int branching = 4);
+
+    void reset(int numberOfColumns);
+    void append(const double *row);
+
+    std::size_t size() const { return this->rows; }
+    int getNumberOfColumns() const { return this->columns; }
+    int getNumberOfLevels() const { return (int)this->levels.size(); }
+    // true as long as the values of column 0 do not decrease
+    bool isAscending() const { return this->ascending; }
+
+    // sorted rows of [first, last) for drawing on pixels, includes first, last - 1 and all extremes
+    void select(std::size_t first, std::size_t last, int pixels, std::vector<std::size_t> &indices) const;
+
+    // rows [first, last) of an ascending x column covering [xMin, xMax] including one row outside on each side
+    static void findRange(const double *x, std::size_t n, double xMin, double xMax, std::size_t &first, std::size_t &last);
+
+private:
+    struct Level
+    {
+        std::size_t bucketSize;
+        std::size_t current; //< offset of the last bucket, the rows are appended
+        std::vector<std::size_t> minIndex; //< bucket * columns + column
+        std::vector<std::size_t> maxIndex;
+        std::vector<double> minValue;
+        std::vector<double> maxValue;
+    };
+
+    void addLevel();
+    void collect(std::size_t level, std::size_t first, std::size_t last, std::vector<std::size_t> &indices) const;
+
+    int columns;
+    std::size_t bucketSize;
+    std::size_t branching;
+    std::size_t rows;
+    bool ascending;
+    double lastX;
+    std::vector<Level> levels;
+};
+
+#endif
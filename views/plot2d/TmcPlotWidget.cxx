@@ -39,6 +39,7 @@
 \*---------------------------------------------------------------------------*/
 
 #include "TmcPlotWidget.h"
+#include "TmcPlotLod.h"
 
 #include <QDateTime>
 #include <QDebug>
@@ -70,6 +71,7 @@
 #include <QSettings>
 #include <QMessageBox>
 #include <QInputDialog>
+#include <QTimer>
 
 #include <vtkTable.h>
 #include <vtkNew.h>
@@ -88,6 +90,7 @@
 #include <vtkDelimitedTextReader.h>
 #include <vtkDelimitedTextWriter.h>
 #include <vtkDoubleArray.h>
+#include <vtkDataArray.h>
 #include <vtkWindowToImageFilter.h>
 #include <vtkGenericOpenGLRenderWindow.h>
 #include <QVTKInteractor.h>
@@ -102,9 +105,17 @@
 #include <iostream>
 #include <tuple>
 
+#include <common/utilities/TmcColumnFile.h>
+#include <common/utilities/TmcTrace.h>
+
 struct TmcPlotWidgetPrivate
 {
-    TmcPlotWidgetPrivate() : model(0), disableUpdate(false) {}
+    TmcPlotWidgetPrivate() : model(0), disableUpdate(false), streamTimer(0), streaming(false), streamModified(false), maximumFrameRate(30),
+                             lodTimer(0), lodThreshold(50000), lodModified(false), rangeObserver(0)
+    {
+        lodRange[0] = -std::numeric_limits<double>::infinity();
+        lodRange[1] = std::numeric_limits<double>::infinity();
+    }
 
     QGridLayout *gridLayout;
     QVTKRenderWidget *qvtkWidget;
@@ -134,6 +145,18 @@ struct TmcPlotWidgetPrivate
 
     QIcon iconLog;
     QIcon iconLin;
+
+    QTimer *streamTimer;
+    bool streaming;
+    bool streamModified;
+    int maximumFrameRate;
+
+    std::vector<TmcPlotLod> lods; //< one per member table
+    QTimer *lodTimer;
+    int lodThreshold;
+    bool lodModified;
+    double lodRange[2]; //< x range the reduced tables are filled for
+    unsigned long rangeObserver;
 };
 
 TmcPlotWidget::TmcPlotWidget(QWidget *parent) : QWidget(parent),
@@ -251,13 +274,24 @@ TmcPlotWidget::TmcPlotWidget(QWidget *parent) : QWidget(parent),
 
     d_ptr->view->GetRenderer()->SetBackground(0.8, 0.8, 0.8);
 
+    d_ptr->streamTimer = new QTimer(this);
+    d_ptr->streamTimer->setSingleShot(true);
+    d_ptr->streamTimer->setInterval(1000 / d_ptr->maximumFrameRate);
+    d_ptr->lodTimer = new QTimer(this);
+    d_ptr->lodTimer->setSingleShot(true);
+    d_ptr->lodTimer->setInterval(50);
+    d_ptr->rangeObserver = d_ptr->chart->GetAxis(1)->AddObserver(vtkChart::UpdateRange, this, &TmcPlotWidget::axisRangeChanged);
+
     QObject::connect(d_ptr->comboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(update()));
+    QObject::connect(d_ptr->streamTimer, SIGNAL(timeout()), this, SLOT(redrawStream()));
+    QObject::connect(d_ptr->lodTimer, SIGNAL(timeout()), this, SLOT(refineLevelOfDetail()));
     QObject::connect(d_ptr->pushButtonResize, SIGNAL(clicked()), this, SLOT(on_pushButtonResize_clicked()));
     QObject::connect(d_ptr->pushButtonShowLogScale, SIGNAL(toggled(bool)), this, SLOT(on_viewLogScaleAction_toggled(bool)));
 }
 
 TmcPlotWidget::~TmcPlotWidget()
 {
+    d_ptr->chart->GetAxis(1)->RemoveObserver(d_ptr->rangeObserver);
 }
 
 /*===========================================================*/
@@ -268,6 +302,7 @@ void TmcPlotWidget::addPluginWidget(QWidget *widget)
 /*===========================================================*/
 void TmcPlotWidget::refresh()
 {
+    TMC_TRACE_SCOPE("plot render", "gui");
     d_ptr->view->GetRenderWindow()->GetInteractor()->Render();
 }
 /*===========================================================*/
@@ -284,42 +319,73 @@ void TmcPlotWidget::writeCsv(const QString &filename)
         writer->Write();
     }
 }
-
-void TmcPlotWidget::updateTable()
+/*===========================================================*/
+void TmcPlotWidget::writeColumnFile(const QString &filename)
 {
-    if (d_ptr->isLogScale)
+    for (int t = 0; t < (int)d_ptr->tables.size(); ++t)
     {
-        for (int t = 0; t < (int)d_ptr->tables.size(); ++t)
+        vtkSmartPointer<vtkTable> table = d_ptr->memberTables[t];
+        const int nc = table->GetNumberOfColumns();
+        const vtkIdType nr = table->GetNumberOfRows();
+        if (nc == 0)
+            continue;
+
+        std::vector<std::string> names;
+        std::vector<vtkDataArray *> columns;
+        for (int c = 0; c < nc; ++c)
         {
-            vtkSmartPointer<vtkTable> table = d_ptr->tables[t];
-            vtkSmartPointer<vtkTable> memberTable = d_ptr->memberTables[t];
-            memberTable->DeepCopy(table);
+            names.push_back(table->GetColumnName(c));
+            columns.push_back(vtkDataArray::SafeDownCast(table->GetColumn(c)));
+        }
 
-            const std::size_t nr = table->GetNumberOfRows();
-            const std::size_t nc = table->GetNumberOfColumns();
-            for (std::size_t r = 0; r < nr; ++r)
-            {
-                for (std::size_t c = 0; c < nc; ++c)
-                {
-                    double val = table->GetValue(r, c).ToDouble();
-                    if (val < 1e-17)
-                    {
-                        table->SetValue(r, c, nan(""));
-                    }
-                }
-            }
+        TmcColumnFileWriter writer(filename.toStdString() + "_" + std::to_string(t) + ".tmcc", names);
+        std::vector<double> row(nc);
+        for (vtkIdType r = 0; r < nr; ++r)
+        {
+            for (int c = 0; c < nc; ++c)
+                row[c] = columns[c] ? columns[c]->GetTuple1(r) : table->GetValue(r, c).ToDouble();
+            writer.writeRow(&row[0]);
         }
+        writer.close();
     }
-    else
-    {
-        for (int t = 0; t < (int)d_ptr->tables.size(); ++t)
-        {
-            vtkSmartPointer<vtkTable> table = d_ptr->tables[t];
-            vtkSmartPointer<vtkTable> memberTable = d_ptr->memberTables[t];
+}
+/*===========================================================*/
+void TmcPlotWidget::loadColumnFile(const QString &filename, double startTime, double endTime)
+{
+    TMC_TRACE_SCOPE("plot loadColumnFile", "gui");
+    TmcColumnFileReader reader(filename.toStdString());
 
-            table->DeepCopy(memberTable);
-        }
+    // only the chunks of the time window are decoded
+    std::vector<int> columns;
+    for (int c = 0; c < reader.getNumberOfColumns(); ++c)
+        columns.push_back(c);
+    std::vector<std::vector<double>> values;
+    reader.read(columns, startTime, endTime, values);
+
+    d_ptr->disableUpdate = true;
+
+    vtkSmartPointer<vtkTable> newTable = vtkSmartPointer<vtkTable>::New();
+    for (int c = 0; c < (int)columns.size(); ++c)
+    {
+        vtkSmartPointer<vtkDoubleArray> column = vtkSmartPointer<vtkDoubleArray>::New();
+        column->SetName(reader.getColumnName(c).c_str());
+        column->SetNumberOfValues((vtkIdType)values[c].size());
+        for (size_t i = 0; i < values[c].size(); ++i)
+            column->SetValue((vtkIdType)i, values[c][i]);
+        newTable->AddColumn(column);
     }
+
+    this->addTable(newTable);
+}
+
+void TmcPlotWidget::updateTable()
+{
+    d_ptr->lodRange[0] = -std::numeric_limits<double>::infinity();
+    d_ptr->lodRange[1] = std::numeric_limits<double>::infinity();
+    const int pixels = this->plotWidth();
+    for (int t = 0; t < (int)d_ptr->tables.size(); ++t)
+        this->fillTable(t, d_ptr->lodRange[0], d_ptr->lodRange[1], pixels);
+
     // need the max here as the combobox returns -1 if no items are present
     int lastXAxis = std::max(0, d_ptr->comboBox->currentIndex());
 
@@ -389,6 +455,7 @@ void TmcPlotWidget::updateAndResize()
 
 void TmcPlotWidget::update()
 {
+    TMC_TRACE_SCOPE("plot update", "gui");
     if (d_ptr->disableUpdate)
     {
         return;
@@ -486,6 +553,7 @@ void TmcPlotWidget::update()
 
 void TmcPlotWidget::updateData(std::vector<std::tuple<double, double, double, double, double>> &data)
 {
+    TMC_TRACE_SCOPE("plot updateData", "gui");
     d_ptr->disableUpdate = true;
 
     vtkSmartPointer<vtkTable> newTable = vtkSmartPointer<vtkTable>::New();
@@ -514,15 +582,279 @@ void TmcPlotWidget::updateData(std::vector<std::tuple<double, double, double, do
         colJ->InsertNextValue(std::get<4>(data[i]));
     }
 
+    this->addTable(newTable);
+}
+/*===========================================================*/
+void TmcPlotWidget::beginStream()
+{
+    std::vector<std::tuple<double, double, double, double, double>> empty;
+    d_ptr->streaming = true; //< before updateData, addTable must not ask while a computation starts
+    d_ptr->streamModified = false;
+    this->updateData(empty);
+}
+/*===========================================================*/
+// the columns are looked up for every call, updateTable replaces the arrays of the tables
+void TmcPlotWidget::appendData(const std::vector<std::tuple<double, double, double, double, double>> &data)
+{
+    TMC_TRACE_SCOPE("plot appendData", "gui");
+    if (!d_ptr->streaming || d_ptr->tables.empty() || data.empty())
+        return;
+
+    vtkTable *table = d_ptr->tables.back();
+    vtkTable *memberTable = d_ptr->memberTables.back();
+    vtkDoubleArray *columns[5];
+    vtkDoubleArray *memberColumns[5];
+    for (int c = 0; c < 5; ++c)
+    {
+        columns[c] = vtkDoubleArray::SafeDownCast(table->GetColumn(c));
+        memberColumns[c] = vtkDoubleArray::SafeDownCast(memberTable->GetColumn(c));
+        if (!columns[c] || !memberColumns[c])
+            return;
+    }
+
+    // long streams are drawn reduced, the drawn table is filled again by redrawStream
+    TmcPlotLod &lod = d_ptr->lods.back();
+    const bool reduced = memberTable->GetNumberOfRows() + (vtkIdType)data.size() > d_ptr->lodThreshold;
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        const double values[5] = {std::get<0>(data[i]), std::get<1>(data[i]), std::get<2>(data[i]), std::get<3>(data[i]), std::get<4>(data[i])};
+        lod.append(values);
+        for (int c = 0; c < 5; ++c)
+        {
+            memberColumns[c]->InsertNextValue(values[c]);
+            if (!reduced)
+                columns[c]->InsertNextValue(d_ptr->isLogScale && values[c] < 1e-17 ? nan("") : values[c]);
+        }
+    }
+    if (reduced)
+        d_ptr->lodModified = true;
+    for (int c = 0; c < 5; ++c)
+    {
+        columns[c]->Modified();
+        memberColumns[c]->Modified();
+    }
+    table->Modified();
+    memberTable->Modified();
+
+    d_ptr->streamModified = true;
+    if (!d_ptr->streamTimer->isActive())
+        d_ptr->streamTimer->start();
+}
+/*===========================================================*/
+void TmcPlotWidget::endStream()
+{
+    if (!d_ptr->streaming)
+        return;
+    d_ptr->streamTimer->stop();
+    d_ptr->streaming = false;
+    d_ptr->streamModified = false;
+    this->on_pushButtonResize_clicked();
+    this->refresh();
+}
+/*===========================================================*/
+bool TmcPlotWidget::isStreaming() const
+{
+    return d_ptr->streaming;
+}
+/*===========================================================*/
+void TmcPlotWidget::setMaximumFrameRate(int framesPerSecond)
+{
+    d_ptr->maximumFrameRate = std::max(1, framesPerSecond);
+    d_ptr->streamTimer->setInterval(1000 / d_ptr->maximumFrameRate);
+}
+/*===========================================================*/
+// only the appended rows are new, the plots are kept and only the bounds follow the data
+void TmcPlotWidget::redrawStream()
+{
+    TMC_TRACE_SCOPE("plot redrawStream", "gui");
+    if (!d_ptr->streamModified)
+        return;
+    d_ptr->streamModified = false;
+
+    if (d_ptr->lodModified)
+    {
+        d_ptr->lodModified = false;
+        if (!d_ptr->keepZoom)
+        {
+            d_ptr->lodRange[0] = -std::numeric_limits<double>::infinity();
+            d_ptr->lodRange[1] = std::numeric_limits<double>::infinity();
+        }
+        const int pixels = std::isinf(d_ptr->lodRange[1] - d_ptr->lodRange[0]) ? this->plotWidth() : 2 * this->plotWidth();
+        this->fillTable((int)d_ptr->tables.size() - 1, d_ptr->lodRange[0], d_ptr->lodRange[1], pixels);
+    }
+    if (!d_ptr->keepZoom)
+        d_ptr->chart->RecalculateBounds();
+    d_ptr->chart->Modified();
+    this->refresh();
+}
+/*===========================================================*/
+void TmcPlotWidget::setLevelOfDetailThreshold(int rows)
+{
+    d_ptr->lodThreshold = std::max(1, rows);
+    this->updateTable();
+    this->refresh();
+}
+/*===========================================================*/
+void TmcPlotWidget::buildLevelOfDetail(int t)
+{
+    TMC_TRACE_SCOPE("plot buildLevelOfDetail", "gui");
+    vtkTable *memberTable = d_ptr->memberTables[t];
+    const int nc = memberTable->GetNumberOfColumns();
+    const vtkIdType nr = memberTable->GetNumberOfRows();
+    TmcPlotLod &lod = d_ptr->lods[t];
+    lod.reset(nc);
+    if (nc == 0)
+        return;
+
+    std::vector<vtkDataArray *> columns;
+    for (int c = 0; c < nc; ++c)
+        columns.push_back(vtkDataArray::SafeDownCast(memberTable->GetColumn(c)));
+    std::vector<double> row(nc);
+    for (vtkIdType r = 0; r < nr; ++r)
+    {
+        for (int c = 0; c < nc; ++c)
+            row[c] = columns[c] ? columns[c]->GetTuple1(r) : memberTable->GetValue(r, c).ToDouble();
+        lod.append(&row[0]);
+    }
+}
+/*===========================================================*/
+bool TmcPlotWidget::isReduced(int t) const
+{
+    const vtkIdType nr = d_ptr->memberTables[t]->GetNumberOfRows();
+    return nr > d_ptr->lodThreshold && (vtkIdType)d_ptr->lods[t].size() == nr;
+}
+/*===========================================================*/
+int TmcPlotWidget::plotWidth() const
+{
+    const int *size = d_ptr->view->GetRenderWindow()->GetSize();
+    return std::max(100, size[0]);
+}
+/*===========================================================*/
+// the drawn table t is a copy of the member table or, for long tables, the rows of [xMin, xMax] needed for pixels
+void TmcPlotWidget::fillTable(int t, double xMin, double xMax, int pixels)
+{
+    TMC_TRACE_SCOPE("plot fillTable", "gui");
+    vtkTable *table = d_ptr->tables[t];
+    vtkTable *memberTable = d_ptr->memberTables[t];
+
+    if (!this->isReduced(t))
+    {
+        table->DeepCopy(memberTable);
+    }
+    else
+    {
+        const TmcPlotLod &lod = d_ptr->lods[t];
+        std::size_t first = 0;
+        std::size_t last = lod.size();
+        vtkDoubleArray *x = vtkDoubleArray::SafeDownCast(memberTable->GetColumn(0));
+        if (x && lod.isAscending())
+            TmcPlotLod::findRange(x->GetPointer(0), lod.size(), xMin, xMax, first, last);
+        std::vector<std::size_t> indices;
+        lod.select(first, last, pixels, indices);
+
+        const int nc = memberTable->GetNumberOfColumns();
+        for (int c = 0; c < nc; ++c)
+        {
+            vtkDataArray *source = vtkDataArray::SafeDownCast(memberTable->GetColumn(c));
+            vtkDataArray *target = vtkDataArray::SafeDownCast(table->GetColumn(c));
+            if (!source || !target)
+                continue;
+            target->SetNumberOfTuples((vtkIdType)indices.size());
+            for (size_t i = 0; i < indices.size(); ++i)
+                target->SetTuple1((vtkIdType)i, source->GetTuple1((vtkIdType)indices[i]));
+            target->Modified();
+        }
+        table->Modified();
+    }
+
+    if (d_ptr->isLogScale)
+    {
+        const vtkIdType nr = table->GetNumberOfRows();
+        const vtkIdType nc = table->GetNumberOfColumns();
+        for (vtkIdType r = 0; r < nr; ++r)
+        {
+            for (vtkIdType c = 0; c < nc; ++c)
+            {
+                double val = table->GetValue(r, c).ToDouble();
+                if (val < 1e-17)
+                {
+                    table->SetValue(r, c, nan(""));
+                }
+            }
+        }
+    }
+}
+/*===========================================================*/
+// called by vtk while zooming and panning, the refinement is delayed until the interaction pauses
+void TmcPlotWidget::axisRangeChanged(vtkObject *, unsigned long, void *)
+{
+    if (!d_ptr->lodTimer->isActive())
+        d_ptr->lodTimer->start();
+}
+/*===========================================================*/
+// the reduced tables are filled for the visible range plus half its width on both sides, they are
+// filled again if the view leaves this range or is zoomed in more than twice
+void TmcPlotWidget::refineLevelOfDetail()
+{
+    TMC_TRACE_SCOPE("plot refineLevelOfDetail", "gui");
+    double range[2];
+    d_ptr->chart->GetAxis(1)->GetRange(range);
+    const double width = range[1] - range[0];
+    if (!(width > 0.0))
+        return;
+
+    double filledWidth = 0.5 * (d_ptr->lodRange[1] - d_ptr->lodRange[0]);
+    bool reduced = false;
+    double extent = 0.0;
+    for (int t = 0; t < (int)d_ptr->tables.size(); ++t)
+    {
+        if (!this->isReduced(t))
+            continue;
+        reduced = true;
+        vtkDataArray *x = vtkDataArray::SafeDownCast(d_ptr->memberTables[t]->GetColumn(0));
+        if (x)
+            extent = std::max(extent, x->GetTuple1(x->GetNumberOfTuples() - 1) - x->GetTuple1(0));
+    }
+    if (!reduced)
+        return;
+    if (std::isinf(filledWidth))
+        filledWidth = extent;
+
+    const bool covered = range[0] >= d_ptr->lodRange[0] && range[1] <= d_ptr->lodRange[1];
+    if (covered && width > 0.5 * filledWidth)
+        return;
+
+    d_ptr->lodRange[0] = range[0] - 0.5 * width;
+    d_ptr->lodRange[1] = range[1] + 0.5 * width;
+    const int pixels = 2 * this->plotWidth();
+    for (int t = 0; t < (int)d_ptr->tables.size(); ++t)
+        if (this->isReduced(t))
+            this->fillTable(t, d_ptr->lodRange[0], d_ptr->lodRange[1], pixels);
+    d_ptr->chart->Modified();
+    this->refresh();
+}
+/*===========================================================*/
+// asks for cleaning the plot or a prefix of the column names, if there is already data
+// (a stream gets a numbered prefix without asking)
+void TmcPlotWidget::addTable(vtkTable *table)
+{
+    vtkSmartPointer<vtkTable> newTable = table;
     QString prefix;
 
-    if (d_ptr->tables.size() > 0)
+    if (d_ptr->tables.size() > 0 && d_ptr->streaming)
+    {
+        // no dialog for a stream, the previous results are kept
+        prefix = QString("Case %1").arg(d_ptr->tables.size() + 1);
+    }
+    else if (d_ptr->tables.size() > 0)
     {
         QMessageBox::StandardButton reply;
         reply = QMessageBox::question(this, "Clean Plot", "Do you want to clean the plot before adding data?", QMessageBox::Yes | QMessageBox::No);
         if (reply == QMessageBox::Yes)
         {
             d_ptr->tables.clear();
+            d_ptr->memberTables.clear();
+            d_ptr->lods.clear();
         }
         else
         {
@@ -556,6 +888,8 @@ void TmcPlotWidget::updateData(std::vector<std::tuple<double, double, double, do
     newTable2->DeepCopy(newTable);
     d_ptr->tables.push_back(newTable);
     d_ptr->memberTables.push_back(newTable2);
+    d_ptr->lods.push_back(TmcPlotLod());
+    this->buildLevelOfDetail((int)d_ptr->lods.size() - 1);
 
     this->updateTable();
 
@@ -41,6 +41,7 @@
 #ifndef TmcPlotWidget_H
 #define TmcPlotWidget_H
 
+#include <limits>
 #include <vector>
 #include <tuple>
 
@@ -52,6 +53,7 @@
 #include <vtkAutoInit.h>
 VTK_MODULE_INIT(vtkRenderingContextOpenGL2)
 
+class vtkObject;
 class vtkTable;
 struct TmcPlotWidgetPrivate;
 
@@ -64,9 +66,24 @@ public:
     virtual ~TmcPlotWidget();
 
     void updateData(std::vector<std::tuple<double, double, double, double, double>>& data);
+
+    // live plot of a running computation: beginStream adds an empty table, appendData adds rows to it
+    // and the plot is redrawn at most maximumFrameRate times per second, endStream resizes the plot
+    void beginStream();
+    void appendData(const std::vector<std::tuple<double, double, double, double, double>> &data);
+    void endStream();
+    bool isStreaming() const;
+    void setMaximumFrameRate(int framesPerSecond);
+
+    // tables with more rows are drawn reduced (TmcPlotLod): only the extremes per pixel of the visible
+    // x range, the rows are refined when zooming
+    void setLevelOfDetailThreshold(int rows);
     void addPluginWidget(QWidget* widget);
 
     void writeCsv(const QString &filename);
+    // time histories in the compressed column format (TmcColumnFile), column 0 is the x-axis
+    void loadColumnFile(const QString &filename, double startTime = -std::numeric_limits<double>::infinity(), double endTime = std::numeric_limits<double>::infinity());
+    void writeColumnFile(const QString &filename);
     void refresh();
 
 public slots:
@@ -84,9 +101,19 @@ protected slots:
 
     void updateTable();
 
+    void redrawStream();
+    void refineLevelOfDetail();
+
 private:
     Q_DISABLE_COPY(TmcPlotWidget)
 
+    void addTable(vtkTable *newTable);
+    void buildLevelOfDetail(int t);
+    void fillTable(int t, double xMin, double xMax, int pixels);
+    bool isReduced(int t) const;
+    int plotWidth() const;
+    void axisRangeChanged(vtkObject *caller, unsigned long event, void *data);
+
     QScopedPointer<TmcPlotWidgetPrivate> d_ptr;
 
 };